@@ -0,0 +1,338 @@
+﻿#pragma once
+
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <atomic>
+#include <memory>
+
+#include "optional.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif // defined(_MSC_VER)
+
+namespace lstl {
+
+	namespace detail {
+
+		/**
+		* @brief 16バイトのワード
+		*/
+		struct alignas(16) atomic_word128 {
+			std::uint64_t lo;
+			std::uint64_t hi;
+		};
+
+		/**
+		* @brief nバイトを格納できる最小のワード型
+		*/
+		template<std::size_t N>
+		using atomic_word_t = std::conditional_t<N <= 1, std::uint8_t,
+			std::conditional_t<N <= 2, std::uint16_t,
+			std::conditional_t<N <= 4, std::uint32_t,
+			std::conditional_t<N <= 8, std::uint64_t,
+			atomic_word128>>>>;
+
+		/**
+		* @brief compare_exchangeの失敗時のメモリオーダーを成功時のものから求める
+		*/
+		constexpr std::memory_order failure_order(std::memory_order order) noexcept {
+			return (order == std::memory_order_acq_rel) ? std::memory_order_acquire
+				: (order == std::memory_order_release) ? std::memory_order_relaxed
+				: order;
+		}
+
+		/**
+		* @brief ワードに対するアトミック操作
+		* @detail 8バイト以下のワードはstd::atomicを用いる
+		* @detail std::atomic<atomic_word128>はロックを用いる上、GCCでは-latomicを要するので用いない
+		*/
+		template<typename Word>
+		class atomic_cell {
+			std::atomic<Word> m_word;
+
+		public:
+
+			static constexpr bool is_always_lock_free = std::atomic<Word>::is_always_lock_free;
+
+			explicit atomic_cell(Word w) noexcept : m_word{ w } {}
+
+			Word load(std::memory_order order) const noexcept {
+				return m_word.load(order);
+			}
+
+			void store(Word w, std::memory_order order) noexcept {
+				m_word.store(w, order);
+			}
+
+			Word exchange(Word w, std::memory_order order) noexcept {
+				return m_word.exchange(w, order);
+			}
+
+			bool compare_exchange_weak(Word& expected, Word desired, std::memory_order success, std::memory_order failure) noexcept {
+				return m_word.compare_exchange_weak(expected, desired, success, failure);
+			}
+
+			bool compare_exchange_strong(Word& expected, Word desired, std::memory_order success, std::memory_order failure) noexcept {
+				return m_word.compare_exchange_strong(expected, desired, success, failure);
+			}
+
+			bool is_lock_free() const noexcept {
+				return m_word.is_lock_free();
+			}
+		};
+
+#if LSTL_HAS_ATOMIC_CAS128
+
+		/**
+		* @brief 16バイトのワードに対するアトミック操作
+		* @detail std::atomicは処理系によってロックを用いるため、cmpxchg16bを直接使用する
+		* @detail 全ての操作はCASによって行われ、メモリオーダーは常にseq_cstとなる
+		* @detail loadもCAS（ロック付きの書き込み）なので、読み出すスレッドもキャッシュラインを排他的に取得する
+		*/
+		template<>
+		class atomic_cell<atomic_word128> {
+			mutable atomic_word128 m_word;
+
+			/**
+			* @brief 16バイトのCAS、失敗時はexpectedに現在の値が書き込まれる
+			*/
+			bool cas(atomic_word128& expected, atomic_word128 desired) const noexcept {
+#if defined(_MSC_VER)
+				return _InterlockedCompareExchange128(reinterpret_cast<volatile long long*>(&m_word), static_cast<long long>(desired.hi), static_cast<long long>(desired.lo), reinterpret_cast<long long*>(&expected)) != 0;
+#else
+				unsigned __int128 e, d;
+				std::memcpy(&e, &expected, sizeof(e));
+				std::memcpy(&d, &desired, sizeof(d));
+
+				const unsigned __int128 prev = __sync_val_compare_and_swap(reinterpret_cast<unsigned __int128*>(&m_word), e, d);
+
+				std::memcpy(&expected, &prev, sizeof(prev));
+				return prev == e;
+#endif
+			}
+
+		public:
+
+			static constexpr bool is_always_lock_free = true;
+
+			explicit atomic_cell(atomic_word128 w) noexcept : m_word(w) {}
+
+			atomic_word128 load(std::memory_order) const noexcept {
+				//同じ値での置き換えを試みることで現在の値を読む（値は変わらないが、書き込みとして扱われる）
+				atomic_word128 current{ 0, 0 };
+				cas(current, current);
+				return current;
+			}
+
+			void store(atomic_word128 w, std::memory_order order) noexcept {
+				exchange(w, order);
+			}
+
+			atomic_word128 exchange(atomic_word128 w, std::memory_order) noexcept {
+				//無効値（全て0）を予想して始める、外れれば1回目のCASで現在の値が得られる
+				atomic_word128 current{ 0, 0 };
+				while (!cas(current, w)) {}
+				return current;
+			}
+
+			bool compare_exchange_weak(atomic_word128& expected, atomic_word128 desired, std::memory_order, std::memory_order) noexcept {
+				return cas(expected, desired);
+			}
+
+			bool compare_exchange_strong(atomic_word128& expected, atomic_word128 desired, std::memory_order, std::memory_order) noexcept {
+				return cas(expected, desired);
+			}
+
+			bool is_lock_free() const noexcept {
+				return true;
+			}
+		};
+
+#endif // LSTL_HAS_ATOMIC_CAS128
+
+		/**
+		* @brief optional<T>とワードの相互変換、有効値フラグを用いる
+		* @detail optional_storageと同じく、値の直後に有効値フラグを置く
+		* @detail 無効値は全てのビットが0のワードで表す（比較のため、表現を一意にする）
+		*/
+		template<typename T, bool = optional_traits::has_invalid_value<T>::value>
+		struct atomic_optional_layout {
+			using word_type = atomic_word_t<sizeof(T) + 1>;
+
+			static word_type pack(const optional<T>& v) noexcept {
+				word_type w{};
+				if (v.has_value()) {
+					unsigned char* bytes = reinterpret_cast<unsigned char*>(&w);
+					std::memcpy(bytes, std::addressof(*v), sizeof(T));
+					bytes[sizeof(T)] = 1;
+				}
+				return w;
+			}
+
+			static optional<T> unpack(const word_type& w) noexcept {
+				const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&w);
+				if (bytes[sizeof(T)] == 0) {
+					return nullopt;
+				}
+
+				alignas(T) unsigned char value[sizeof(T)];
+				std::memcpy(value, bytes, sizeof(T));
+				return *reinterpret_cast<const T*>(value);
+			}
+		};
+
+		/**
+		* @brief optional<T>とワードの相互変換、無効値を用いる
+		* @detail Tの値をそのまま格納し、無効値で無効状態を表す
+		*/
+		template<typename T>
+		struct atomic_optional_layout<T, true> {
+			using word_type = atomic_word_t<sizeof(T)>;
+
+			static word_type pack(const optional<T>& v) noexcept {
+				const T value = v.has_value() ? *v : invalid_value_traits<T>::invalid_value();
+
+				word_type w{};
+				std::memcpy(&w, std::addressof(value), sizeof(T));
+				return w;
+			}
+
+			static optional<T> unpack(const word_type& w) noexcept {
+				alignas(T) unsigned char value[sizeof(T)];
+				std::memcpy(value, &w, sizeof(T));
+
+				const T& v = *reinterpret_cast<const T*>(value);
+				return invalid_value_traits<T>::is_invalid(v) ? optional<T>{} : optional<T>{ v };
+			}
+		};
+	}
+
+	/**
+	* @brief optional<T>を1ワードに詰めて保持するアトミック変数
+	* @detail invalid_value_traitsが特殊化されていればsizeof(T)、そうでなければsizeof(T) + 1バイトのワードを用いる
+	* @detail ワードが8バイト以下であればstd::atomic、16バイトであればcmpxchg16bによってロックフリーとなる
+	* @detail 16バイトのワードはcmpxchg16bが使用可能な場合のみ用いることができる（GCC、Clangでは-mcx16が必要）
+	* @detail 16バイトのワードではloadもCASとなるため、読み出し同士も競合する（読み出しが多い場合はseqlock_optionalを検討すること）
+	* @detail compare_exchangeはバイト表現で比較するので、Tはパディングを持たないこと（float、double以外はstd::has_unique_object_representationsで検査する）
+	* @tparam T 格納する要素型、trivially copyableであること
+	*/
+	template<typename T>
+	class atomic_optional {
+		static_assert(std::is_trivially_copyable<T>::value, "T shall be trivially copyable.");
+		static_assert(!std::is_const<T>::value && !std::is_volatile<T>::value, "T shall not be cv-qualified.");
+		static_assert(std::disjunction<std::has_unique_object_representations<T>, std::is_same<T, float>, std::is_same<T, double>>::value, "T shall not have padding bits, since compare_exchange compares object representations.");
+
+		using layout = detail::atomic_optional_layout<T>;
+		using word_type = typename layout::word_type;
+
+		static_assert(sizeof(word_type) <= 16, "T is too large for atomic_optional.");
+		static_assert(sizeof(word_type) <= 8 || LSTL_HAS_ATOMIC_CAS128, "atomic_optional<T> needs a 16-byte word, which requires cmpxchg16b (compile with -mcx16 on GCC/Clang).");
+
+		detail::atomic_cell<word_type> m_cell;
+
+	public:
+
+		using value_type = T;
+
+		/**
+		* @brief 常にロックフリーであるか
+		*/
+		static constexpr bool is_always_lock_free = detail::atomic_cell<word_type>::is_always_lock_free;
+
+		/**
+		* @brief 無効値で初期化
+		*/
+		atomic_optional() noexcept : m_cell{ layout::pack(nullopt) }
+		{}
+
+		/**
+		* @brief optional<T>の値で初期化
+		*/
+		atomic_optional(const optional<T>& v) noexcept : m_cell{ layout::pack(v) }
+		{}
+
+		/**
+		* @brief Tの値で初期化
+		*/
+		atomic_optional(const T& v) noexcept : m_cell{ layout::pack(v) }
+		{}
+
+		atomic_optional(const atomic_optional&) = delete;
+		atomic_optional& operator=(const atomic_optional&) = delete;
+
+		/**
+		* @brief 値を読み出す
+		*/
+		optional<T> load(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+			return layout::unpack(m_cell.load(order));
+		}
+
+		/**
+		* @brief 値を書き込む、nulloptを渡せば無効値にする
+		*/
+		void store(const optional<T>& v, std::memory_order order = std::memory_order_seq_cst) noexcept {
+			m_cell.store(layout::pack(v), order);
+		}
+
+		/**
+		* @brief 値を書き込み、以前の値を返す
+		*/
+		optional<T> exchange(const optional<T>& v, std::memory_order order = std::memory_order_seq_cst) noexcept {
+			return layout::unpack(m_cell.exchange(layout::pack(v), order));
+		}
+
+		/**
+		* @brief 値を取り出し、無効値にする
+		* @return 以前の値、無効値であった場合はnullopt
+		*/
+		optional<T> take(std::memory_order order = std::memory_order_seq_cst) noexcept {
+			return exchange(nullopt, order);
+		}
+
+		/**
+		* @brief 現在の値がexpectedと等しければdesiredを書き込む
+		* @detail 有効値同士はバイト表現で比較する、無効値同士は常に等しい
+		* @detail 失敗した場合、expectedに現在の値が書き込まれる
+		* @return 書き込んだならtrue
+		*/
+		bool compare_exchange_strong(optional<T>& expected, const optional<T>& desired, std::memory_order success, std::memory_order failure) noexcept {
+			word_type e = layout::pack(expected);
+			if (m_cell.compare_exchange_strong(e, layout::pack(desired), success, failure)) {
+				return true;
+			}
+			expected = layout::unpack(e);
+			return false;
+		}
+
+		bool compare_exchange_strong(optional<T>& expected, const optional<T>& desired, std::memory_order order = std::memory_order_seq_cst) noexcept {
+			return compare_exchange_strong(expected, desired, order, detail::failure_order(order));
+		}
+
+		/**
+		* @brief 現在の値がexpectedと等しければdesiredを書き込む、等しくても失敗する場合がある
+		* @detail ループ内で用いる
+		*/
+		bool compare_exchange_weak(optional<T>& expected, const optional<T>& desired, std::memory_order success, std::memory_order failure) noexcept {
+			word_type e = layout::pack(expected);
+			if (m_cell.compare_exchange_weak(e, layout::pack(desired), success, failure)) {
+				return true;
+			}
+			expected = layout::unpack(e);
+			return false;
+		}
+
+		bool compare_exchange_weak(optional<T>& expected, const optional<T>& desired, std::memory_order order = std::memory_order_seq_cst) noexcept {
+			return compare_exchange_weak(expected, desired, order, detail::failure_order(order));
+		}
+
+		/**
+		* @brief ロックフリーであるかを調べる
+		*/
+		bool is_lock_free() const noexcept {
+			return m_cell.is_lock_free();
+		}
+	};
+}
\ No newline at end of file
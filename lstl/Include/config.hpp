@@ -0,0 +1,198 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif // defined(_MSC_VER)
+
+/**
+* @brief 例外の有無の設定
+* @detail LSTL_NO_EXCEPTIONSを定義するか、例外が無効な設定（-fno-exceptions、/EHs-等）でコンパイルすると、lstlは例外を一切用いない
+* @detail その場合、value()等の不正なアクセスは例外を投げる代わりにbad_access_handlerを呼び出し、戻ってきたらトラップする
+* @detail LSTL_BAD_ACCESS_TRAPを定義すると、例外の有無によらず不正なアクセスで直ちにトラップする
+*/
+#if !defined(LSTL_NO_EXCEPTIONS) && !defined(__cpp_exceptions) && !defined(__EXCEPTIONS) && !defined(_CPPUNWIND)
+#define LSTL_NO_EXCEPTIONS
+#endif
+
+#if defined(LSTL_NO_EXCEPTIONS)
+#define LSTL_HAS_EXCEPTIONS 0
+#define LSTL_TRY if (true)
+#define LSTL_CATCH_ALL else
+#define LSTL_RETHROW ((void)0)
+#else
+#define LSTL_HAS_EXCEPTIONS 1
+#define LSTL_TRY try
+#define LSTL_CATCH_ALL catch (...)
+#define LSTL_RETHROW throw
+#endif // defined(LSTL_NO_EXCEPTIONS)
+
+/**
+* @brief 事前条件の検査（デバッグビルドのみ）
+* @detail 利用者が事前に定義して置き換えることができる
+*/
+#if !defined(LSTL_ASSERT)
+#define LSTL_ASSERT(expr) assert(expr)
+#endif
+
+/**
+* @brief 即座にプロセスを停止する
+*/
+#if !defined(LSTL_TRAP)
+#if defined(_MSC_VER)
+#define LSTL_TRAP() __fastfail(7)
+#elif defined(__GNUC__)
+#define LSTL_TRAP() __builtin_trap()
+#else
+#define LSTL_TRAP() std::abort()
+#endif
+#endif // !defined(LSTL_TRAP)
+
+/**
+* @brief 滅多に実行されない関数をインライン展開させない
+*/
+#if defined(_MSC_VER)
+#define LSTL_NOINLINE_COLD __declspec(noinline)
+#elif defined(__GNUC__)
+#define LSTL_NOINLINE_COLD __attribute__((noinline, cold))
+#else
+#define LSTL_NOINLINE_COLD
+#endif
+
+/**
+* @brief C++20の定数式中での動的なオブジェクト生存期間の操作（std::construct_at、constexprデストラクタ）が使えるときのみconstexprとする
+* @detail 非トリビアルな型を保持するoptional等の、構築・破棄を伴う操作に付加する
+*/
+#if defined(__cpp_constexpr_dynamic_alloc) && defined(__cpp_lib_constexpr_dynamic_alloc)
+#define LSTL_CONSTEXPR20 constexpr
+#define LSTL_HAS_CONSTEXPR20 1
+#else
+#define LSTL_CONSTEXPR20
+#define LSTL_HAS_CONSTEXPR20 0
+#endif
+
+/**
+* @brief 制約によって特殊メンバ関数を選択でき、そのtrivial性が保たれるか（C++20、P0848）
+*/
+#if defined(__cpp_concepts) && 202002L <= __cpp_concepts
+#define LSTL_HAS_CONCEPTS 1
+#else
+#define LSTL_HAS_CONCEPTS 0
+#endif
+
+/**
+* @brief 三方比較演算子（<=>）と<compare>が使えるか（C++20）
+*/
+#if LSTL_HAS_CONCEPTS && defined(__cpp_impl_three_way_comparison) && 201907L <= __cpp_impl_three_way_comparison
+#include <compare>
+#endif
+
+#if LSTL_HAS_CONCEPTS && defined(__cpp_lib_three_way_comparison) && 201907L <= __cpp_lib_three_way_comparison
+#define LSTL_HAS_THREE_WAY_COMPARISON 1
+#else
+#define LSTL_HAS_THREE_WAY_COMPARISON 0
+#endif
+
+/**
+* @brief 16バイトのCAS命令（cmpxchg16b）が使用可能か
+* @detail GCC、Clangでは-mcx16（もしくはcmpxchg16bを含む-march）の指定が必要
+*/
+#if defined(_MSC_VER) && defined(_M_X64)
+#define LSTL_HAS_ATOMIC_CAS128 1
+#elif defined(__GNUC__) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+#define LSTL_HAS_ATOMIC_CAS128 1
+#else
+#define LSTL_HAS_ATOMIC_CAS128 0
+#endif
+
+namespace lstl {
+
+	/**
+	* @brief 例外を用いない場合に不正なアクセスを報告する関数の型
+	* @detail 戻ってはならない（戻ってきた場合はトラップする）
+	* @param what 投げられるはずだった例外のwhat()
+	*/
+	using bad_access_handler = void(*)(const char* what);
+
+	namespace detail {
+
+		inline std::atomic<bad_access_handler>& bad_access_handler_storage() noexcept {
+			static std::atomic<bad_access_handler> handler{ nullptr };
+			return handler;
+		}
+	}
+
+	/**
+	* @brief 不正なアクセスを報告する関数を設定する
+	* @detail 例外を用いない設定でのみ呼ばれる、LSTL_BAD_ACCESS_TRAPが定義されている場合は呼ばれない
+	* @param handler 新しい関数、nullptrならば直ちにトラップする
+	* @return 以前の関数
+	*/
+	inline bad_access_handler set_bad_access_handler(bad_access_handler handler) noexcept {
+		return detail::bad_access_handler_storage().exchange(handler);
+	}
+
+	/**
+	* @brief 不正なアクセスを報告する関数を取得する
+	*/
+	inline bad_access_handler get_bad_access_handler() noexcept {
+		return detail::bad_access_handler_storage().load();
+	}
+
+	namespace detail {
+
+		/**
+		* @brief 不正なアクセスを報告して停止する
+		*/
+		[[noreturn]] inline void handle_bad_access(const char* what) noexcept {
+			if (const auto handler = get_bad_access_handler()) {
+				handler(what);
+			}
+			LSTL_TRAP();
+		}
+
+#if defined(LSTL_BAD_ACCESS_TRAP)
+
+		/**
+		* @brief 不正なアクセスで直ちにトラップする
+		* @detail 呼び出し側にはトラップ命令だけが展開される
+		*/
+		template<typename Exception, typename... Args>
+		[[noreturn]] inline void raise_bad_access(Args&&...) noexcept {
+			LSTL_TRAP();
+		}
+
+#elif LSTL_HAS_EXCEPTIONS
+
+		/**
+		* @brief 不正なアクセスの例外を投げる
+		* @detail 呼び出し側に例外送出のコードが展開されないよう、インライン展開させない
+		* @tparam Exception 投げる例外の型
+		* @param args 例外のコンストラクタ引数
+		*/
+		template<typename Exception, typename... Args>
+		[[noreturn]] LSTL_NOINLINE_COLD void raise_bad_access(Args&&... args) {
+			throw Exception(std::forward<Args>(args)...);
+		}
+
+#else
+
+		/**
+		* @brief 不正なアクセスをbad_access_handlerに報告して停止する
+		* @detail 例外を用いない設定のため、例外オブジェクトはwhat()を得るためだけに構築する
+		* @tparam Exception 投げられるはずだった例外の型
+		* @param args 例外のコンストラクタ引数
+		*/
+		template<typename Exception, typename... Args>
+		[[noreturn]] LSTL_NOINLINE_COLD void raise_bad_access(Args&&... args) noexcept {
+			handle_bad_access(Exception(std::forward<Args>(args)...).what());
+		}
+
+#endif // defined(LSTL_BAD_ACCESS_TRAP)
+	}
+}
\ No newline at end of file
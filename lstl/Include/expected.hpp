@@ -0,0 +1,1325 @@
+﻿#pragma once
+
+#include <type_traits>
+#include <exception>
+#include <utility>
+#include <memory>
+#include <functional>
+#include <initializer_list>
+
+#include "config.hpp"
+#include "optional.hpp"
+
+#pragma warning(push)
+//ユニコードの文字がShift-JISで分からないという警告抑止
+#pragma warning(disable:4566)
+
+namespace lstl {
+
+	template<typename T, typename E>
+	class expected;
+
+	template<typename E>
+	class unexpected;
+
+	/**
+	* @brief エラー値を直接構築するためのタグ
+	*/
+	struct unexpect_t {
+		explicit unexpect_t() = default;
+	};
+
+	constexpr unexpect_t unexpect{};
+
+
+	template<typename E>
+	class bad_expected_access;
+
+	template<>
+	class bad_expected_access<void> : public std::exception {
+	protected:
+
+		bad_expected_access() = default;
+
+	public:
+
+		const char* what() const noexcept override {
+			return "Bad expected access";
+		}
+	};
+
+	/**
+	* @brief エラー値を保持するexpectedから値を取り出そうとした時に投げられる例外
+	* @tparam E エラー型
+	*/
+	template<typename E>
+	class bad_expected_access : public bad_expected_access<void> {
+		E m_error;
+
+	public:
+
+		explicit bad_expected_access(E e) : m_error(std::move(e))
+		{}
+
+		E& error() & noexcept {
+			return m_error;
+		}
+
+		E&& error() && noexcept {
+			return std::move(m_error);
+		}
+
+		const E& error() const & noexcept {
+			return m_error;
+		}
+
+		const E&& error() const && noexcept {
+			return std::move(m_error);
+		}
+	};
+
+	/**
+	* @brief expectedへエラー値を渡すためのラッパ
+	* @tparam E エラー型、オブジェクト型であり配列でないこと
+	*/
+	template<typename E>
+	class unexpected {
+
+		static_assert(std::conjunction<std::is_object<E>, std::negation<std::is_array<E>>, std::negation<std::is_const<E>>>::value, "E shall be a non-const, non-array object type.");
+
+		E m_error;
+
+	public:
+
+		unexpected(const unexpected&) = default;
+		unexpected(unexpected&&) = default;
+
+		/**
+		* @brief エラー値を受けて構築
+		* @param e Eを構築可能な値
+		*/
+		template<typename Err = E, optional_traits::enabler<std::negation<std::is_same<std::decay_t<Err>, unexpected>>, std::negation<std::is_same<std::decay_t<Err>, in_place_t>>, std::is_constructible<E, Err&&>> = nullptr>
+		constexpr explicit unexpected(Err&& e) : m_error(std::forward<Err>(e))
+		{}
+
+		/**
+		* @brief Eのコンストラクタ引数を受けて直接構築
+		* @param args Eに与える引数
+		*/
+		template<typename... Args, optional_traits::enabler<std::is_constructible<E, Args&&...>> = nullptr>
+		constexpr explicit unexpected(in_place_t, Args&&... args) : m_error(std::forward<Args>(args)...)
+		{}
+
+		E& error() & noexcept {
+			return m_error;
+		}
+
+		E&& error() && noexcept {
+			return std::move(m_error);
+		}
+
+		constexpr const E& error() const & noexcept {
+			return m_error;
+		}
+
+		constexpr const E&& error() const && noexcept {
+			return std::move(m_error);
+		}
+	};
+
+	/**
+	* @brief unexpectedを作成する
+	* @param e エラー値
+	* @return unexpected<decay_t<E>>
+	*/
+	template<typename E>
+	constexpr auto make_unexpected(E&& e) -> unexpected<std::decay_t<E>> {
+		return unexpected<std::decay_t<E>>{ std::forward<E>(e) };
+	}
+
+	template<typename E, typename G>
+	constexpr bool operator==(const unexpected<E>& lhs, const unexpected<G>& rhs) {
+		return lhs.error() == rhs.error();
+	}
+
+	template<typename E, typename G>
+	constexpr bool operator!=(const unexpected<E>& lhs, const unexpected<G>& rhs) {
+		return !(lhs == rhs);
+	}
+
+	/**
+	* @brief Tがexpectedの特殊化であるかを調べる
+	*/
+	template<typename T>
+	struct is_expected : std::false_type {};
+
+	template<typename T, typename E>
+	struct is_expected<expected<T, E>> : std::true_type {};
+
+	/**
+	* @brief Tがunexpectedの特殊化であるかを調べる
+	*/
+	template<typename T>
+	struct is_unexpected : std::false_type {};
+
+	template<typename E>
+	struct is_unexpected<unexpected<E>> : std::true_type {};
+
+	namespace detail {
+
+		/**
+		* @brief expectedの保持する値の種類
+		* @detail valuelessはコピー・ムーブ構築中に例外が投げられた場合の一時的な状態であり、完全に構築されたexpectedからは観測されない
+		*/
+		enum class expected_state : unsigned char {
+			valueless,
+			value,
+			error
+		};
+
+		/**
+		* @brief expected<T, E>の特殊メンバ関数の性質を表す型
+		* @detail 特殊メンバ関数の性質（trivialか、noexceptか、deleteされているか）はTとE双方の性質の論理積となる
+		* @detail optionalと共通のenable_special_menber_functionsにTの代わりに渡す
+		*/
+		template<typename T, typename E>
+		struct expected_members {
+			T m_value;
+			E m_error;
+		};
+
+		/**
+		* @brief expected<T, E>のためのストレージ領域
+		* @detail T、Eのどちらかがtrivially destructibleでない場合のための処理を提供
+		*/
+		template<typename T, typename E, bool = std::conjunction<std::is_trivially_destructible<T>, std::is_trivially_destructible<E>>::value>
+		struct expected_storage {
+			using value_hold_type = std::remove_const_t<T>;
+			using error_hold_type = std::remove_const_t<E>;
+
+			union {
+				unsigned char m_dummy;
+				value_hold_type m_value;
+				error_hold_type m_error;
+			};
+
+			expected_state m_state;
+
+			constexpr expected_storage(nullopt_t) noexcept
+				: m_dummy{}
+				, m_state{ expected_state::valueless }
+			{}
+
+			template<typename... Args>
+			constexpr expected_storage(in_place_t, Args&&... args) noexcept(std::is_nothrow_constructible<value_hold_type, Args&&...>::value)
+				: m_value(std::forward<Args>(args)...)
+				, m_state{ expected_state::value }
+			{}
+
+			template<typename... Args>
+			constexpr expected_storage(unexpect_t, Args&&... args) noexcept(std::is_nothrow_constructible<error_hold_type, Args&&...>::value)
+				: m_error(std::forward<Args>(args)...)
+				, m_state{ expected_state::error }
+			{}
+
+			template<typename F, typename... Args>
+			constexpr expected_storage(in_place_invoke_t, F&& f, Args&&... args)
+				: m_value(std::invoke(std::forward<F>(f), std::forward<Args>(args)...))
+				, m_state{ expected_state::value }
+			{}
+
+			template<typename F, typename... Args>
+			constexpr expected_storage(unexpect_t, in_place_invoke_t, F&& f, Args&&... args)
+				: m_error(std::invoke(std::forward<F>(f), std::forward<Args>(args)...))
+				, m_state{ expected_state::error }
+			{}
+
+			/**
+			* @brief デストラクタ
+			* @detail nothrow_destructibleな型を前提とするのでnoexcept
+			*/
+			~expected_storage() noexcept {
+				this->destroy();
+			}
+
+			/**
+			* @brief 保持する値を破棄し、valueless状態とする
+			*/
+			void destroy() noexcept {
+				if (m_state == expected_state::value) {
+					detail::destroy_at(std::addressof(m_value));
+				}
+				else if (m_state == expected_state::error) {
+					detail::destroy_at(std::addressof(m_error));
+				}
+				m_state = expected_state::valueless;
+			}
+		};
+
+		/**
+		* @brief expected<T, E>のためのストレージ領域
+		* @detail T、Eが共にtrivially destructibleである場合、デストラクタはtrivialとなる
+		*/
+		template<typename T, typename E>
+		struct expected_storage<T, E, true> {
+			using value_hold_type = std::remove_const_t<T>;
+			using error_hold_type = std::remove_const_t<E>;
+
+			union {
+				unsigned char m_dummy;
+				value_hold_type m_value;
+				error_hold_type m_error;
+			};
+
+			expected_state m_state;
+
+			constexpr expected_storage(nullopt_t) noexcept
+				: m_dummy{}
+				, m_state{ expected_state::valueless }
+			{}
+
+			template<typename... Args>
+			constexpr expected_storage(in_place_t, Args&&... args) noexcept(std::is_nothrow_constructible<value_hold_type, Args&&...>::value)
+				: m_value(std::forward<Args>(args)...)
+				, m_state{ expected_state::value }
+			{}
+
+			template<typename... Args>
+			constexpr expected_storage(unexpect_t, Args&&... args) noexcept(std::is_nothrow_constructible<error_hold_type, Args&&...>::value)
+				: m_error(std::forward<Args>(args)...)
+				, m_state{ expected_state::error }
+			{}
+
+			template<typename F, typename... Args>
+			constexpr expected_storage(in_place_invoke_t, F&& f, Args&&... args)
+				: m_value(std::invoke(std::forward<F>(f), std::forward<Args>(args)...))
+				, m_state{ expected_state::value }
+			{}
+
+			template<typename F, typename... Args>
+			constexpr expected_storage(unexpect_t, in_place_invoke_t, F&& f, Args&&... args)
+				: m_error(std::invoke(std::forward<F>(f), std::forward<Args>(args)...))
+				, m_state{ expected_state::error }
+			{}
+
+			/**
+			* @brief valueless状態とする
+			* @detail 破棄の必要はない
+			*/
+			void destroy() noexcept {
+				m_state = expected_state::valueless;
+			}
+		};
+
+		/**
+		* @brief 保持する値の種類を切り替える際の構築方法
+		* @detail 0 : 直接構築（例外を投げない）、1 : 一時オブジェクトを構築してからムーブ、2 : 古い値を退避して構築し、失敗したら戻す
+		*/
+		template<typename New, typename Old, typename... Args>
+		using reinit_kind = std::integral_constant<int, std::is_nothrow_constructible<New, Args&&...>::value ? 0 : std::is_nothrow_move_constructible<New>::value ? 1 : 2>;
+
+		template<typename New, typename Old, typename... Args>
+		void reinit_expected(New& new_val, Old& old_val, std::integral_constant<int, 0>, Args&&... args) noexcept {
+			detail::destroy_at(std::addressof(old_val));
+			detail::construct_at(std::addressof(new_val), std::forward<Args>(args)...);
+		}
+
+		template<typename New, typename Old, typename... Args>
+		void reinit_expected(New& new_val, Old& old_val, std::integral_constant<int, 1>, Args&&... args) {
+			New tmp(std::forward<Args>(args)...);
+			detail::destroy_at(std::addressof(old_val));
+			detail::construct_at(std::addressof(new_val), std::move(tmp));
+		}
+
+		template<typename New, typename Old, typename... Args>
+		void reinit_expected(New& new_val, Old& old_val, std::integral_constant<int, 2>, Args&&... args) {
+			static_assert(std::is_nothrow_move_constructible<Old>::value, "Either T or E shall be nothrow move constructible to change the state of expected<T, E>.");
+
+			Old tmp(std::move(old_val));
+			detail::destroy_at(std::addressof(old_val));
+			LSTL_TRY {
+				detail::construct_at(std::addressof(new_val), std::forward<Args>(args)...);
+			}
+			LSTL_CATCH_ALL {
+				detail::construct_at(std::addressof(old_val), std::move(tmp));
+				LSTL_RETHROW;
+			}
+		}
+
+		/**
+		* @brief expected<T, E>の共通処理
+		* @detail enable_special_menber_functionsの各層から呼ばれる処理はoptional_common_baseと同じ名前を持つ
+		*/
+		template<typename T, typename E>
+		struct expected_common_base : expected_storage<T, E> {
+			using expected_storage<T, E>::expected_storage;
+			using typename expected_storage<T, E>::value_hold_type;
+			using typename expected_storage<T, E>::error_hold_type;
+
+			template<typename... Args>
+			constexpr expected_common_base(Args&&... args) noexcept(std::is_nothrow_constructible<expected_storage<T, E>, Args&&...>::value)
+				: expected_storage<T, E>{ std::forward<Args>(args)... }
+			{}
+
+			constexpr bool has_value() const noexcept {
+				return this->m_state == expected_state::value;
+			}
+
+			/**
+			* @brief 値の構築
+			* @detail 事前条件として、valueless状態であること（呼び出し側で保証する）
+			* @return 構築した値への参照
+			*/
+			template<typename... Args>
+			auto construct_value(Args&&... args) noexcept(std::is_nothrow_constructible<value_hold_type, Args&&...>::value) -> value_hold_type& {
+				detail::construct_at(std::addressof(this->m_value), std::forward<Args>(args)...);
+
+				this->m_state = expected_state::value;
+				return this->m_value;
+			}
+
+			/**
+			* @brief エラー値の構築
+			* @detail 事前条件として、valueless状態であること（呼び出し側で保証する）
+			* @return 構築したエラー値への参照
+			*/
+			template<typename... Args>
+			auto construct_error(Args&&... args) noexcept(std::is_nothrow_constructible<error_hold_type, Args&&...>::value) -> error_hold_type& {
+				detail::construct_at(std::addressof(this->m_error), std::forward<Args>(args)...);
+
+				this->m_state = expected_state::error;
+				return this->m_error;
+			}
+
+			/**
+			* @brief 値の代入
+			* @detail エラー値を保持している場合、例外が投げられても元のエラー値が残る
+			*/
+			template<typename U>
+			void assign_value(U&& v) {
+				if (this->has_value()) {
+					this->m_value = std::forward<U>(v);
+				}
+				else {
+					reinit_expected(this->m_value, this->m_error, reinit_kind<value_hold_type, error_hold_type, U>{}, std::forward<U>(v));
+					this->m_state = expected_state::value;
+				}
+			}
+
+			/**
+			* @brief エラー値の代入
+			* @detail 値を保持している場合、例外が投げられても元の値が残る
+			*/
+			template<typename G>
+			void assign_error(G&& e) {
+				if (this->m_state == expected_state::error) {
+					this->m_error = std::forward<G>(e);
+				}
+				else {
+					reinit_expected(this->m_error, this->m_value, reinit_kind<error_hold_type, value_hold_type, G>{}, std::forward<G>(e));
+					this->m_state = expected_state::error;
+				}
+			}
+
+			/**
+			* @brief 他expected<T, E>からのコピー/ムーブ構築
+			* @detail 事前条件として、valueless状態であること（呼び出し側で保証する）
+			*/
+			template<typename Expected>
+			void construct_from_other(Expected&& that) {
+				if (that.m_state == expected_state::value) {
+					construct_value(std::forward<Expected>(that).m_value);
+				}
+				else if (that.m_state == expected_state::error) {
+					construct_error(std::forward<Expected>(that).m_error);
+				}
+			}
+
+			/**
+			* @brief 他expected<T, E>からのコピー/ムーブ代入
+			*/
+			template<typename Expected>
+			void assign_from_other(Expected&& that) {
+				if (that.m_state == expected_state::value) {
+					assign_value(std::forward<Expected>(that).m_value);
+				}
+				else {
+					assign_error(std::forward<Expected>(that).m_error);
+				}
+			}
+		};
+
+		/**
+		* @brief 関数の戻り値を値として持つResult（expected）を構築する
+		* @detail 戻り値は直接構築される
+		*/
+		template<typename Result, typename F, typename... Args>
+		constexpr Result expected_invoke_value(std::false_type, F&& f, Args&&... args) {
+			return Result{ in_place_invoke, std::forward<F>(f), std::forward<Args>(args)... };
+		}
+
+		/**
+		* @brief 関数を呼び出し、値を持つResult（expected<void, E>）を構築する
+		*/
+		template<typename Result, typename F, typename... Args>
+		constexpr Result expected_invoke_value(std::true_type, F&& f, Args&&... args) {
+			return std::invoke(std::forward<F>(f), std::forward<Args>(args)...), Result{};
+		}
+
+		/**
+		* @brief 値の変換が許可されるかを調べる
+		* @detail TがU&&で構築可能　かつ　Uがタグ型、expected、unexpected　のいずれでもない場合にtrueとなる
+		*/
+		template<typename T, typename U>
+		using allow_expected_conversion = std::conjunction<
+			std::is_constructible<T, U&&>,
+			std::negation<std::is_same<std::decay_t<U>, in_place_t>>,
+			std::negation<std::is_same<std::decay_t<U>, in_place_invoke_t>>,
+			std::negation<std::is_same<std::decay_t<U>, unexpect_t>>,
+			std::negation<is_expected<std::decay_t<U>>>,
+			std::negation<is_unexpected<std::decay_t<U>>>
+		>;
+	}
+
+	/**
+	* @brief 値かエラー値のどちらかを保持する型
+	* @detail 例外を用いずにエラーを伝搬するためのもの、optionalと同じ層構造によって特殊メンバ関数を定義する
+	* @detail T、Eが共にtrivially copyableならば、expected<T, E>もtrivially copyableとなる
+	* @tparam T 値の型、オブジェクト型であり、デストラクタが例外を投げずに実行可能であること
+	* @tparam E エラーの型、unexpected<E>が有効であること
+	*/
+	template<typename T, typename E>
+	class expected : private detail::enable_special_menber_functions<detail::expected_common_base<T, E>, detail::expected_members<T, E>> {
+
+		using base_storage = detail::enable_special_menber_functions<detail::expected_common_base<T, E>, detail::expected_members<T, E>>;
+
+	public:
+
+		static_assert(std::conjunction<std::is_object<T>, std::negation<std::is_array<T>>, std::is_nothrow_destructible<T>>::value, "T shall be a non-array object type and shall satisfy the requirements of Destructible.");
+		static_assert(std::conjunction<std::negation<std::is_same<std::remove_cv_t<T>, in_place_t>>, std::negation<std::is_same<std::remove_cv_t<T>, in_place_invoke_t>>, std::negation<std::is_same<std::remove_cv_t<T>, unexpect_t>>, std::negation<is_unexpected<std::remove_cv_t<T>>>>::value, "T shall not be a tag type or unexpected.");
+		static_assert(std::is_nothrow_destructible<E>::value, "E shall satisfy the requirements of Destructible.");
+
+		using value_type = T;
+		using error_type = E;
+		using unexpected_type = unexpected<E>;
+
+		template<typename U>
+		using rebind = expected<U, error_type>;
+
+		/**
+		* @brief 値初期化されたTを持つexpected
+		*/
+		template<typename U = T, optional_traits::enabler<std::is_default_constructible<U>> = nullptr>
+		constexpr expected() noexcept(std::is_nothrow_default_constructible<T>::value) : base_storage{ in_place }
+		{}
+
+		/**
+		* @brief コピーコンストラクタ
+		* @detail T、Eが共にtrivially copy constructibleであればtrivial
+		*/
+		expected(const expected&) = default;
+
+		/**
+		* @brief ムーブコンストラクタ
+		* @detail T、Eが共にtrivially move constructibleであればtrivial
+		* @detail noexceptはT、Eのムーブコンストラクタに従う
+		*/
+		expected(expected&&) = default;
+
+		/**
+		* @brief Tを初期化可能なUの値を受けて構築
+		* @detail U&& → Tへ暗黙変換可能な場合のコンストラクタ
+		* @param v 値
+		*/
+		template<typename U = T, optional_traits::enabler<detail::allow_expected_conversion<T, U>, std::is_convertible<U&&, T>> = nullptr>
+		constexpr expected(U&& v) : base_storage{ in_place, std::forward<U>(v) }
+		{}
+
+		/**
+		* @brief Tを初期化可能なUの値を受けて構築
+		* @detail U&& → Tへ暗黙変換不可能な場合のコンストラクタ
+		* @param v 値
+		*/
+		template<typename U = T, optional_traits::enabler<detail::allow_expected_conversion<T, U>, std::negation<std::is_convertible<U&&, T>>> = nullptr>
+		constexpr explicit expected(U&& v) : base_storage{ in_place, std::forward<U>(v) }
+		{}
+
+		/**
+		* @brief unexpected<G>からエラー値を構築
+		* @detail const G& → Eへ暗黙変換可能な場合のコンストラクタ
+		*/
+		template<typename G, optional_traits::enabler<std::is_constructible<E, const G&>, std::is_convertible<const G&, E>> = nullptr>
+		constexpr expected(const unexpected<G>& e) : base_storage{ unexpect, e.error() }
+		{}
+
+		/**
+		* @brief unexpected<G>からエラー値を構築
+		* @detail const G& → Eへ暗黙変換不可能な場合のコンストラクタ
+		*/
+		template<typename G, optional_traits::enabler<std::is_constructible<E, const G&>, std::negation<std::is_convertible<const G&, E>>> = nullptr>
+		constexpr explicit expected(const unexpected<G>& e) : base_storage{ unexpect, e.error() }
+		{}
+
+		/**
+		* @brief unexpected<G>からエラー値をムーブ構築
+		* @detail G&& → Eへ暗黙変換可能な場合のコンストラクタ
+		*/
+		template<typename G, optional_traits::enabler<std::is_constructible<E, G&&>, std::is_convertible<G&&, E>> = nullptr>
+		constexpr expected(unexpected<G>&& e) : base_storage{ unexpect, std::move(e).error() }
+		{}
+
+		/**
+		* @brief unexpected<G>からエラー値をムーブ構築
+		* @detail G&& → Eへ暗黙変換不可能な場合のコンストラクタ
+		*/
+		template<typename G, optional_traits::enabler<std::is_constructible<E, G&&>, std::negation<std::is_convertible<G&&, E>>> = nullptr>
+		constexpr explicit expected(unexpected<G>&& e) : base_storage{ unexpect, std::move(e).error() }
+		{}
+
+		/**
+		* @brief Tのコンストラクタ引数を受けて直接構築
+		* @param args Tに与える引数
+		*/
+		template<typename... Args, optional_traits::enabler<std::is_constructible<T, Args&&...>> = nullptr>
+		constexpr explicit expected(in_place_t, Args&&... args) : base_storage{ in_place, std::forward<Args>(args)... }
+		{}
+
+		/**
+		* @brief Tのコンストラクタ引数を受けて直接構築
+		* @param il Tに与える初期化リスト
+		* @param args その他の引数
+		*/
+		template<typename U, typename... Args, optional_traits::enabler<std::is_constructible<T, std::initializer_list<U>&, Args&&...>> = nullptr>
+		constexpr explicit expected(in_place_t, std::initializer_list<U> il, Args&&... args) : base_storage{ in_place, il, std::forward<Args>(args)... }
+		{}
+
+		/**
+		* @brief Eのコンストラクタ引数を受けてエラー値を直接構築
+		* @param args Eに与える引数
+		*/
+		template<typename... Args, optional_traits::enabler<std::is_constructible<E, Args&&...>> = nullptr>
+		constexpr explicit expected(unexpect_t, Args&&... args) : base_storage{ unexpect, std::forward<Args>(args)... }
+		{}
+
+		/**
+		* @brief 関数の戻り値で値を直接構築する
+		* @detail 戻り値がTのprvalueならばコピー省略によって直接構築される
+		* @param func 呼び出すINVOKE可能な関数
+		* @param args funcに与える引数
+		*/
+		template<typename F, typename... Args, optional_traits::enabler<optional_traits::is_invoke_constructible<T, F&&, Args&&...>> = nullptr>
+		constexpr explicit expected(in_place_invoke_t, F&& func, Args&&... args) : base_storage{ in_place_invoke, std::forward<F>(func), std::forward<Args>(args)... }
+		{}
+
+		/**
+		* @brief 関数の戻り値でエラー値を直接構築する
+		* @detail 戻り値がEのprvalueならばコピー省略によって直接構築される
+		* @param func 呼び出すINVOKE可能な関数
+		* @param args funcに与える引数
+		*/
+		template<typename F, typename... Args, optional_traits::enabler<optional_traits::is_invoke_constructible<E, F&&, Args&&...>> = nullptr>
+		constexpr explicit expected(unexpect_t, in_place_invoke_t, F&& func, Args&&... args) : base_storage{ unexpect, in_place_invoke, std::forward<F>(func), std::forward<Args>(args)... }
+		{}
+
+		/**
+		* @brief コピー代入演算子
+		* @detail T、Eが共にtrivially copyableであればtrivial
+		* @detail 保持する値の種類が変わる場合、TかEのどちらかがnothrow move constructibleであること
+		*/
+		expected& operator=(const expected&) = default;
+
+		/**
+		* @brief ムーブ代入演算子
+		* @detail T、Eが共にtrivially copyableであればtrivial
+		* @detail 保持する値の種類が変わる場合、TかEのどちらかがnothrow move constructibleであること
+		*/
+		expected& operator=(expected&&) = default;
+
+		/**
+		* @brief 値の代入
+		* @detail エラー値を保持していた場合は破棄して値を構築する
+		* @return *this
+		*/
+		template<typename U = T, optional_traits::enabler<detail::allow_expected_conversion<T, U>, std::is_assignable<T&, U&&>> = nullptr>
+		expected& operator=(U&& v) {
+			this->assign_value(std::forward<U>(v));
+			return *this;
+		}
+
+		/**
+		* @brief エラー値の代入
+		* @detail 値を保持していた場合は破棄してエラー値を構築する
+		* @return *this
+		*/
+		template<typename G, optional_traits::enabler<std::is_constructible<E, const G&>, std::is_assignable<E&, const G&>> = nullptr>
+		expected& operator=(const unexpected<G>& e) {
+			this->assign_error(e.error());
+			return *this;
+		}
+
+		/**
+		* @brief エラー値のムーブ代入
+		* @detail 値を保持していた場合は破棄してエラー値を構築する
+		* @return *this
+		*/
+		template<typename G, optional_traits::enabler<std::is_constructible<E, G&&>, std::is_assignable<E&, G&&>> = nullptr>
+		expected& operator=(unexpected<G>&& e) {
+			this->assign_error(std::move(e).error());
+			return *this;
+		}
+
+		/**
+		* @brief Tのコンストラクタ引数から直接構築する。
+		* @detail 構築が例外を投げないこと（保持していた値は先に破棄されるため）
+		* @param args Tの構築に必要な引数列
+		* @return 構築した値への参照
+		*/
+		template<typename... Args, optional_traits::enabler<std::is_nothrow_constructible<T, Args&&...>> = nullptr>
+		T& emplace(Args&&... args) noexcept {
+			this->destroy();
+			return this->construct_value(std::forward<Args>(args)...);
+		}
+
+		/**
+		* @brief 値を保持しているか
+		*/
+		constexpr bool has_value() const noexcept {
+			return base_storage::has_value();
+		}
+
+		constexpr explicit operator bool() const noexcept {
+			return base_storage::has_value();
+		}
+
+		constexpr const T* operator->() const {
+			return std::addressof(this->m_value);
+		}
+
+		T* operator->() {
+			return std::addressof(this->m_value);
+		}
+
+		T& operator*() & {
+			return this->m_value;
+		}
+
+		T&& operator*() && {
+			return std::move(this->m_value);
+		}
+
+		constexpr const T& operator*() const & {
+			return this->m_value;
+		}
+
+		constexpr const T&& operator*() const && {
+			return std::move(this->m_value);
+		}
+
+		T& value() & {
+			return (this->has_value()) ? this->m_value : (detail::raise_bad_access<bad_expected_access<std::decay_t<E>>>(this->m_error), this->m_value);
+		}
+
+		T&& value() && {
+			return (this->has_value()) ? std::move(this->m_value) : (detail::raise_bad_access<bad_expected_access<std::decay_t<E>>>(std::move(this->m_error)), std::move(this->m_value));
+		}
+
+		constexpr const T& value() const & {
+			return (this->has_value()) ? this->m_value : (detail::raise_bad_access<bad_expected_access<std::decay_t<E>>>(this->m_error), this->m_value);
+		}
+
+		constexpr const T&& value() const && {
+			return (this->has_value()) ? std::move(this->m_value) : (detail::raise_bad_access<bad_expected_access<std::decay_t<E>>>(std::move(this->m_error)), std::move(this->m_value));
+		}
+
+		E& error() & {
+			return this->m_error;
+		}
+
+		E&& error() && {
+			return std::move(this->m_error);
+		}
+
+		constexpr const E& error() const & {
+			return this->m_error;
+		}
+
+		constexpr const E&& error() const && {
+			return std::move(this->m_error);
+		}
+
+		/**
+		* @brief 値のコピーか、エラー値を保持していれば指定した値を返す
+		* @param v エラー値を保持していた時に返す値
+		*/
+		template<typename U>
+		constexpr T value_or(U&& v) const & {
+			return (this->has_value()) ? this->m_value : static_cast<T>(std::forward<U>(v));
+		}
+
+		/**
+		* @brief 値のムーブか、エラー値を保持していれば指定した値を返す
+		* @param v エラー値を保持していた時に返す値
+		*/
+		template<typename U>
+		constexpr T value_or(U&& v) && {
+			return (this->has_value()) ? std::move(this->m_value) : static_cast<T>(std::forward<U>(v));
+		}
+
+		/**
+		* @brief 値に関数を適用しその結果をexpectedで返す
+		* @detail 戻り値は結果のexpectedに直接構築される、voidを返す関数の場合はexpected<void, E>となる
+		* @param func 適用するINVOKE可能な関数
+		* @return 値を保持する場合、func(this->value())の戻り値を持つexpected、そうでないならエラー値のコピー
+		*/
+		template<typename F>
+		auto transform(F&& func) & -> expected<optional_traits::invoke_result_t<F, T&>, E> {
+			using result_type = expected<optional_traits::invoke_result_t<F, T&>, E>;
+
+			return (this->has_value() == true)
+				? detail::expected_invoke_value<result_type>(std::is_void<typename result_type::value_type>{}, std::forward<F>(func), this->m_value)
+				: result_type{ unexpect, this->m_error };
+		}
+
+		/**
+		* @brief 値に関数を適用しその結果をexpectedで返す
+		* @detail 戻り値は結果のexpectedに直接構築される、voidを返す関数の場合はexpected<void, E>となる
+		* @param func 適用するINVOKE可能な関数
+		* @return 値を保持する場合、func(this->value())の戻り値を持つexpected、そうでないならエラー値のコピー
+		*/
+		template<typename F>
+		constexpr auto transform(F&& func) const & -> expected<optional_traits::invoke_result_t<F, const T&>, E> {
+			using result_type = expected<optional_traits::invoke_result_t<F, const T&>, E>;
+
+			return (this->has_value() == true)
+				? detail::expected_invoke_value<result_type>(std::is_void<typename result_type::value_type>{}, std::forward<F>(func), this->m_value)
+				: result_type{ unexpect, this->m_error };
+		}
+
+		/**
+		* @brief 値に関数を適用しその結果をexpectedで返す
+		* @detail 戻り値は結果のexpectedに直接構築される、voidを返す関数の場合はexpected<void, E>となる
+		* @param func 適用するINVOKE可能な関数
+		* @return 値を保持する場合、func(std::move(this->value()))の戻り値を持つexpected、そうでないならエラー値のムーブ
+		*/
+		template<typename F>
+		auto transform(F&& func) && -> expected<optional_traits::invoke_result_t<F, T&&>, E> {
+			using result_type = expected<optional_traits::invoke_result_t<F, T&&>, E>;
+
+			return (this->has_value() == true)
+				? detail::expected_invoke_value<result_type>(std::is_void<typename result_type::value_type>{}, std::forward<F>(func), std::move(this->m_value))
+				: result_type{ unexpect, std::move(this->m_error) };
+		}
+
+		/**
+		* @brief 値に関数を適用しその結果をexpectedで返す
+		* @detail 戻り値は結果のexpectedに直接構築される、voidを返す関数の場合はexpected<void, E>となる
+		* @param func 適用するINVOKE可能な関数
+		* @return 値を保持する場合、func(std::move(this->value()))の戻り値を持つexpected、そうでないならエラー値のムーブ
+		*/
+		template<typename F>
+		constexpr auto transform(F&& func) const && -> expected<optional_traits::invoke_result_t<F, const T&&>, E> {
+			using result_type = expected<optional_traits::invoke_result_t<F, const T&&>, E>;
+
+			return (this->has_value() == true)
+				? detail::expected_invoke_value<result_type>(std::is_void<typename result_type::value_type>{}, std::forward<F>(func), std::move(this->m_value))
+				: result_type{ unexpect, std::move(this->m_error) };
+		}
+
+		/**
+		* @brief エラー値に関数を適用しその結果をエラー値とするexpectedを返す
+		* @detail 戻り値は結果のexpectedに直接構築される
+		* @param func 適用するINVOKE可能な関数
+		* @return エラー値を保持する場合、func(this->error())の戻り値をエラー値とするexpected、そうでないなら値のコピー
+		*/
+		template<typename F>
+		auto transform_error(F&& func) & -> expected<T, optional_traits::invoke_result_t<F, E&>> {
+			using result_type = expected<T, optional_traits::invoke_result_t<F, E&>>;
+
+			return (this->has_value() == true)
+				? result_type{ in_place, this->m_value }
+				: result_type{ unexpect, in_place_invoke, std::forward<F>(func), this->m_error };
+		}
+
+		/**
+		* @brief エラー値に関数を適用しその結果をエラー値とするexpectedを返す
+		* @detail 戻り値は結果のexpectedに直接構築される
+		* @param func 適用するINVOKE可能な関数
+		* @return エラー値を保持する場合、func(this->error())の戻り値をエラー値とするexpected、そうでないなら値のコピー
+		*/
+		template<typename F>
+		constexpr auto transform_error(F&& func) const & -> expected<T, optional_traits::invoke_result_t<F, const E&>> {
+			using result_type = expected<T, optional_traits::invoke_result_t<F, const E&>>;
+
+			return (this->has_value() == true)
+				? result_type{ in_place, this->m_value }
+				: result_type{ unexpect, in_place_invoke, std::forward<F>(func), this->m_error };
+		}
+
+		/**
+		* @brief エラー値に関数を適用しその結果をエラー値とするexpectedを返す
+		* @detail 戻り値は結果のexpectedに直接構築される
+		* @param func 適用するINVOKE可能な関数
+		* @return エラー値を保持する場合、func(std::move(this->error()))の戻り値をエラー値とするexpected、そうでないなら値のムーブ
+		*/
+		template<typename F>
+		auto transform_error(F&& func) && -> expected<T, optional_traits::invoke_result_t<F, E&&>> {
+			using result_type = expected<T, optional_traits::invoke_result_t<F, E&&>>;
+
+			return (this->has_value() == true)
+				? result_type{ in_place, std::move(this->m_value) }
+				: result_type{ unexpect, in_place_invoke, std::forward<F>(func), std::move(this->m_error) };
+		}
+
+		/**
+		* @brief エラー値に関数を適用しその結果をエラー値とするexpectedを返す
+		* @detail 戻り値は結果のexpectedに直接構築される
+		* @param func 適用するINVOKE可能な関数
+		* @return エラー値を保持する場合、func(std::move(this->error()))の戻り値をエラー値とするexpected、そうでないなら値のムーブ
+		*/
+		template<typename F>
+		constexpr auto transform_error(F&& func) const && -> expected<T, optional_traits::invoke_result_t<F, const E&&>> {
+			using result_type = expected<T, optional_traits::invoke_result_t<F, const E&&>>;
+
+			return (this->has_value() == true)
+				? result_type{ in_place, std::move(this->m_value) }
+				: result_type{ unexpect, in_place_invoke, std::forward<F>(func), std::move(this->m_error) };
+		}
+
+		/**
+		* @brief 値に関数を適用しその結果を返す
+		* @detail 渡される関数の戻り値はエラー型がEであるexpectedであること
+		* @param func 適用するINVOKE可能な関数
+		* @return 値を保持する場合、func(this->value())、そうでないならエラー値のコピー
+		*/
+		template<typename F>
+		auto and_then(F&& func) & -> optional_traits::invoke_result_t<F, T&> {
+			using result_type = optional_traits::invoke_result_t<F, T&>;
+			static_assert(is_expected<result_type>::value && std::is_same<typename result_type::error_type, E>::value, "F shall return expected<U, E>.");
+
+			return (this->has_value() == true)
+				? std::invoke(std::forward<F>(func), this->m_value)
+				: result_type{ unexpect, this->m_error };
+		}
+
+		/**
+		* @brief 値に関数を適用しその結果を返す
+		* @detail 渡される関数の戻り値はエラー型がEであるexpectedであること
+		* @param func 適用するINVOKE可能な関数
+		* @return 値を保持する場合、func(this->value())、そうでないならエラー値のコピー
+		*/
+		template<typename F>
+		constexpr auto and_then(F&& func) const & -> optional_traits::invoke_result_t<F, const T&> {
+			using result_type = optional_traits::invoke_result_t<F, const T&>;
+			static_assert(is_expected<result_type>::value && std::is_same<typename result_type::error_type, E>::value, "F shall return expected<U, E>.");
+
+			return (this->has_value() == true)
+				? std::invoke(std::forward<F>(func), this->m_value)
+				: result_type{ unexpect, this->m_error };
+		}
+
+		/**
+		* @brief 値に関数を適用しその結果を返す
+		* @detail 渡される関数の戻り値はエラー型がEであるexpectedであること
+		* @param func 適用するINVOKE可能な関数
+		* @return 値を保持する場合、func(std::move(this->value()))、そうでないならエラー値のムーブ
+		*/
+		template<typename F>
+		auto and_then(F&& func) && -> optional_traits::invoke_result_t<F, T&&> {
+			using result_type = optional_traits::invoke_result_t<F, T&&>;
+			static_assert(is_expected<result_type>::value && std::is_same<typename result_type::error_type, E>::value, "F shall return expected<U, E>.");
+
+			return (this->has_value() == true)
+				? std::invoke(std::forward<F>(func), std::move(this->m_value))
+				: result_type{ unexpect, std::move(this->m_error) };
+		}
+
+		/**
+		* @brief 値に関数を適用しその結果を返す
+		* @detail 渡される関数の戻り値はエラー型がEであるexpectedであること
+		* @param func 適用するINVOKE可能な関数
+		* @return 値を保持する場合、func(std::move(this->value()))、そうでないならエラー値のムーブ
+		*/
+		template<typename F>
+		constexpr auto and_then(F&& func) const && -> optional_traits::invoke_result_t<F, const T&&> {
+			using result_type = optional_traits::invoke_result_t<F, const T&&>;
+			static_assert(is_expected<result_type>::value && std::is_same<typename result_type::error_type, E>::value, "F shall return expected<U, E>.");
+
+			return (this->has_value() == true)
+				? std::invoke(std::forward<F>(func), std::move(this->m_value))
+				: result_type{ unexpect, std::move(this->m_error) };
+		}
+
+		/**
+		* @brief エラー値に関数を適用しその結果を返す
+		* @detail 渡される関数の戻り値は値型がTであるexpectedであること
+		* @param func 適用するINVOKE可能な関数
+		* @return エラー値を保持する場合、func(this->error())、そうでないなら値のコピー
+		*/
+		template<typename F>
+		auto or_else(F&& func) & -> optional_traits::invoke_result_t<F, E&> {
+			using result_type = optional_traits::invoke_result_t<F, E&>;
+			static_assert(is_expected<result_type>::value && std::is_same<typename result_type::value_type, T>::value, "F shall return expected<T, G>.");
+
+			return (this->has_value() == true)
+				? result_type{ in_place, this->m_value }
+				: std::invoke(std::forward<F>(func), this->m_error);
+		}
+
+		/**
+		* @brief エラー値に関数を適用しその結果を返す
+		* @detail 渡される関数の戻り値は値型がTであるexpectedであること
+		* @param func 適用するINVOKE可能な関数
+		* @return エラー値を保持する場合、func(this->error())、そうでないなら値のコピー
+		*/
+		template<typename F>
+		constexpr auto or_else(F&& func) const & -> optional_traits::invoke_result_t<F, const E&> {
+			using result_type = optional_traits::invoke_result_t<F, const E&>;
+			static_assert(is_expected<result_type>::value && std::is_same<typename result_type::value_type, T>::value, "F shall return expected<T, G>.");
+
+			return (this->has_value() == true)
+				? result_type{ in_place, this->m_value }
+				: std::invoke(std::forward<F>(func), this->m_error);
+		}
+
+		/**
+		* @brief エラー値に関数を適用しその結果を返す
+		* @detail 渡される関数の戻り値は値型がTであるexpectedであること
+		* @param func 適用するINVOKE可能な関数
+		* @return エラー値を保持する場合、func(std::move(this->error()))、そうでないなら値のムーブ
+		*/
+		template<typename F>
+		auto or_else(F&& func) && -> optional_traits::invoke_result_t<F, E&&> {
+			using result_type = optional_traits::invoke_result_t<F, E&&>;
+			static_assert(is_expected<result_type>::value && std::is_same<typename result_type::value_type, T>::value, "F shall return expected<T, G>.");
+
+			return (this->has_value() == true)
+				? result_type{ in_place, std::move(this->m_value) }
+				: std::invoke(std::forward<F>(func), std::move(this->m_error));
+		}
+
+		/**
+		* @brief エラー値に関数を適用しその結果を返す
+		* @detail 渡される関数の戻り値は値型がTであるexpectedであること
+		* @param func 適用するINVOKE可能な関数
+		* @return エラー値を保持する場合、func(std::move(this->error()))、そうでないなら値のムーブ
+		*/
+		template<typename F>
+		constexpr auto or_else(F&& func) const && -> optional_traits::invoke_result_t<F, const E&&> {
+			using result_type = optional_traits::invoke_result_t<F, const E&&>;
+			static_assert(is_expected<result_type>::value && std::is_same<typename result_type::value_type, T>::value, "F shall return expected<T, G>.");
+
+			return (this->has_value() == true)
+				? result_type{ in_place, std::move(this->m_value) }
+				: std::invoke(std::forward<F>(func), std::move(this->m_error));
+		}
+	};
+
+	/**
+	* @brief 値を持たない（成否のみを表す）expected
+	* @detail エラー値をoptional<E>で保持する、E がtrivially copyableならばexpected<void, E>もtrivially copyableとなる
+	* @tparam E エラーの型
+	*/
+	template<typename E>
+	class expected<void, E> {
+
+		optional<E> m_error;
+
+	public:
+
+		using value_type = void;
+		using error_type = E;
+		using unexpected_type = unexpected<E>;
+
+		template<typename U>
+		using rebind = expected<U, error_type>;
+
+		/**
+		* @brief 成功を表すexpected
+		*/
+		constexpr expected() noexcept = default;
+
+		constexpr explicit expected(in_place_t) noexcept
+		{}
+
+		template<typename G, optional_traits::enabler<std::is_constructible<E, const G&>> = nullptr>
+		constexpr expected(const unexpected<G>& e) : m_error{ in_place, e.error() }
+		{}
+
+		template<typename G, optional_traits::enabler<std::is_constructible<E, G&&>> = nullptr>
+		constexpr expected(unexpected<G>&& e) : m_error{ in_place, std::move(e).error() }
+		{}
+
+		template<typename... Args, optional_traits::enabler<std::is_constructible<E, Args&&...>> = nullptr>
+		constexpr explicit expected(unexpect_t, Args&&... args) : m_error{ in_place, std::forward<Args>(args)... }
+		{}
+
+		template<typename F, typename... Args, optional_traits::enabler<optional_traits::is_invoke_constructible<E, F&&, Args&&...>> = nullptr>
+		constexpr explicit expected(unexpect_t, in_place_invoke_t, F&& func, Args&&... args) : m_error{ in_place_invoke, std::forward<F>(func), std::forward<Args>(args)... }
+		{}
+
+		template<typename G, optional_traits::enabler<std::is_constructible<E, const G&>, std::is_assignable<E&, const G&>> = nullptr>
+		expected& operator=(const unexpected<G>& e) {
+			m_error = e.error();
+			return *this;
+		}
+
+		template<typename G, optional_traits::enabler<std::is_constructible<E, G&&>, std::is_assignable<E&, G&&>> = nullptr>
+		expected& operator=(unexpected<G>&& e) {
+			m_error = std::move(e).error();
+			return *this;
+		}
+
+		/**
+		* @brief エラー値を破棄し成功状態とする
+		*/
+		void emplace() noexcept {
+			m_error.reset();
+		}
+
+		constexpr bool has_value() const noexcept {
+			return m_error.has_value() == false;
+		}
+
+		constexpr explicit operator bool() const noexcept {
+			return m_error.has_value() == false;
+		}
+
+		void operator*() const noexcept
+		{}
+
+		void value() const & {
+			if (m_error.has_value()) detail::raise_bad_access<bad_expected_access<std::decay_t<E>>>(*m_error);
+		}
+
+		void value() && {
+			if (m_error.has_value()) detail::raise_bad_access<bad_expected_access<std::decay_t<E>>>(std::move(*m_error));
+		}
+
+		E& error() & {
+			return *m_error;
+		}
+
+		E&& error() && {
+			return std::move(*m_error);
+		}
+
+		constexpr const E& error() const & {
+			return *m_error;
+		}
+
+		constexpr const E&& error() const && {
+			return std::move(*m_error);
+		}
+
+		/**
+		* @brief 成功していれば関数を呼び出しその結果をexpectedで返す
+		* @param func 呼び出すINVOKE可能な関数
+		* @return 値を保持する場合、func()の戻り値を持つexpected、そうでないならエラー値のコピー
+		*/
+		template<typename F>
+		constexpr auto transform(F&& func) const & -> expected<optional_traits::invoke_result_t<F>, E> {
+			using result_type = expected<optional_traits::invoke_result_t<F>, E>;
+
+			return (this->has_value() == true)
+				? detail::expected_invoke_value<result_type>(std::is_void<typename result_type::value_type>{}, std::forward<F>(func))
+				: result_type{ unexpect, *m_error };
+		}
+
+		/**
+		* @brief 成功していれば関数を呼び出しその結果をexpectedで返す
+		* @param func 呼び出すINVOKE可能な関数
+		* @return 値を保持する場合、func()の戻り値を持つexpected、そうでないならエラー値のムーブ
+		*/
+		template<typename F>
+		auto transform(F&& func) && -> expected<optional_traits::invoke_result_t<F>, E> {
+			using result_type = expected<optional_traits::invoke_result_t<F>, E>;
+
+			return (this->has_value() == true)
+				? detail::expected_invoke_value<result_type>(std::is_void<typename result_type::value_type>{}, std::forward<F>(func))
+				: result_type{ unexpect, std::move(*m_error) };
+		}
+
+		/**
+		* @brief エラー値に関数を適用しその結果をエラー値とするexpectedを返す
+		* @param func 適用するINVOKE可能な関数
+		* @return エラー値を保持する場合、func(this->error())の戻り値をエラー値とするexpected、そうでないなら成功
+		*/
+		template<typename F>
+		constexpr auto transform_error(F&& func) const & -> expected<void, optional_traits::invoke_result_t<F, const E&>> {
+			using result_type = expected<void, optional_traits::invoke_result_t<F, const E&>>;
+
+			return (this->has_value() == true)
+				? result_type{}
+				: result_type{ unexpect, in_place_invoke, std::forward<F>(func), *m_error };
+		}
+
+		/**
+		* @brief エラー値に関数を適用しその結果をエラー値とするexpectedを返す
+		* @param func 適用するINVOKE可能な関数
+		* @return エラー値を保持する場合、func(std::move(this->error()))の戻り値をエラー値とするexpected、そうでないなら成功
+		*/
+		template<typename F>
+		auto transform_error(F&& func) && -> expected<void, optional_traits::invoke_result_t<F, E&&>> {
+			using result_type = expected<void, optional_traits::invoke_result_t<F, E&&>>;
+
+			return (this->has_value() == true)
+				? result_type{}
+				: result_type{ unexpect, in_place_invoke, std::forward<F>(func), std::move(*m_error) };
+		}
+
+		/**
+		* @brief 成功していれば関数を呼び出しその結果を返す
+		* @detail 渡される関数の戻り値はエラー型がEであるexpectedであること
+		* @param func 呼び出すINVOKE可能な関数
+		* @return 値を保持する場合、func()、そうでないならエラー値のコピー
+		*/
+		template<typename F>
+		constexpr auto and_then(F&& func) const & -> optional_traits::invoke_result_t<F> {
+			using result_type = optional_traits::invoke_result_t<F>;
+			static_assert(is_expected<result_type>::value && std::is_same<typename result_type::error_type, E>::value, "F shall return expected<U, E>.");
+
+			return (this->has_value() == true)
+				? std::invoke(std::forward<F>(func))
+				: result_type{ unexpect, *m_error };
+		}
+
+		/**
+		* @brief 成功していれば関数を呼び出しその結果を返す
+		* @detail 渡される関数の戻り値はエラー型がEであるexpectedであること
+		* @param func 呼び出すINVOKE可能な関数
+		* @return 値を保持する場合、func()、そうでないならエラー値のムーブ
+		*/
+		template<typename F>
+		auto and_then(F&& func) && -> optional_traits::invoke_result_t<F> {
+			using result_type = optional_traits::invoke_result_t<F>;
+			static_assert(is_expected<result_type>::value && std::is_same<typename result_type::error_type, E>::value, "F shall return expected<U, E>.");
+
+			return (this->has_value() == true)
+				? std::invoke(std::forward<F>(func))
+				: result_type{ unexpect, std::move(*m_error) };
+		}
+
+		/**
+		* @brief エラー値に関数を適用しその結果を返す
+		* @detail 渡される関数の戻り値は値型がvoidであるexpectedであること
+		* @param func 適用するINVOKE可能な関数
+		* @return エラー値を保持する場合、func(this->error())、そうでないなら成功
+		*/
+		template<typename F>
+		constexpr auto or_else(F&& func) const & -> optional_traits::invoke_result_t<F, const E&> {
+			using result_type = optional_traits::invoke_result_t<F, const E&>;
+			static_assert(is_expected<result_type>::value && std::is_void<typename result_type::value_type>::value, "F shall return expected<void, G>.");
+
+			return (this->has_value() == true)
+				? result_type{}
+				: std::invoke(std::forward<F>(func), *m_error);
+		}
+
+		/**
+		* @brief エラー値に関数を適用しその結果を返す
+		* @detail 渡される関数の戻り値は値型がvoidであるexpectedであること
+		* @param func 適用するINVOKE可能な関数
+		* @return エラー値を保持する場合、func(std::move(this->error()))、そうでないなら成功
+		*/
+		template<typename F>
+		auto or_else(F&& func) && -> optional_traits::invoke_result_t<F, E&&> {
+			using result_type = optional_traits::invoke_result_t<F, E&&>;
+			static_assert(is_expected<result_type>::value && std::is_void<typename result_type::value_type>::value, "F shall return expected<void, G>.");
+
+			return (this->has_value() == true)
+				? result_type{}
+				: std::invoke(std::forward<F>(func), std::move(*m_error));
+		}
+	};
+
+	/**
+	* @brief expected同士の比較
+	* @return 保持する値の種類が異なればfalse、同じならば値かエラー値を比較（==）
+	*/
+	template<typename T1, typename E1, typename T2, typename E2>
+	constexpr bool operator==(const expected<T1, E1>& lhs, const expected<T2, E2>& rhs) {
+		return (lhs.has_value() != rhs.has_value())
+			? (false)
+			: ((lhs.has_value() == true)
+				? (*lhs == *rhs)
+				: (lhs.error() == rhs.error()));
+	}
+
+	/**
+	* @brief expected<void, E>同士の比較
+	* @return 保持する値の種類が異なればfalse、両方成功ならtrue、そうでないならエラー値を比較（==）
+	*/
+	template<typename E1, typename E2>
+	constexpr bool operator==(const expected<void, E1>& lhs, const expected<void, E2>& rhs) {
+		return (lhs.has_value() != rhs.has_value())
+			? (false)
+			: ((lhs.has_value() == true)
+				? (true)
+				: (lhs.error() == rhs.error()));
+	}
+
+	template<typename T1, typename E1, typename T2, typename E2>
+	constexpr bool operator!=(const expected<T1, E1>& lhs, const expected<T2, E2>& rhs) {
+		return !(lhs == rhs);
+	}
+
+	/**
+	* @brief expectedと値の比較
+	* @return 値を保持していてそれがvと等しければtrue
+	*/
+	template<typename T, typename E, typename U, optional_traits::enabler<std::negation<is_expected<U>>, std::negation<is_unexpected<U>>> = nullptr>
+	constexpr bool operator==(const expected<T, E>& x, const U& v) {
+		return (x.has_value() == true) ? (*x == v) : false;
+	}
+
+	template<typename T, typename E, typename U, optional_traits::enabler<std::negation<is_expected<U>>, std::negation<is_unexpected<U>>> = nullptr>
+	constexpr bool operator==(const U& v, const expected<T, E>& x) {
+		return x == v;
+	}
+
+	template<typename T, typename E, typename U, optional_traits::enabler<std::negation<is_expected<U>>, std::negation<is_unexpected<U>>> = nullptr>
+	constexpr bool operator!=(const expected<T, E>& x, const U& v) {
+		return !(x == v);
+	}
+
+	template<typename T, typename E, typename U, optional_traits::enabler<std::negation<is_expected<U>>, std::negation<is_unexpected<U>>> = nullptr>
+	constexpr bool operator!=(const U& v, const expected<T, E>& x) {
+		return !(x == v);
+	}
+
+	/**
+	* @brief expectedとunexpectedの比較
+	* @return エラー値を保持していてそれがe.error()と等しければtrue
+	*/
+	template<typename T, typename E, typename G>
+	constexpr bool operator==(const expected<T, E>& x, const unexpected<G>& e) {
+		return (x.has_value() == false) ? (x.error() == e.error()) : false;
+	}
+
+	template<typename T, typename E, typename G>
+	constexpr bool operator==(const unexpected<G>& e, const expected<T, E>& x) {
+		return x == e;
+	}
+
+	template<typename T, typename E, typename G>
+	constexpr bool operator!=(const expected<T, E>& x, const unexpected<G>& e) {
+		return !(x == e);
+	}
+
+	template<typename T, typename E, typename G>
+	constexpr bool operator!=(const unexpected<G>& e, const expected<T, E>& x) {
+		return !(x == e);
+	}
+
+	/**
+	* @brief expected<T, E>はT、Eが共にtrivially relocatableならばtrivially relocatable
+	*/
+	template<typename T, typename E>
+	struct is_trivially_relocatable<expected<T, E>> : std::conjunction<is_trivially_relocatable<T>, is_trivially_relocatable<E>> {};
+
+	template<typename E>
+	struct is_trivially_relocatable<expected<void, E>> : is_trivially_relocatable<optional<E>> {};
+}
+
+//警告抑止の解除
+#pragma warning(pop)
\ No newline at end of file
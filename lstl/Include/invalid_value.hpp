@@ -0,0 +1,86 @@
+﻿#pragma once
+
+#include <type_traits>
+#include <limits>
+#include <utility>
+
+namespace lstl {
+
+	/**
+	* @brief 無効値（使われることのないビットパターン）を宣言するためのカスタマイゼーションポイント
+	* @detail Tについて特殊化し、static constexpr な invalid_value() と is_invalid(const T&) を定義すると
+	* @detail optional<T>はその値によって無効状態を表現し、有効値フラグを持たなくなる（sizeof(optional<T>) == sizeof(T)）
+	* @detail 特殊化できるのはtrivially copyableな型のみ、無効値そのものをoptionalに格納してはならない
+	* @tparam T 無効値を宣言する型
+	*/
+	template<typename T>
+	struct invalid_value_traits {};
+
+	/**
+	* @brief 特定の定数を無効値とするinvalid_value_traitsの実装
+	* @detail template<> struct invalid_value_traits<std::uint32_t> : invalid_value_constant<std::uint32_t, UINT32_MAX> {}; のように用いる
+	* @tparam T 値の型、整数型・列挙型・ポインタ型であること
+	* @tparam Invalid 無効値とする定数
+	*/
+	template<typename T, T Invalid>
+	struct invalid_value_constant {
+
+		static constexpr T invalid_value() noexcept {
+			return Invalid;
+		}
+
+		static constexpr bool is_invalid(const T& v) noexcept {
+			return v == Invalid;
+		}
+	};
+
+	/**
+	* @brief nullptrを無効値とするinvalid_value_traitsの実装
+	* @tparam T ポインタ型
+	*/
+	template<typename T>
+	struct invalid_value_nullptr {
+		static_assert(std::is_pointer<T>::value, "T shall be a pointer type.");
+
+		static constexpr T invalid_value() noexcept {
+			return nullptr;
+		}
+
+		static constexpr bool is_invalid(const T& v) noexcept {
+			return v == nullptr;
+		}
+	};
+
+	/**
+	* @brief quiet NaNを無効値とするinvalid_value_traitsの実装
+	* @detail あらゆるNaNが無効値とみなされる
+	* @tparam T 浮動小数点型
+	*/
+	template<typename T>
+	struct invalid_value_nan {
+		static_assert(std::numeric_limits<T>::has_quiet_NaN, "T shall have a quiet NaN.");
+
+		static constexpr T invalid_value() noexcept {
+			return std::numeric_limits<T>::quiet_NaN();
+		}
+
+		static constexpr bool is_invalid(const T& v) noexcept {
+			return v != v;
+		}
+	};
+
+	namespace detail {
+
+		/**
+		* @brief Traitsが型Tの無効値を宣言しているかを調べる
+		* @detail Traits::invalid_value()とTraits::is_invalid(const T&)の両方が利用可能な場合にtrue
+		* @tparam Traits invalid_value_traits<T>、又はinvalid_value_constant等
+		* @tparam T 値の型
+		*/
+		template<typename Traits, typename T, typename = void>
+		struct has_invalid_value_of : std::false_type {};
+
+		template<typename Traits, typename T>
+		struct has_invalid_value_of<Traits, T, std::void_t<decltype(Traits::invalid_value()), decltype(Traits::is_invalid(std::declval<const T&>()))>> : std::true_type {};
+	}
+}
\ No newline at end of file
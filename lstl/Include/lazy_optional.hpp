@@ -0,0 +1,220 @@
+﻿#pragma once
+
+#include <type_traits>
+#include <utility>
+#include <atomic>
+#include <mutex>
+
+#include "config.hpp"
+#include "optional.hpp"
+
+namespace lstl {
+
+	/**
+	* @brief 最初にアクセスされた時に値を構築するoptional
+	* @detail 構築済みであれば、アクセスは1つの分岐のみ
+	* @detail constなオブジェクトからのアクセスでも構築される（論理的にconst）
+	* @detail スレッドセーフではない、複数スレッドから参照する場合はconcurrent_lazy_optionalを用いる
+	* @tparam T 格納する要素型
+	* @tparam Factory 引数無しで呼び出し可能であり、Tを構築可能な値を返す関数オブジェクト型
+	*/
+	template<typename T, typename Factory = T(*)()>
+	class lazy_optional {
+		static_assert(std::is_constructible<T, optional_traits::invoke_result_t<Factory&>>::value, "T shall be constructible from the result of Factory.");
+
+		mutable detail::optional_common_base<T> m_storage;
+		mutable Factory m_factory;
+
+		LSTL_NOINLINE_COLD T& materialize() const {
+			return m_storage.construct(m_factory());
+		}
+
+	public:
+
+		using value_type = T;
+		using factory_type = Factory;
+
+		/**
+		* @brief 値を構築する関数を受けて初期化、値はまだ構築しない
+		* @param factory 値を構築する関数
+		*/
+		explicit lazy_optional(Factory factory) noexcept(std::is_nothrow_move_constructible<Factory>::value)
+			: m_storage{ nullopt }
+			, m_factory(std::move(factory))
+		{}
+
+		/**
+		* @brief ムーブコンストラクタ
+		* @detail 構築済みであれば値もムーブする
+		*/
+		lazy_optional(lazy_optional&& other) noexcept(std::conjunction<std::is_nothrow_move_constructible<T>, std::is_nothrow_move_constructible<Factory>>::value)
+			: m_storage{ nullopt }
+			, m_factory(std::move(other.m_factory))
+		{
+			m_storage.construct_from_other(std::move(other.m_storage));
+		}
+
+		lazy_optional(const lazy_optional&) = delete;
+		lazy_optional& operator=(const lazy_optional&) = delete;
+		lazy_optional& operator=(lazy_optional&&) = delete;
+
+		/**
+		* @brief 値を取得する、構築されていなければ構築する
+		* @detail Factoryが例外を投げた場合は構築されず、次のアクセスで再び構築を試みる
+		* @return 構築済みの値への参照
+		*/
+		T& value() {
+			return (m_storage.has_value()) ? m_storage.m_value : materialize();
+		}
+
+		/**
+		* @brief 値を取得する、構築されていなければ構築する
+		* @detail constなオブジェクトからは値を書き換えられない
+		*/
+		const T& value() const {
+			return (m_storage.has_value()) ? m_storage.m_value : materialize();
+		}
+
+		T& operator*() {
+			return value();
+		}
+
+		const T& operator*() const {
+			return value();
+		}
+
+		T* operator->() {
+			return std::addressof(value());
+		}
+
+		const T* operator->() const {
+			return std::addressof(value());
+		}
+
+		/**
+		* @brief 値が構築済みであるかを調べる、構築はしない
+		* @detail Tが無効値を持つ型（invalid_value_traits）で、Factoryが無効値を返した場合は未構築として扱われる
+		*/
+		bool has_value() const noexcept {
+			return m_storage.has_value();
+		}
+
+		/**
+		* @brief 構築済みの値を破棄する、次のアクセスで再び構築される
+		*/
+		void reset() noexcept {
+			m_storage.reset();
+		}
+	};
+
+	/**
+	* @brief 最初にアクセスされた時に値を構築するoptional、スレッドセーフ版
+	* @detail 値の構築は1度だけ行われる（std::call_once）
+	* @detail 構築済みであれば、アクセスはacquireロード1つと分岐のみ（ミューテックスを使用しない）
+	* @tparam T 格納する要素型
+	* @tparam Factory 引数無しで呼び出し可能であり、Tを構築可能な値を返す関数オブジェクト型
+	*/
+	template<typename T, typename Factory = T(*)()>
+	class concurrent_lazy_optional {
+		static_assert(std::is_constructible<T, optional_traits::invoke_result_t<Factory&>>::value, "T shall be constructible from the result of Factory.");
+
+		mutable detail::optional_common_base<T> m_storage;
+		mutable Factory m_factory;
+		mutable std::atomic<bool> m_ready;
+		mutable std::once_flag m_once;
+
+		LSTL_NOINLINE_COLD T& materialize() const {
+			std::call_once(m_once, [this] {
+				m_storage.construct(m_factory());
+				m_ready.store(true, std::memory_order_release);
+			});
+			return m_storage.m_value;
+		}
+
+	public:
+
+		using value_type = T;
+		using factory_type = Factory;
+
+		/**
+		* @brief 値を構築する関数を受けて初期化、値はまだ構築しない
+		* @param factory 値を構築する関数
+		*/
+		explicit concurrent_lazy_optional(Factory factory) noexcept(std::is_nothrow_move_constructible<Factory>::value)
+			: m_storage{ nullopt }
+			, m_factory(std::move(factory))
+			, m_ready{ false }
+		{}
+
+		/**
+		* @brief ムーブコンストラクタ
+		* @detail 構築済みであれば値もムーブする、otherは他のスレッドから参照されていないこと
+		*/
+		concurrent_lazy_optional(concurrent_lazy_optional&& other) noexcept(std::conjunction<std::is_nothrow_move_constructible<T>, std::is_nothrow_move_constructible<Factory>>::value)
+			: m_storage{ nullopt }
+			, m_factory(std::move(other.m_factory))
+			, m_ready{ false }
+		{
+			if (other.m_ready.load(std::memory_order_acquire)) {
+				m_storage.construct(std::move(other.m_storage.m_value));
+				//once_flagはムーブできないので、構築済みのフラグだけを引き継ぐ
+				std::call_once(m_once, [] {});
+				m_ready.store(true, std::memory_order_release);
+			}
+		}
+
+		concurrent_lazy_optional(const concurrent_lazy_optional&) = delete;
+		concurrent_lazy_optional& operator=(const concurrent_lazy_optional&) = delete;
+		concurrent_lazy_optional& operator=(concurrent_lazy_optional&&) = delete;
+
+		/**
+		* @brief 値を取得する、構築されていなければ構築する
+		* @detail 複数のスレッドから同時に呼ばれた場合、1つのスレッドが構築し他のスレッドは完了を待つ
+		* @detail Factoryが例外を投げた場合は構築されず、次のアクセスで再び構築を試みる
+		* @return 構築済みの値への参照
+		*/
+		T& value() {
+			return (m_ready.load(std::memory_order_acquire)) ? m_storage.m_value : materialize();
+		}
+
+		/**
+		* @brief 値を取得する、構築されていなければ構築する
+		* @detail constなオブジェクトからは値を書き換えられない
+		*/
+		const T& value() const {
+			return (m_ready.load(std::memory_order_acquire)) ? m_storage.m_value : materialize();
+		}
+
+		T& operator*() {
+			return value();
+		}
+
+		const T& operator*() const {
+			return value();
+		}
+
+		T* operator->() {
+			return std::addressof(value());
+		}
+
+		const T* operator->() const {
+			return std::addressof(value());
+		}
+
+		/**
+		* @brief 値が構築済みであるかを調べる、構築はしない
+		*/
+		bool has_value() const noexcept {
+			return m_ready.load(std::memory_order_acquire);
+		}
+	};
+
+	/**
+	* @brief 関数の戻り値型からlazy_optionalを構築する
+	* @param factory 値を構築する関数
+	*/
+	template<typename F>
+	auto make_lazy_optional(F&& factory) -> lazy_optional<optional_traits::invoke_result_t<std::decay_t<F>&>, std::decay_t<F>> {
+		return lazy_optional<optional_traits::invoke_result_t<std::decay_t<F>&>, std::decay_t<F>>{ std::forward<F>(factory) };
+	}
+}
\ No newline at end of file
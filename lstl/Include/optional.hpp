@@ -2,6 +2,17 @@
 
 #include <type_traits>
 #include <exception>
+#include <utility>
+#include <memory>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <iterator>
+#include <cstring>
+
+#include "config.hpp"
+#include "invalid_value.hpp"
+#include "relocate.hpp"
 
 #pragma warning(push)
 //ユニコードの文字がShift-JISで分からないという警告抑止
@@ -20,10 +31,20 @@ namespace lstl {
 		explicit in_place_t() = default;
 	};
 
+	/**
+	* @brief 関数の戻り値から直接値を構築するためのタグ
+	* @detail 戻り値（prvalue）はコピー省略によって領域に直接構築される（中間のムーブが無い）
+	*/
+	struct in_place_invoke_t {
+		explicit in_place_invoke_t() = default;
+	};
+
 	constexpr nullopt_t nullopt{ nullptr };
 
 	constexpr in_place_t in_place{};
 
+	constexpr in_place_invoke_t in_place_invoke{};
+
 
 	class bad_optional_access : public std::exception {
 	public:
@@ -46,12 +67,12 @@ namespace lstl {
 
 		/**
 		* @brief U → T への変換がoptionalの文脈で受け入れ可能かを調べる
-		* @detail TがU&&で構築可能　かつ　Uがin_place_t　ではなく　Uはoptional<T>　でもない、場合にtrueとなる
+		* @detail TがU&&で構築可能　かつ　Uがin_place_t、in_place_invoke_t　ではなく　Uはoptional<T>　でもない、場合にtrueとなる
 		* @tparam T 変換先の型 
 		* @tparam U 変換元の型
 		*/
 		template<typename T, typename U>
-		using allow_conversion = std::conjunction<std::is_constructible<T, U&&>, std::negation<std::is_same<std::decay_t<U>, in_place_t>>, std::negation<std::is_same<optional<T>, std::decay_t<U>>>>;
+		struct allow_conversion : std::conjunction<std::is_constructible<T, U&&>, std::negation<std::is_same<std::decay_t<U>, in_place_t>>, std::negation<std::is_same<std::decay_t<U>, in_place_invoke_t>>, std::negation<std::is_same<optional<T>, std::decay_t<U>>>> {};
 
 		/**
 		* @brief optional<U> → optional<T> への変換がoptionalの文脈で受け入れ可能かを調べる
@@ -62,12 +83,12 @@ namespace lstl {
 		* @tparam U 変換元の型
 		*/
 		template<typename T, typename U>
-		using allow_unwrap = std::negation<
+		struct allow_unwrap : std::negation<
 			std::disjunction<
 				std::is_same<T, U>, std::is_constructible<T, optional<U>&>, std::is_constructible<T, optional<U>&&>, std::is_constructible<T, const optional<U>&>, std::is_constructible<T, const optional<U>&&>,
 				std::is_convertible<optional<U>&, T>, std::is_convertible<optional<U>&&, T>, std::is_convertible<const optional<U>&, T>, std::is_convertible<const optional<U>&&, T>
 			>
-		>;
+		> {};
 
 		/**
 		* @brief U → T への変換がoptionalへの代入の文脈で受け入れ可能かを調べる
@@ -76,7 +97,7 @@ namespace lstl {
 		* @tparam U 変換元の型
 		*/
 		template<typename T, typename U>
-		using allow_conversion_assign = std::conjunction<std::negation<std::is_same<optional<T>, std::decay_t<U>>>, std::negation<std::conjunction<std::is_scalar<T>, std::is_same<T, std::decay_t<U>>>>, std::is_constructible<T, U>, std::is_assignable<T&, U>>;
+		struct allow_conversion_assign : std::conjunction<std::negation<std::is_same<optional<T>, std::decay_t<U>>>, std::negation<std::conjunction<std::is_scalar<T>, std::is_same<T, std::decay_t<U>>>>, std::is_constructible<T, U>, std::is_assignable<T&, U>> {};
 
 		/**
 		* @brief optional<U> → optional<T> への変換がoptionalへの代入の文脈で受け入れ可能かを調べる
@@ -86,12 +107,12 @@ namespace lstl {
 		* @tparam U 変換元の型
 		*/
 		template<typename T, typename U>
-		using allow_unwrap_assign = std::conjunction<
+		struct allow_unwrap_assign : std::conjunction<
 			allow_unwrap<T, U>,
 			std::negation<
 				std::disjunction<std::is_assignable<T&, optional<U>&>, std::is_assignable<T&, optional<U>&&>, std::is_assignable<T&, const optional<U>&>, std::is_assignable<T&, const optional<U>&&>>
 			>
-		>;
+		> {};
 
 		namespace no_adl_swap_impl {
 			void swap();
@@ -109,11 +130,39 @@ namespace lstl {
 		* @tparam T 調べる型
 		*/
 		template<typename T>
-		using is_trivially_swappable = std::conjunction<std::is_trivially_destructible<T>, std::is_trivially_move_constructible<T>, std::is_trivially_move_assignable<T>, no_adl_swap_impl::no_adl_swap<T>>;
+		struct is_trivially_swappable : std::conjunction<std::is_trivially_destructible<T>, std::is_trivially_move_constructible<T>, std::is_trivially_move_assignable<T>, no_adl_swap_impl::no_adl_swap<T>> {};
 
 
 		template<typename F, typename... Args>
 		using invoke_result_t = std::decay_t<decltype(std::invoke(std::declval<F>(), std::declval<Args>()...))>;
+
+		namespace invoke_construct_impl {
+
+			template<typename T, typename Void, typename F, typename... Args>
+			struct is_invoke_constructible : std::false_type {};
+
+			template<typename T, typename F, typename... Args>
+			struct is_invoke_constructible<T, std::void_t<decltype(std::invoke(std::declval<F>(), std::declval<Args>()...))>, F, Args...>
+				: std::disjunction<std::is_same<std::remove_cv_t<T>, std::remove_cv_t<decltype(std::invoke(std::declval<F>(), std::declval<Args>()...))>>, std::is_constructible<T, decltype(std::invoke(std::declval<F>(), std::declval<Args>()...))>> {};
+		}
+
+		/**
+		* @brief F(Args...)の戻り値からTを構築可能かを調べる
+		* @detail 戻り値がTのprvalueであればコピー省略によって構築されるので、Tがムーブ可能である必要はない
+		* @tparam T 構築する型
+		* @tparam F 呼び出す関数の型
+		* @tparam Args Fに与える引数の型
+		*/
+		template<typename T, typename F, typename... Args>
+		using is_invoke_constructible = invoke_construct_impl::is_invoke_constructible<T, void, F, Args...>;
+
+		/**
+		* @brief invalid_value_traits<T>が特殊化されているかを調べる
+		* @detail invalid_value()とis_invalid(const T&)の両方が利用可能な場合にtrue
+		* @tparam T 調べる型
+		*/
+		template<typename T>
+		struct has_invalid_value : detail::has_invalid_value_of<invalid_value_traits<T>, T> {};
 	}
 
 #if defined(_MSC_VER) && _MSC_VER == 1900
@@ -149,14 +198,12 @@ namespace lstl {
 		*/
 		template<typename Base, typename T>
 		struct enable_copy_construct : public Base {
-			using Base::Base;
-
 			template<typename... Args>
 			constexpr enable_copy_construct(Args&&... args) noexcept(std::is_nothrow_constructible<Base, Args&&...>::value)
 				: Base{ std::forward<Args>(args)... }
 			{}
 
-			enable_copy_construct(const enable_copy_construct& other) : Base{ nullopt }
+			LSTL_CONSTEXPR20 enable_copy_construct(const enable_copy_construct& other) noexcept(std::is_nothrow_copy_constructible<T>::value) : Base{ nullopt }
 			{
 				Base::construct_from_other(static_cast<const Base&>(other));
 			}
@@ -183,8 +230,6 @@ namespace lstl {
 		template<typename Base, typename T>
 		struct enable_move_construct : public check_copy_construct<Base, T> {
 			using base_t = check_copy_construct<Base, T>;
-			using base_t::base_t;
-
 			template<typename... Args>
 			constexpr enable_move_construct(Args&&... args) noexcept(std::is_nothrow_constructible<base_t, Args&&...>::value)
 				: base_t{ std::forward<Args>(args)... }
@@ -192,7 +237,7 @@ namespace lstl {
 
 			enable_move_construct(const enable_move_construct&) = default;
 
-			enable_move_construct(enable_move_construct&& other) : base_t{ nullopt } 
+			LSTL_CONSTEXPR20 enable_move_construct(enable_move_construct&& other) noexcept(std::is_nothrow_move_constructible<T>::value) : base_t{ nullopt }
 			{
 				base_t::construct_from_other(static_cast<Base&&>(other));
 			}
@@ -218,8 +263,6 @@ namespace lstl {
 		template<typename Base, typename T, bool = std::is_copy_constructible <T>::value, bool = std::is_copy_assignable<T>::value>
 		struct enable_copy_assign : check_move_construct<Base, T> {
 			using base_t = check_move_construct<Base, T>;
-			using base_t::base_t;
-
 			template<typename... Args>
 			constexpr enable_copy_assign(Args&&... args) noexcept(std::is_nothrow_constructible<base_t, Args&&...>::value)
 				: base_t{ std::forward<Args>(args)... }
@@ -239,8 +282,6 @@ namespace lstl {
 		template<typename Base, typename T>
 		struct enable_copy_assign<Base, T, true, true> : check_move_construct<Base, T> {
 			using base_t = check_move_construct<Base, T>;
-			using base_t::base_t;
-
 			template<typename... Args>
 			constexpr enable_copy_assign(Args&&... args) noexcept(std::is_nothrow_constructible<base_t, Args&&...>::value)
 				: base_t{ std::forward<Args>(args)... }
@@ -248,7 +289,7 @@ namespace lstl {
 
 			enable_copy_assign(const enable_copy_assign&) = default;
 			enable_copy_assign(enable_copy_assign&&) = default;
-			enable_copy_assign& operator=(const enable_copy_assign& other) noexcept(std::conjunction<std::is_nothrow_copy_assignable<T>, std::is_nothrow_copy_constructible<T>>::value) {
+			LSTL_CONSTEXPR20 enable_copy_assign& operator=(const enable_copy_assign& other) noexcept(std::conjunction<std::is_nothrow_copy_assignable<T>, std::is_nothrow_copy_constructible<T>>::value) {
 				if (this != &other) {
 					base_t::assign_from_other(static_cast<const Base&>(other));
 				}
@@ -274,8 +315,6 @@ namespace lstl {
 		template<typename Base, typename T, bool = std::conjunction<std::is_move_constructible<T>, std::is_move_assignable<T>>::value>
 		struct enable_move_assign : public check_copy_assign<Base, T> {
 			using base_t = check_copy_assign<Base, T>;
-			using base_t::base_t;
-
 			template<typename... Args>
 			constexpr enable_move_assign(Args&&... args) noexcept(std::is_nothrow_constructible<base_t, Args&&...>::value)
 				: base_t{ std::forward<Args>(args)... }
@@ -294,8 +333,6 @@ namespace lstl {
 		template<typename Base, typename T>
 		struct enable_move_assign<Base, T, true> : public check_copy_assign<Base, T> {
 			using base_t = check_copy_assign<Base, T>;
-			using base_t::base_t;
-
 			template<typename... Args>
 			constexpr enable_move_assign(Args&&... args) noexcept(std::is_nothrow_constructible<base_t, Args&&...>::value)
 				: base_t{ std::forward<Args>(args)... }
@@ -305,7 +342,7 @@ namespace lstl {
 			enable_move_assign(enable_move_assign&&) = default;
 			enable_move_assign& operator=(const enable_move_assign&) = default;
 
-			enable_move_assign& operator=(enable_move_assign&& other) noexcept(std::conjunction<std::is_nothrow_move_assignable<T>, std::is_nothrow_move_constructible<T>>::value) {
+			LSTL_CONSTEXPR20 enable_move_assign& operator=(enable_move_assign&& other) noexcept(std::conjunction<std::is_nothrow_move_assignable<T>, std::is_nothrow_move_constructible<T>>::value) {
 				if (this != &other) {
 					base_t::assign_from_other(static_cast<Base&&>(other));
 				}
@@ -313,26 +350,264 @@ namespace lstl {
 			}
 		};
 
+		/**
+		* @brief 4つの特殊メンバ関数を全て定義する
+		* @detail Tのコピー/ムーブ構築が共に非トリビアルで、コピー/ムーブの構築・代入が全て可能な場合（std::string等、最も多い場合）
+		* @detail 層を重ねた場合と同じ定義を1つの層で行い、実体化するクラスを減らす
+		*/
+		template<typename Base, typename T>
+		struct enable_all_special_member_functions : public Base {
+
+			template<typename... Args>
+			constexpr enable_all_special_member_functions(Args&&... args) noexcept(std::is_nothrow_constructible<Base, Args&&...>::value)
+				: Base{ std::forward<Args>(args)... }
+			{}
+
+			LSTL_CONSTEXPR20 enable_all_special_member_functions(const enable_all_special_member_functions& other) noexcept(std::is_nothrow_copy_constructible<T>::value) : Base{ nullopt }
+			{
+				Base::construct_from_other(static_cast<const Base&>(other));
+			}
+
+			LSTL_CONSTEXPR20 enable_all_special_member_functions(enable_all_special_member_functions&& other) noexcept(std::is_nothrow_move_constructible<T>::value) : Base{ nullopt }
+			{
+				Base::construct_from_other(static_cast<Base&&>(other));
+			}
+
+			LSTL_CONSTEXPR20 enable_all_special_member_functions& operator=(const enable_all_special_member_functions& other) noexcept(std::conjunction<std::is_nothrow_copy_assignable<T>, std::is_nothrow_copy_constructible<T>>::value) {
+				if (this != &other) {
+					Base::assign_from_other(static_cast<const Base&>(other));
+				}
+				return *this;
+			}
+
+			LSTL_CONSTEXPR20 enable_all_special_member_functions& operator=(enable_all_special_member_functions&& other) noexcept(std::conjunction<std::is_nothrow_move_assignable<T>, std::is_nothrow_move_constructible<T>>::value) {
+				if (this != &other) {
+					Base::assign_from_other(static_cast<Base&&>(other));
+				}
+				return *this;
+			}
+		};
+
+		/**
+		* @brief 1つの層で全ての特殊メンバ関数を定義できるか
+		*/
+		template<typename T>
+		using is_all_special_member_functions_nontrivial = std::conjunction<
+			std::negation<std::is_trivially_copy_constructible<T>>,
+			std::negation<std::is_trivially_move_constructible<T>>,
+			std::is_copy_constructible<T>,
+			std::is_move_constructible<T>,
+			std::is_copy_assignable<T>,
+			std::is_move_assignable<T>
+		>;
+
+		/**
+		* @brief 層を経由せずにBaseの特殊メンバ関数をそのまま用いることができるか
+		* @detail trivially copyableであっても、constな型等の代入できない型は除く（代入演算子をdeleteする層が必要）
+		*/
+		template<typename T>
+		using is_trivially_copyable_and_assignable = std::conjunction<
+			std::is_trivially_copyable<T>,
+			std::is_copy_assignable<T>,
+			std::is_move_assignable<T>
+		>;
+
+#if LSTL_HAS_CONCEPTS
+
+		/**
+		* @brief 制約によって特殊メンバ関数を選択する
+		* @detail C++20以降では層を重ねる代わりに、各特殊メンバ関数の定義（default、非トリビアルな定義、delete）を制約で選択する
+		* @detail 選択される定義は層を重ねた場合と同じ
+		*/
+		template<typename Base, typename T>
+		struct constrained_special_member_functions : public Base {
+			using Base::Base;
+
+			constrained_special_member_functions(const constrained_special_member_functions&) requires (!(std::is_copy_constructible_v<T> && !std::is_trivially_copy_constructible_v<T>)) = default;
+
+			LSTL_CONSTEXPR20 constrained_special_member_functions(const constrained_special_member_functions& other) noexcept(std::is_nothrow_copy_constructible_v<T>)
+				requires (std::is_copy_constructible_v<T> && !std::is_trivially_copy_constructible_v<T>)
+				: Base{ nullopt }
+			{
+				Base::construct_from_other(static_cast<const Base&>(other));
+			}
+
+			constrained_special_member_functions(constrained_special_member_functions&&) requires (!(std::is_move_constructible_v<T> && !std::is_trivially_move_constructible_v<T>)) = default;
+
+			LSTL_CONSTEXPR20 constrained_special_member_functions(constrained_special_member_functions&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+				requires (std::is_move_constructible_v<T> && !std::is_trivially_move_constructible_v<T>)
+				: Base{ nullopt }
+			{
+				Base::construct_from_other(static_cast<Base&&>(other));
+			}
+
+			constrained_special_member_functions& operator=(const constrained_special_member_functions&)
+				requires (std::is_trivially_destructible_v<T> && std::is_trivially_copy_constructible_v<T> && std::is_trivially_copy_assignable_v<T>) = default;
+
+			LSTL_CONSTEXPR20 constrained_special_member_functions& operator=(const constrained_special_member_functions& other) noexcept(std::is_nothrow_copy_assignable_v<T> && std::is_nothrow_copy_constructible_v<T>)
+				requires (!(std::is_trivially_destructible_v<T> && std::is_trivially_copy_constructible_v<T> && std::is_trivially_copy_assignable_v<T>) && std::is_copy_constructible_v<T> && std::is_copy_assignable_v<T>)
+			{
+				if (this != &other) {
+					Base::assign_from_other(static_cast<const Base&>(other));
+				}
+				return *this;
+			}
+
+			constrained_special_member_functions& operator=(const constrained_special_member_functions&)
+				requires (!(std::is_trivially_destructible_v<T> && std::is_trivially_copy_constructible_v<T> && std::is_trivially_copy_assignable_v<T>) && !(std::is_copy_constructible_v<T> && std::is_copy_assignable_v<T>)) = delete;
+
+			constrained_special_member_functions& operator=(constrained_special_member_functions&&)
+				requires (std::is_trivially_destructible_v<T> && std::is_trivially_move_constructible_v<T> && std::is_trivially_move_assignable_v<T>) = default;
+
+			LSTL_CONSTEXPR20 constrained_special_member_functions& operator=(constrained_special_member_functions&& other) noexcept(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_move_constructible_v<T>)
+				requires (!(std::is_trivially_destructible_v<T> && std::is_trivially_move_constructible_v<T> && std::is_trivially_move_assignable_v<T>) && std::is_move_constructible_v<T> && std::is_move_assignable_v<T>)
+			{
+				if (this != &other) {
+					Base::assign_from_other(static_cast<Base&&>(other));
+				}
+				return *this;
+			}
+
+			constrained_special_member_functions& operator=(constrained_special_member_functions&&)
+				requires (!(std::is_trivially_destructible_v<T> && std::is_trivially_move_constructible_v<T> && std::is_trivially_move_assignable_v<T>) && !(std::is_move_constructible_v<T> && std::is_move_assignable_v<T>)) = delete;
+		};
+
+		/**
+		* @brief trivially copyableだが代入できないTのための層
+		* @detail 代入演算子をdefaultかdeleteかのどちらかだけで選択する
+		* @detail 制約を満たさない非トリビアルな代入演算子が宣言されているだけでtrivially copyableでなくなる処理系があるため、constrained_special_member_functionsとは分ける
+		*/
+		template<typename Base, typename T>
+		struct trivially_copyable_special_member_functions : public Base {
+			using Base::Base;
+
+			trivially_copyable_special_member_functions(const trivially_copyable_special_member_functions&) = default;
+			trivially_copyable_special_member_functions(trivially_copyable_special_member_functions&&) = default;
+
+			trivially_copyable_special_member_functions& operator=(const trivially_copyable_special_member_functions&) requires std::is_copy_assignable_v<T> = default;
+			trivially_copyable_special_member_functions& operator=(const trivially_copyable_special_member_functions&) requires (!std::is_copy_assignable_v<T>) = delete;
+
+			trivially_copyable_special_member_functions& operator=(trivially_copyable_special_member_functions&&) requires std::is_move_assignable_v<T> = default;
+			trivially_copyable_special_member_functions& operator=(trivially_copyable_special_member_functions&&) requires (!std::is_move_assignable_v<T>) = delete;
+		};
+
+		/**
+		* @brief optional<T>の特殊メンバ関数を有効化する（デストラクタ以外）
+		* @detail Tがtrivially copyableかつ代入可能ならば、Baseを直接用いる
+		* @detail これによりoptional<T>もtrivially copyableとなることを保証する（レジスタ渡し・memcpyが可能）
+		*/
+		template<typename Base, typename T>
+		using enable_special_menber_functions = std::conditional_t<
+			is_trivially_copyable_and_assignable<T>::value,
+			Base,
+			std::conditional_t<
+				std::is_trivially_copyable<T>::value,
+				trivially_copyable_special_member_functions<Base, T>,
+				constrained_special_member_functions<Base, T>
+			>
+		>;
+
+#else
+
 		/**
 		* @brief optional<T>の特殊メンバ関数を有効化する（デストラクタ以外）
 		* @detail 下から上へあがっていきます
+		* @detail Tがtrivially copyableかつ代入可能ならば、層を経由せずBaseを直接用いる
+		* @detail これによりoptional<T>もtrivially copyableとなることを保証する（レジスタ渡し・memcpyが可能）
+		* @detail 全ての特殊メンバ関数が非トリビアルな場合は、1つの層で定義する
 		*/
 		template<typename Base, typename T>
 		using enable_special_menber_functions = std::conditional_t<
-			std::conjunction<std::is_trivially_destructible<T>, std::is_trivially_move_constructible<T>, std::is_trivially_move_assignable<T>>::value,
-			check_copy_assign<Base, T>,
-			enable_move_assign<Base, T>
+			is_trivially_copyable_and_assignable<T>::value,
+			Base,
+			std::conditional_t<
+				is_all_special_member_functions_nontrivial<T>::value,
+				enable_all_special_member_functions<Base, T>,
+				std::conditional_t<
+					std::conjunction<std::is_trivially_destructible<T>, std::is_trivially_move_constructible<T>, std::is_trivially_move_assignable<T>>::value,
+					check_copy_assign<Base, T>,
+					enable_move_assign<Base, T>
+				>
+			>
 		>;
+
+#endif // LSTL_HAS_CONCEPTS
 	}
 
 	namespace detail {
 
+		/**
+		* @brief 未初期化領域にオブジェクトを構築する
+		* @detail optionalとその派生コンテナが共通して用いる構築処理
+		* @param p 構築する領域
+		* @param args Tのコンストラクタ引数
+		* @return 構築したオブジェクトへの参照
+		*/
+		template<typename T, typename... Args>
+		LSTL_CONSTEXPR20 auto construct_at(T* p, Args&&... args) noexcept(std::is_nothrow_constructible<T, Args&&...>::value) -> T& {
+#if LSTL_HAS_CONSTEXPR20
+			//定数評価中でも利用可能
+			return *std::construct_at(p, std::forward<Args>(args)...);
+#else
+			//placement new
+			return *::new (const_cast<void*>(static_cast<const volatile void*>(p))) T(std::forward<Args>(args)...);
+#endif // LSTL_HAS_CONSTEXPR20
+		}
+
+		/**
+		* @brief 未初期化領域に関数の戻り値からオブジェクトを構築する
+		* @detail 戻り値がTのprvalueならばコピー省略により直接構築される
+		* @param p 構築する領域
+		* @param f 呼び出す関数
+		* @param args fに与える引数
+		* @return 構築したオブジェクトへの参照
+		*/
+		template<typename T, typename F, typename... Args>
+		auto invoke_construct_at(std::false_type, T* p, F&& f, Args&&... args) -> T& {
+			return *::new (const_cast<void*>(static_cast<const volatile void*>(p))) T(std::invoke(std::forward<F>(f), std::forward<Args>(args)...));
+		}
+
+#if LSTL_HAS_CONSTEXPR20
+
+		/**
+		* @brief 未初期化領域に関数の戻り値からオブジェクトを構築する（ムーブ可能な型）
+		* @detail 定数評価中はplacement newが使えないので、戻り値をムーブして構築する
+		*/
+		template<typename T, typename F, typename... Args>
+		constexpr auto invoke_construct_at(std::true_type, T* p, F&& f, Args&&... args) -> T& {
+			if (std::is_constant_evaluated()) {
+				return *std::construct_at(p, std::invoke(std::forward<F>(f), std::forward<Args>(args)...));
+			}
+			return invoke_construct_at(std::false_type{}, p, std::forward<F>(f), std::forward<Args>(args)...);
+		}
+
+#endif // LSTL_HAS_CONSTEXPR20
+
+		template<typename T, typename F, typename... Args>
+		LSTL_CONSTEXPR20 auto invoke_construct_at(T* p, F&& f, Args&&... args) -> T& {
+#if LSTL_HAS_CONSTEXPR20
+			return invoke_construct_at(std::is_move_constructible<T>{}, p, std::forward<F>(f), std::forward<Args>(args)...);
+#else
+			return invoke_construct_at(std::false_type{}, p, std::forward<F>(f), std::forward<Args>(args)...);
+#endif // LSTL_HAS_CONSTEXPR20
+		}
+
+		/**
+		* @brief オブジェクトを破棄する
+		* @detail trivially destructibleな型に対しては何もしない
+		* @param p 破棄するオブジェクト
+		*/
+		template<typename T>
+		LSTL_CONSTEXPR20 void destroy_at(T* p) noexcept {
+			p->~T();
+		}
+
 		/**
 		* @brief std::optionalの実装のためのストレージ領域
 		* @detail trivially_destructibleでない型のための処理を提供
 		* @tparam T 格納する要素型
 		*/
-		template<typename T, bool = std::is_trivially_destructible<T>::value>
+		template<typename T, bool = std::is_trivially_destructible<T>::value, bool = optional_traits::has_invalid_value<std::remove_const_t<T>>::value>
 		struct optional_storage {
 			using hold_type = std::remove_const_t<T>;
 
@@ -354,13 +629,20 @@ namespace lstl {
 				, m_has_value{ true }
 			{}
 
+			template<typename F, typename... Args>
+			constexpr optional_storage(in_place_invoke_t, F&& f, Args&&... args)
+				: m_value(std::invoke(std::forward<F>(f), std::forward<Args>(args)...))
+				, m_has_value{ true }
+			{}
+
 			/**
 			* @brief デストラクタ
 			* @detail nothrow_destructibleな型を前提とするのでnoexcept
+			* @detail C++20以降ではconstexpr
 			*/
-			~optional_storage() noexcept {
+			LSTL_CONSTEXPR20 ~optional_storage() noexcept {
 				if (m_has_value == true) {
-					m_value.~hold_type();
+					detail::destroy_at(std::addressof(m_value));
 				}
 			}
 
@@ -370,13 +652,27 @@ namespace lstl {
 			optional_storage& operator=(const optional_storage&) = default;
 			optional_storage& operator=(optional_storage&&) = default;
 
+			/**
+			* @brief 有効値を保持しているかを返す
+			*/
+			constexpr bool has_value() const noexcept {
+				return m_has_value;
+			}
+
+			/**
+			* @brief 領域に値を構築した直後に呼び出し、有効値保持状態にする
+			*/
+			LSTL_CONSTEXPR20 void set_has_value() noexcept {
+				m_has_value = true;
+			}
+
 			/**
 			* @brief optionalを無効値保持状態にする
 			* @detail 保持する値を破棄し、has_value() == false となる
 			*/
-			void reset() noexcept {
+			LSTL_CONSTEXPR20 void reset() noexcept {
 				if (m_has_value == true) {
-					m_value.~hold_type();
+					detail::destroy_at(std::addressof(m_value));
 					m_has_value = false;
 				}
 			}
@@ -388,7 +684,7 @@ namespace lstl {
 		* @tparam T 格納する要素型
 		*/
 		template<typename T>
-		struct optional_storage<T, true> {
+		struct optional_storage<T, true, false> {
 			using hold_type = std::remove_const_t<T>;
 
 			union {
@@ -398,28 +694,113 @@ namespace lstl {
 
 			bool m_has_value = false;
 
+			/**
+			* @brief 無効値保持状態で構築する
+			* @detail 整数型の場合はm_valueを値初期化しておき、無効値保持状態でも常にm_valueが生存しているようにする
+			* @detail reset()は値を破棄しないので、以降も読むことができる（order_key()が分岐せずに値を読むため）
+			*/
 			constexpr optional_storage(nullopt_t) noexcept
+				: optional_storage(nullopt, std::integral_constant<bool, std::is_integral<hold_type>::value>{})
+			{}
+
+			constexpr optional_storage(nullopt_t, std::false_type) noexcept
 				: m_dummy{}
 				, m_has_value{ false }
 			{}
 
+			constexpr optional_storage(nullopt_t, std::true_type) noexcept
+				: m_value{}
+				, m_has_value{ false }
+			{}
+
 			template<typename... Args>
 			constexpr optional_storage(Args&&... args) noexcept(std::is_nothrow_constructible<hold_type, Args&&...>::value)
 				: m_value(std::forward<Args>(args)...)
 				, m_has_value{ true }
 			{}
 
+			template<typename F, typename... Args>
+			constexpr optional_storage(in_place_invoke_t, F&& f, Args&&... args)
+				: m_value(std::invoke(std::forward<F>(f), std::forward<Args>(args)...))
+				, m_has_value{ true }
+			{}
+
+			/**
+			* @brief 有効値を保持しているかを返す
+			*/
+			constexpr bool has_value() const noexcept {
+				return m_has_value;
+			}
+
+			/**
+			* @brief 領域に値を構築した直後に呼び出し、有効値保持状態にする
+			*/
+			LSTL_CONSTEXPR20 void set_has_value() noexcept {
+				m_has_value = true;
+			}
+
 			/**
 			* @brief optionalを無効値保持状態にする
 			* @detail has_value() == false となる
 			*/
-			void reset() noexcept {
+			LSTL_CONSTEXPR20 void reset() noexcept {
 				m_has_value = false;
 				//trivially destructibleな型はデストラクタ呼び出しの必要がない
 				//領域はこのoptionalオブジェクトの寿命終了とともに解放される
 			}
 		};
 
+		/**
+		* @brief std::optionalの実装のためのストレージ領域
+		* @detail invalid_value_traits<T>の特殊化された型のための処理を提供
+		* @detail 有効値フラグを持たず、無効値を格納することで無効状態を表す
+		* @tparam T 格納する要素型
+		*/
+		template<typename T>
+		struct optional_storage<T, true, true> {
+			using hold_type = std::remove_const_t<T>;
+			using traits = invalid_value_traits<hold_type>;
+
+			//常に何らかの値（無効値を含む）が生存しているので、unionにする必要がない
+			hold_type m_value;
+
+			constexpr optional_storage(nullopt_t) noexcept
+				: m_value(traits::invalid_value())
+			{}
+
+			template<typename... Args>
+			constexpr optional_storage(Args&&... args) noexcept(std::is_nothrow_constructible<hold_type, Args&&...>::value)
+				: m_value(std::forward<Args>(args)...)
+			{}
+
+			template<typename F, typename... Args>
+			constexpr optional_storage(in_place_invoke_t, F&& f, Args&&... args)
+				: m_value(std::invoke(std::forward<F>(f), std::forward<Args>(args)...))
+			{}
+
+			/**
+			* @brief 有効値を保持しているかを返す
+			* @detail 格納している値が無効値でなければtrue
+			*/
+			constexpr bool has_value() const noexcept {
+				return !traits::is_invalid(m_value);
+			}
+
+			/**
+			* @brief 領域に値を構築した直後に呼び出す
+			* @detail 値そのものが状態を表すので何もしない
+			*/
+			LSTL_CONSTEXPR20 void set_has_value() noexcept {}
+
+			/**
+			* @brief optionalを無効値保持状態にする
+			* @detail 無効値を書き込み、has_value() == false となる
+			*/
+			LSTL_CONSTEXPR20 void reset() noexcept {
+				m_value = traits::invalid_value();
+			}
+		};
+
 		/**
 		* @brief std::optionalの実装のための土台
 		* @detail 共通の構築・代入に関わる処理を提供する
@@ -428,6 +809,7 @@ namespace lstl {
 		template<typename T>
 		struct optional_common_base : optional_storage<T> {
 			using optional_storage<T>::optional_storage;
+			using typename optional_storage<T>::hold_type;
 
 			template<typename... Args>
 			constexpr optional_common_base(Args&&... args) noexcept(std::is_nothrow_constructible<optional_storage<T>, Args&&...>::value)
@@ -436,25 +818,37 @@ namespace lstl {
 
 			/**
 			* @brief 領域の遅延初期化
-			* @detail 事前条件として、m_has_value == falseであること（呼び出し側で保証する）
+			* @detail 事前条件として、has_value() == falseであること（呼び出し側で保証する）
 			* @return 初期化したオブジェクトへの参照
 			*/
 			template<typename... Args>
-			auto construct(Args&&... args) noexcept(std::is_nothrow_constructible<hold_type, Args&&...>::value) -> hold_type& {
-				//placement new
-				::new (const_cast<void*>(static_cast<const volatile void*>(std::addressof(m_value)))) hold_type(std::forward<Args>(args)...);
+			LSTL_CONSTEXPR20 auto construct(Args&&... args) noexcept(std::is_nothrow_constructible<hold_type, Args&&...>::value) -> hold_type& {
+				detail::construct_at(std::addressof(this->m_value), std::forward<Args>(args)...);
 
-				m_has_value = true;
-				return m_value;
+				this->set_has_value();
+				return this->m_value;
+			}
+
+			/**
+			* @brief 関数の戻り値による領域の遅延初期化
+			* @detail 事前条件として、has_value() == falseであること（呼び出し側で保証する）
+			* @return 初期化したオブジェクトへの参照
+			*/
+			template<typename F, typename... Args>
+			LSTL_CONSTEXPR20 auto construct_with(F&& f, Args&&... args) -> hold_type& {
+				detail::invoke_construct_at(std::addressof(this->m_value), std::forward<F>(f), std::forward<Args>(args)...);
+
+				this->set_has_value();
+				return this->m_value;
 			}
 
 			/**
 			* @brief 他optional<T>の値からのコピー/ムーブ代入
-			* @detail 事前条件として、m_has_value == falseであること（呼び出し側で保証する）
+			* @detail 事前条件として、has_value() == falseであること（呼び出し側で保証する）
 			*/
 			template<typename U>
-			void assign(U&& rhs) {
-				if (this->m_has_value) {
+			LSTL_CONSTEXPR20 void assign(U&& rhs) {
+				if (this->has_value()) {
 					this->m_value = std::forward<U>(rhs);
 				}
 				else {
@@ -464,11 +858,11 @@ namespace lstl {
 
 			/**
 			* @brief 他optional<T>からのコピー/ムーブ構築
-			* @detail 事前条件として、m_has_value == falseであること（呼び出し側で保証する）
+			* @detail 事前条件として、has_value() == falseであること（呼び出し側で保証する）
 			*/
 			template<typename Optional>
-			void construct_from_other(Optional&& that) {
-				if (that.m_has_value) {
+			LSTL_CONSTEXPR20 void construct_from_other(Optional&& that) {
+				if (that.has_value()) {
 					construct(std::forward<Optional>(that).m_value);
 				}
 			}
@@ -477,8 +871,8 @@ namespace lstl {
 			* @brief 他optional<T>からのコピー/ムーブ代入
 			*/
 			template<typename Optional>
-			void assign_from_other(Optional&& that) {
-				if (that.m_has_value) {
+			LSTL_CONSTEXPR20 void assign_from_other(Optional&& that) {
+				if (that.has_value()) {
 					assign(std::forward<Optional>(that).m_value);
 				}
 				else {
@@ -490,34 +884,59 @@ namespace lstl {
 			* @brief swap実装、ストレージごと入れ替える
 			*/
 			template<typename U=T, optional_traits::enabler<optional_traits::is_trivially_swappable<U>> = nullptr>
-			void swap_impl(optional_common_base<U>& rhs) {
+			LSTL_CONSTEXPR20 void swap_impl(optional_common_base<U>& rhs) {
 				using storage = optional_storage<T>;
 
 				//どちらか片方が有効値を保持している場合に入れ替え
-				if (m_has_value || rhs.m_has_value) {
+				if (this->has_value() || rhs.has_value()) {
 					std::swap(static_cast<storage&>(*this), static_cast<storage&>(rhs));
 				}
 			}
 
 			/**
-			* @brief swap実装、きちんとswap
+			* @brief swap実装、片方のみが有効値を保持する場合はストレージのバイト列を入れ替える
+			* @detail Tがtrivially relocatableであれば、ムーブ構築と破棄の組はバイト列のコピーと等価
 			*/
-			template<typename U, optional_traits::enabler<std::negation<optional_traits::is_trivially_swappable<U>>> = nullptr>
+			template<typename U, optional_traits::enabler<std::negation<optional_traits::is_trivially_swappable<U>>, is_trivially_relocatable<U>> = nullptr>
 			void swap_impl(optional_common_base<U>& rhs) {
 				using std::swap;
+				using storage = optional_storage<T>;
+
+				if (this->has_value() && rhs.has_value()) {
+					//両方有効値を保持している
+					swap(this->m_value, rhs.m_value);
+				}
+				else {
+					//有効値の有無ごと入れ替える
+					alignas(storage) unsigned char tmp[sizeof(storage)];
+					void* const lhs_p = static_cast<storage*>(this);
+					void* const rhs_p = static_cast<storage*>(&rhs);
+
+					std::memcpy(tmp, lhs_p, sizeof(storage));
+					std::memcpy(lhs_p, rhs_p, sizeof(storage));
+					std::memcpy(rhs_p, tmp, sizeof(storage));
+				}
+			}
 
-				if (m_has_value) {
-					if (rhs.m_has_value) {
+			/**
+			* @brief swap実装、きちんとswap
+			*/
+			template<typename U, optional_traits::enabler<std::negation<optional_traits::is_trivially_swappable<U>>, std::negation<is_trivially_relocatable<U>>> = nullptr>
+			LSTL_CONSTEXPR20 void swap_impl(optional_common_base<U>& rhs) {
+				using std::swap;
+
+				if (this->has_value()) {
+					if (rhs.has_value()) {
 						//両方有効値を保持している
-						swap(m_value, rhs.m_value);
+						swap(this->m_value, rhs.m_value);
 					}
 					else {
 						//rhsが有効値を保持していない
-						rhs.construct(std::move(m_value));
-						reset();
+						rhs.construct(std::move(this->m_value));
+						this->reset();
 					}
 				}
-				else if (rhs.m_has_value) {
+				else if (rhs.has_value()) {
 					//*thisが有効値を保持しない
 					construct(std::move(rhs.m_value));
 					rhs.reset();
@@ -537,9 +956,33 @@ namespace lstl {
 		
 		using base_storage = detail::enable_special_menber_functions<detail::optional_common_base<T>, T>;
 
+		/**
+		* @brief or_elseの関数の戻り値の種類
+		* @detail 0 : void、1 : optional<T>、2 : Tを構築可能な値
+		*/
+		template<typename F>
+		using alternative_kind = std::integral_constant<int, std::is_void<decltype(std::invoke(std::declval<F>()))>::value ? 0 : std::is_same<optional_traits::invoke_result_t<F>, optional>::value ? 1 : 2>;
+
+		template<typename F>
+		static constexpr optional invoke_alternative(F&& func, std::integral_constant<int, 0>) {
+			return std::invoke(std::forward<F>(func)), optional{};
+		}
+
+		template<typename F>
+		static constexpr optional invoke_alternative(F&& func, std::integral_constant<int, 1>) {
+			return std::invoke(std::forward<F>(func));
+		}
+
+		//Tの値を返す関数の場合、戻り値から直接構築する
+		template<typename F>
+		static constexpr optional invoke_alternative(F&& func, std::integral_constant<int, 2>) {
+			return optional{ in_place_invoke, std::forward<F>(func) };
+		}
+
 	public:
 		
 		static_assert(std::conjunction<std::is_object<T>, std::is_nothrow_destructible<T>>::value, "T shall be an object type and shall satisfy the requirements of Destructible. (N4659 23.6.3 [optional.optional]/3)");
+		static_assert(std::disjunction<std::negation<optional_traits::has_invalid_value<std::remove_const_t<T>>>, std::is_trivially_copyable<T>>::value, "invalid_value_traits<T> can be specialized only for trivially copyable types.");
 		
 		using value_type = T;
 
@@ -558,12 +1001,14 @@ namespace lstl {
 		/**
 		* @brief コピーコンストラクタ
 		* @detail Tがtrivially destructibleであればconstexprかつnoexcept
+		* @detail noexceptはTのコピーコンストラクタに従う
 		*/
 		optional(const optional&) = default;
 
 		/**
 		* @brief ムーブコンストラクタ
 		* @detail Tがtrivially destructibleであればconstexprかつnoexcept
+		* @detail noexceptはTのムーブコンストラクタに従う（std::vectorの再確保時にムーブが選択される）
 		*/
 		optional(optional&&) = default;
 
@@ -575,6 +1020,16 @@ namespace lstl {
 		constexpr explicit optional(in_place_t, Args&&... args) : base_storage{ std::forward<Args>(args)... }
 		{}
 
+		/**
+		* @brief 関数の戻り値で直接構築する
+		* @detail 戻り値がTのprvalueならばコピー省略によって直接構築される（ムーブ不可能なTでも構築できる）
+		* @param func 呼び出すINVOKE可能な関数
+		* @param args funcに与える引数
+		*/
+		template<typename F, typename... Args, optional_traits::enabler<optional_traits::is_invoke_constructible<T, F&&, Args&&...>> = nullptr>
+		constexpr explicit optional(in_place_invoke_t, F&& func, Args&&... args) : base_storage{ in_place_invoke, std::forward<F>(func), std::forward<Args>(args)... }
+		{}
+
 		/**
 		* @brief Tのコンストラクタ引数を受けて直接構築
 		* @detail 主に、STLコンテナ等の持つアロケータを受け取るコンストラクタを呼び出すためのもの
@@ -611,9 +1066,11 @@ namespace lstl {
 		* @param rhs Tに変換可能なUをもつoptional
 		*/
 		template<typename U, optional_traits::enabler<optional_traits::allow_unwrap<T, U>, std::is_constructible<T, const U&>, std::is_convertible<const U&&, T>> = nullptr>
-		optional(const optional<U>& rhs) noexcept(noexcept(construct(*rhs))) {
+		LSTL_CONSTEXPR20 optional(const optional<U>& rhs) noexcept(noexcept(this->construct(*rhs)))
+			: base_storage{ nullopt }
+		{
 			if (rhs) {
-				construct(*rhs);
+				this->construct(*rhs);
 			}
 		}
 
@@ -623,9 +1080,11 @@ namespace lstl {
 		* @param rhs Tに変換可能なUをもつoptional
 		*/
 		template<typename U, optional_traits::enabler<optional_traits::allow_unwrap<T, U>, std::is_constructible<T, const U&>, std::negation<std::is_convertible<const U&&, T>>> = nullptr>
-		explicit optional(const optional<U>& rhs) noexcept(noexcept(construct(*rhs))) {
+		LSTL_CONSTEXPR20 explicit optional(const optional<U>& rhs) noexcept(noexcept(this->construct(*rhs)))
+			: base_storage{ nullopt }
+		{
 			if (rhs) {
-				construct(*rhs);
+				this->construct(*rhs);
 			}
 		}
 
@@ -635,9 +1094,11 @@ namespace lstl {
 		* @param rhs Tに変換可能なUをもつoptional
 		*/
 		template<typename U, optional_traits::enabler<optional_traits::allow_unwrap<T, U>, std::is_constructible<T, U&&>, std::is_convertible<U&&, T>> = nullptr>
-		optional(optional<U>&& rhs) noexcept(noexcept(construct(std::move(*rhs)))) {
+		LSTL_CONSTEXPR20 optional(optional<U>&& rhs) noexcept(noexcept(this->construct(std::move(*rhs))))
+			: base_storage{ nullopt }
+		{
 			if (rhs) {
-				construct(std::move(*rhs));
+				this->construct(std::move(*rhs));
 			}
 		}
 
@@ -647,9 +1108,11 @@ namespace lstl {
 		* @param rhs Tに変換可能なUをもつoptional
 		*/
 		template<typename U, optional_traits::enabler<optional_traits::allow_unwrap<T, U>, std::is_constructible<T, U&&>, std::negation<std::is_convertible<U&&, T>>> = nullptr>
-		explicit optional(optional<U>&& rhs) noexcept(noexcept(construct(std::move(*rhs)))) {
+		LSTL_CONSTEXPR20 explicit optional(optional<U>&& rhs) noexcept(noexcept(this->construct(std::move(*rhs))))
+			: base_storage{ nullopt }
+		{
 			if (rhs) {
-				construct(std::move(*rhs));
+				this->construct(std::move(*rhs));
 			}
 		}
 
@@ -658,7 +1121,7 @@ namespace lstl {
 		* @detail 保持する値を開放する
 		* @return *this
 		*/
-		optional& operator=(nullopt_t) noexcept {
+		LSTL_CONSTEXPR20 optional& operator=(nullopt_t) noexcept {
 			this->reset();
 			return *this;
 		}
@@ -682,8 +1145,8 @@ namespace lstl {
 		* @return *this
 		*/
 		template<typename U = T, optional_traits::enabler<optional_traits::allow_conversion_assign<T, U>> = nullptr>
-		optional& operator=(U&& v) {
-			assign(std::forward<U>(v));
+		LSTL_CONSTEXPR20 optional& operator=(U&& v) {
+			this->assign(std::forward<U>(v));
 			return *this;
 		}
 
@@ -692,12 +1155,12 @@ namespace lstl {
 		* @return *this
 		*/
 		template<typename U, optional_traits::enabler<optional_traits::allow_unwrap_assign<T, U>, std::is_constructible<T, const U&>, std::is_assignable<T&, const U&>> = nullptr>
-		optional& operator=(const optional<U>& rhs) {
+		LSTL_CONSTEXPR20 optional& operator=(const optional<U>& rhs) {
 			if (rhs) {
-				assign(*rhs);
+				this->assign(*rhs);
 			}
 			else {
-				reset();
+				this->reset();
 			}
 
 			return *this;
@@ -708,12 +1171,12 @@ namespace lstl {
 		* @return *this
 		*/
 		template<typename U, optional_traits::enabler<optional_traits::allow_unwrap_assign<T, U>, std::is_constructible<T, U>, std::is_assignable<T&, U>> = nullptr>
-		optional& operator=(optional<U>&& rhs) {
+		LSTL_CONSTEXPR20 optional& operator=(optional<U>&& rhs) {
 			if (rhs) {
-				assign(std::move(*rhs));
+				this->assign(std::move(*rhs));
 			}
 			else {
-				reset();
+				this->reset();
 			}
 
 
@@ -726,9 +1189,9 @@ namespace lstl {
 		* @return 構築した要素への参照
 		*/
 		template<typename... Args>
-		T& emplace(Args&&... args) {
-			reset();
-			return construct(std::forward<Args>(args)...);
+		LSTL_CONSTEXPR20 T& emplace(Args&&... args) {
+			this->reset();
+			return this->construct(std::forward<Args>(args)...);
 		}
 
 		/**
@@ -739,9 +1202,22 @@ namespace lstl {
 		* @return 構築した要素への参照
 		*/
 		template<typename U, typename... Args, optional_traits::enabler<std::is_constructible<T, std::initializer_list<U>&, Args&&...>> = nullptr>
-		T& emplace(std::initializer_list<U> il, Args&&... args) {
-			reset();
-			return construct(il, std::forward<Args>(args)...);
+		LSTL_CONSTEXPR20 T& emplace(std::initializer_list<U> il, Args&&... args) {
+			this->reset();
+			return this->construct(il, std::forward<Args>(args)...);
+		}
+
+		/**
+		* @brief 関数の戻り値から直接構築する。
+		* @detail 戻り値がTのprvalueならばコピー省略によって直接構築され、Tのムーブは行われない
+		* @param func 呼び出すINVOKE可能な関数
+		* @param args funcに与える引数
+		* @return 構築した要素への参照
+		*/
+		template<typename F, typename... Args, optional_traits::enabler<optional_traits::is_invoke_constructible<T, F&&, Args&&...>> = nullptr>
+		LSTL_CONSTEXPR20 T& emplace_with(F&& func, Args&&... args) {
+			this->reset();
+			return this->construct_with(std::forward<F>(func), std::forward<Args>(args)...);
 		}
 
 		/**
@@ -751,9 +1227,9 @@ namespace lstl {
 		* @param rhs swapするoptional
 		*/
 		template<typename U = T, optional_traits::enabler<std::is_same<T, U>, std::is_move_constructible<T>, is_swappable<T>> = nullptr>
-		void swap(optional<U>& rhs) noexcept(std::conjunction<std::is_nothrow_move_constructible<T>, is_nothrow_swappable<T>>::value) {
+		LSTL_CONSTEXPR20 void swap(optional<U>& rhs) noexcept(std::conjunction<std::is_nothrow_move_constructible<T>, is_nothrow_swappable<T>>::value) {
 			//効率的なswapを選択するために、base_storageへ投げる
-			swap_impl(rhs);
+			this->swap_impl(rhs);
 		}
 
 		/**
@@ -763,10 +1239,12 @@ namespace lstl {
 		* @return 有効値を保持する場合、f(this->value())の戻り値をoptionalで包んで返す、そうでないならnullopt
 		*/
 		template<typename F>
-		auto transform(F&& func) & noexcept(noexcept(func(m_value))) -> optional_traits::invoke_result_t<F, T> {
-			return (m_has_value == false)
-				? (nullopt)
-				: (func(m_value));
+		LSTL_CONSTEXPR20 auto transform(F&& func) & noexcept(noexcept(func(this->m_value))) -> optional<optional_traits::invoke_result_t<F, T&>> {
+			using result_type = optional<optional_traits::invoke_result_t<F, T&>>;
+
+			return (this->has_value() == false)
+				? result_type{}
+				: result_type{ in_place_invoke, std::forward<F>(func), this->m_value };
 		}
 
 		/**
@@ -776,10 +1254,12 @@ namespace lstl {
 		* @return 有効値を保持する場合、f(this->value())の戻り値をoptionalで包んで返す、そうでないならnullopt
 		*/
 		template<typename F>
-		constexpr auto transform(F&& func) const & noexcept(noexcept(func(m_value))) -> optional_traits::invoke_result_t<F, T> {
-			return (m_has_value == false)
-				? (nullopt)
-				: (func(m_value));
+		constexpr auto transform(F&& func) const & noexcept(noexcept(func(this->m_value))) -> optional<optional_traits::invoke_result_t<F, const T&>> {
+			using result_type = optional<optional_traits::invoke_result_t<F, const T&>>;
+
+			return (this->has_value() == false)
+				? result_type{}
+				: result_type{ in_place_invoke, std::forward<F>(func), this->m_value };
 		}
 
 		/**
@@ -789,10 +1269,12 @@ namespace lstl {
 		* @return 有効値を保持する場合、f(std::move(this->value()))の戻り値をoptionalで包んで返す、そうでないならnullopt
 		*/
 		template<typename F>
-		auto transform(F&& func) && noexcept(noexcept(func(std::move(m_value)))) -> optional_traits::invoke_result_t<F, T> {
-			return (m_has_value == false)
-				? (nullopt)
-				: (func(std::move(m_value)));
+		LSTL_CONSTEXPR20 auto transform(F&& func) && noexcept(noexcept(func(std::move(this->m_value)))) -> optional<optional_traits::invoke_result_t<F, T&&>> {
+			using result_type = optional<optional_traits::invoke_result_t<F, T&&>>;
+
+			return (this->has_value() == false)
+				? result_type{}
+				: result_type{ in_place_invoke, std::forward<F>(func), std::move(this->m_value) };
 		}
 
 		/**
@@ -802,10 +1284,12 @@ namespace lstl {
 		* @return 有効値を保持する場合、f(std::move(this->value()))の戻り値をoptionalで包んで返す、そうでないならnullopt
 		*/
 		template<typename F>
-		constexpr auto transform(F&& func) const && noexcept(noexcept(func(std::move(m_value)))) -> optional_traits::invoke_result_t<F, T> {
-			return (m_has_value == false)
-				? (nullopt)
-				: (func(std::move(m_value)));
+		constexpr auto transform(F&& func) const && noexcept(noexcept(func(std::move(this->m_value)))) -> optional<optional_traits::invoke_result_t<F, const T&&>> {
+			using result_type = optional<optional_traits::invoke_result_t<F, const T&&>>;
+
+			return (this->has_value() == false)
+				? result_type{}
+				: result_type{ in_place_invoke, std::forward<F>(func), std::move(this->m_value) };
 		}
 
 		/**
@@ -815,10 +1299,10 @@ namespace lstl {
 		* @return 有効値を保持する場合、f(this->value())、そうでないならnullopt
 		*/
 		template<typename F>
-		auto and_then(F&& func) & noexcept(noexcept(func(m_value))) -> optional_traits::invoke_result_t<F, T> {
-			return (m_has_value == false)
+		LSTL_CONSTEXPR20 auto and_then(F&& func) & noexcept(noexcept(func(this->m_value))) -> optional_traits::invoke_result_t<F, T> {
+			return (this->has_value() == false)
 				? (nullopt)
-				: (func(m_value));
+				: (func(this->m_value));
 		}
 
 		/**
@@ -828,10 +1312,10 @@ namespace lstl {
 		* @return 有効値を保持する場合、f(this->value())、そうでないならnullopt
 		*/
 		template<typename F>
-		constexpr auto and_then(F&& func) const & noexcept(noexcept(func(m_value))) -> optional_traits::invoke_result_t<F, T> {
-			return (m_has_value == false)
+		constexpr auto and_then(F&& func) const & noexcept(noexcept(func(this->m_value))) -> optional_traits::invoke_result_t<F, T> {
+			return (this->has_value() == false)
 				? (nullopt)
-				: (func(m_value));
+				: (func(this->m_value));
 		}
 
 		/**
@@ -841,10 +1325,10 @@ namespace lstl {
 		* @return 有効値を保持する場合、f(std::move(this->value()))、そうでないならnullopt
 		*/
 		template<typename F>
-		auto and_then(F&& func) && noexcept(noexcept(func(std::move(m_value)))) -> optional_traits::invoke_result_t<F, T> {
-			return (m_has_value == false)
+		LSTL_CONSTEXPR20 auto and_then(F&& func) && noexcept(noexcept(func(std::move(this->m_value)))) -> optional_traits::invoke_result_t<F, T> {
+			return (this->has_value() == false)
 				? (nullopt)
-				: (func(std::move(m_value)));
+				: (func(std::move(this->m_value)));
 		}
 
 		/**
@@ -854,110 +1338,130 @@ namespace lstl {
 		* @return 有効値を保持する場合、f(this->value())、そうでないならnullopt
 		*/
 		template<typename F>
-		constexpr auto and_then(F&& func) const && noexcept(noexcept(func(std::move(m_value)))) -> optional_traits::invoke_result_t<F, T> {
-			return (m_has_value == false)
+		constexpr auto and_then(F&& func) const && noexcept(noexcept(func(std::move(this->m_value)))) -> optional_traits::invoke_result_t<F, T> {
+			return (this->has_value() == false)
 				? (nullopt)
-				: (func(std::move(m_value)));
+				: (func(std::move(this->m_value)));
 		}
 
 		/**
 		* @brief 中身がない時に関数を実行しその結果のoptionalを返す
-		* @detail 渡される関数の戻り値が同じoptionalかvoidであること
-		* @param func 実行するINVOKE可能な関数（戻り値がoptionalであること）
+		* @detail 渡される関数の戻り値が同じoptionalかvoid、またはTを構築可能な値であること
+		* @detail Tを構築可能な値を返す場合、戻り値から直接構築される
+		* @param func 実行するINVOKE可能な関数
 		* @return 有効値を保持する場合、*this、そうでないならfunc()
 		*/
 		template<typename F>
-		optional or_else(F&& func) & noexcept(noexcept(func())) {
-			return (m_has_value == true)
+		LSTL_CONSTEXPR20 optional or_else(F&& func) & noexcept(noexcept(func())) {
+			return (this->has_value() == true)
 				? (*this)
-				: ((std::is_void<optional_traits::invoke_result_t<F>>::value)
-					? (func(), nullopt)
-					: (func()));
+				: invoke_alternative(std::forward<F>(func), alternative_kind<F>{});
 		}
 
 		/**
 		* @brief 中身がない時に関数を実行しその結果のoptionalを返す
-		* @detail 渡される関数の戻り値が同じoptionalかvoidであること
-		* @param func 実行するINVOKE可能な関数（戻り値がoptionalであること）
+		* @detail 渡される関数の戻り値が同じoptionalかvoid、またはTを構築可能な値であること
+		* @detail Tを構築可能な値を返す場合、戻り値から直接構築される
+		* @param func 実行するINVOKE可能な関数
 		* @return 有効値を保持する場合、*this、そうでないならfunc()
 		*/
 		template<typename F>
 		constexpr optional or_else(F&& func) const & noexcept(noexcept(func())) {
-			return (m_has_value == true)
+			return (this->has_value() == true)
 				? (*this)
-				: ((std::is_void<optional_traits::invoke_result_t<F>>::value)
-					? (func(), nullopt)
-					: (func()));
+				: invoke_alternative(std::forward<F>(func), alternative_kind<F>{});
 		}
 
 		/**
 		* @brief 中身がない時に関数を実行しその結果のoptionalを返す
-		* @detail 渡される関数の戻り値が同じoptionalかvoidであること
-		* @param func 実行するINVOKE可能な関数（戻り値がoptionalであること）
+		* @detail 渡される関数の戻り値が同じoptionalかvoid、またはTを構築可能な値であること
+		* @detail Tを構築可能な値を返す場合、戻り値から直接構築される
+		* @param func 実行するINVOKE可能な関数
 		* @return 有効値を保持する場合、std::move(*this)、そうでないならfunc()
 		*/
 		template<typename F>
-		optional or_else(F&& func) && noexcept(noexcept(func())) {
-			return (m_has_value == true)
+		LSTL_CONSTEXPR20 optional or_else(F&& func) && noexcept(noexcept(func())) {
+			return (this->has_value() == true)
 				? std::move(*this)
-				: ((std::is_void<optional_traits::invoke_result_t<F>>::value)
-					? (func(), nullopt)
-					: (func()));
+				: invoke_alternative(std::forward<F>(func), alternative_kind<F>{});
 		}
 
 		/**
 		* @brief 中身がない時に関数を実行しその結果のoptionalを返す
-		* @detail 渡される関数の戻り値が同じoptionalかvoidであること
-		* @param func 実行するINVOKE可能な関数（戻り値がoptionalであること）
+		* @detail 渡される関数の戻り値が同じoptionalかvoid、またはTを構築可能な値であること
+		* @detail Tを構築可能な値を返す場合、戻り値から直接構築される
+		* @param func 実行するINVOKE可能な関数
 		* @return 有効値を保持する場合、std::move(*this)、そうでないならfunc()
 		*/
 		template<typename F>
 		constexpr optional or_else(F&& func) const && noexcept(noexcept(func())) {
-			return (m_has_value == true)
+			return (this->has_value() == true)
 				? std::move(*this)
-				: ((std::is_void<optional_traits::invoke_result_t<F>>::value)
-					? (func(), nullopt)
-					: (func()));
+				: invoke_alternative(std::forward<F>(func), alternative_kind<F>{});
 		}
 
 		constexpr const T* operator->() const {
-			return std::addressof(m_value);
+			return std::addressof(this->m_value);
 		}
 
-		T* operator->() {
-			return std::addressof(m_value);
+		LSTL_CONSTEXPR20 T* operator->() {
+			return std::addressof(this->m_value);
 		}
 
-		T& operator*() & {
-			return m_value;
+		LSTL_CONSTEXPR20 T& operator*() & {
+			return this->m_value;
 		}
 
-		T&& operator*() && {
-			return std::move(m_value);
+		LSTL_CONSTEXPR20 T&& operator*() && {
+			return std::move(this->m_value);
 		}
 
 		constexpr const T& operator*() const & {
-			return m_value;
+			return this->m_value;
 		}
 
 		constexpr const T&& operator*() const && {
-			return std::move(m_value);
+			return std::move(this->m_value);
 		}
 
-		T& value() & {
-			return (m_has_value) ? m_value : (throw bad_optional_access{}, m_value);
+		/**
+		* @brief 有効値を返す
+		* @detail 有効値を保持していない場合はbad_optional_accessを投げる（例外を用いない設定ではbad_access_handlerを呼び出して停止する）
+		*/
+		LSTL_CONSTEXPR20 T& value() & {
+			return (this->has_value()) ? this->m_value : (detail::raise_bad_access<bad_optional_access>(), this->m_value);
 		}
 
-		T&& value() && {
-			return (m_has_value) ? std::move(m_value) : (throw bad_optional_access{}, m_value);
+		LSTL_CONSTEXPR20 T&& value() && {
+			return (this->has_value()) ? std::move(this->m_value) : (detail::raise_bad_access<bad_optional_access>(), std::move(this->m_value));
 		}
 
 		constexpr const T& value() const & {
-			return (m_has_value) ? m_value : (throw bad_optional_access{}, m_value);
+			return (this->has_value()) ? this->m_value : (detail::raise_bad_access<bad_optional_access>(), this->m_value);
 		}
 
 		constexpr const T&& value() const && {
-			return (m_has_value) ? std::move(m_value) : (throw bad_optional_access{}, m_value);
+			return (this->has_value()) ? std::move(this->m_value) : (detail::raise_bad_access<bad_optional_access>(), std::move(this->m_value));
+		}
+
+		/**
+		* @brief 検査せずに有効値を返す
+		* @detail 事前条件として、has_value() == trueであること（デバッグビルドでのみLSTL_ASSERTで検査する）
+		*/
+		LSTL_CONSTEXPR20 T& value_unchecked() & {
+			return (LSTL_ASSERT(this->has_value()), this->m_value);
+		}
+
+		LSTL_CONSTEXPR20 T&& value_unchecked() && {
+			return (LSTL_ASSERT(this->has_value()), std::move(this->m_value));
+		}
+
+		constexpr const T& value_unchecked() const & {
+			return (LSTL_ASSERT(this->has_value()), this->m_value);
+		}
+
+		constexpr const T&& value_unchecked() const && {
+			return (LSTL_ASSERT(this->has_value()), std::move(this->m_value));
 		}
 
 
@@ -969,7 +1473,7 @@ namespace lstl {
 		template<typename U, optional_traits::enabler<std::is_copy_constructible<T>, std::is_convertible<U&&, T>> = nullptr>
 		constexpr T value_or(U&& v) const & {
 			//static_assert(std::conjunction<std::is_copy_constructible<T>, std::is_convertible<U&&, T>>::value, "If is_­copy_­constructible_­v<T> && is_­convertible_­v<U&&, T> is false, the program is ill-formed. (N4659 23.6.3.5 [optional.observe]/18)");
-			return (m_has_value) ? m_value : static_cast<T>(std::forward<U>(v));
+			return (this->has_value()) ? this->m_value : static_cast<T>(std::forward<U>(v));
 		}
 
 		/**
@@ -980,15 +1484,15 @@ namespace lstl {
 		template<typename U, optional_traits::enabler<std::is_copy_constructible<T>, std::is_convertible<U&&, T>> = nullptr>
 		constexpr T value_or(U&& v) const && {
 			//static_assert(std::conjunction<std::is_move_constructible<T>, std::is_convertible<U&&, T>>::value, "If is_­copy_­constructible_­v<T> && is_­convertible_­v<U&&, T> is false, the program is ill-formed. (N4659 23.6.3.5 [optional.observe]/18)");
-			return (m_has_value) ? std::move(m_value) : static_cast<T>(std::forward<U>(v));
+			return (this->has_value()) ? std::move(this->m_value) : static_cast<T>(std::forward<U>(v));
 		}
 
 		constexpr explicit operator bool() const noexcept {
-			return m_has_value;
+			return base_storage::has_value();
 		}
 
 		constexpr bool has_value() const noexcept {
-			return m_has_value;
+			return base_storage::has_value();
 		}
 
 		using base_storage::reset;
@@ -1340,10 +1844,273 @@ namespace lstl {
 		return !(v < x);
 	}
 
-	//参照型、nullopt_tとin_place_t及びそのCV修飾はoptionalの要素になれない
+	namespace detail {
+
+		template<typename T>
+		struct is_optional : std::false_type {};
+
+		template<typename T>
+		struct is_optional<optional<T>> : std::true_type {};
+
+		/**
+		* @brief 順序キーを求められる要素型か（long longより狭い整数型）
+		*/
+		template<typename T>
+		struct is_order_key_type : std::integral_constant<bool,
+			std::is_integral<std::remove_const_t<T>>::value && sizeof(T) < sizeof(long long)
+		> {};
+
+		/**
+		* @brief 順序キーにおいて有効値に加えるオフセット、long longより狭い整数型の値は全て正のキーとなる
+		*/
+		constexpr long long order_key_offset = 1LL << 32;
+	}
+
+	/**
+	* @brief 有効値の有無と値を1つの整数に詰めた順序キー
+	* @detail long longより狭い整数型のoptionalのみ、無効値は0、有効値は値に2^32を加えた正の値となる
+	* @detail キーの大小関係はoptionalの大小関係（nulloptは無限小）と一致し、分岐せずに求まる
+	* @detail 整数型のoptionalは無効値保持状態でも値が生存している（optional_storage）ので常に読み、有効値の有無はマスクとして用いる
+	* @param x キーを求めるoptional
+	* @return 順序キー
+	*/
+	template<typename T, optional_traits::enabler<detail::is_order_key_type<T>> = nullptr>
+	constexpr long long order_key(const optional<T>& x) noexcept {
+		return (static_cast<long long>(*x) + detail::order_key_offset) & -static_cast<long long>(bool(x));
+	}
+
+	/**
+	* @brief 順序キーによる分岐の無い比較（<）
+	* @detail 比較結果を条件付き移動で用いる処理（分岐の無い二分探索等）では、有効値の有無による分岐予測の失敗が無くなる
+	* @detail 比較結果で分岐する処理（std::sort等）では、有効値の有無で分岐する通常の比較（operator<）の方が速い
+	*/
+	struct order_key_less {
+		template<typename T, typename U>
+		constexpr bool operator()(const optional<T>& lhs, const optional<U>& rhs) const noexcept {
+			return order_key(lhs) < order_key(rhs);
+		}
+	};
+
+#if LSTL_HAS_THREE_WAY_COMPARISON
 
+	/**
+	* @brief 比較可能なoptional同士の三方比較
+	* @detail 比較において、nulloptは無限小であるかのようにふるまう
+	* @return 両方有効なら中身の三方比較、そうでなければhas_value()の三方比較
+	*/
+	template<typename T, std::three_way_comparable_with<T> U>
+	constexpr std::compare_three_way_result_t<T, U> operator<=>(const optional<T>& lhs, const optional<U>& rhs) {
+		if (bool(lhs) && bool(rhs)) {
+			return *lhs <=> *rhs;
+		}
+		return bool(lhs) <=> bool(rhs);
+	}
+
+	/**
+	* @brief nulloptとの三方比較
+	* @detail nulloptは無限小であるかのようにふるまう
+	* @return x.has_value() <=> false
+	*/
 	template<typename T>
-	struct optional<T&>;
+	constexpr std::strong_ordering operator<=>(const optional<T>& x, nullopt_t) noexcept {
+		return bool(x) <=> false;
+	}
+
+	/**
+	* @brief optional<T>と素の値の三方比較
+	* @detail Uがoptionalの場合はoptional同士の比較となる
+	* @return xが無効値ならless、有効なら中身とvの三方比較
+	*/
+	template<typename T, typename U>
+		requires (!detail::is_optional<U>::value) && std::three_way_comparable_with<T, U>
+	constexpr std::compare_three_way_result_t<T, U> operator<=>(const optional<T>& x, const U& v) {
+		if (bool(x)) {
+			return *x <=> v;
+		}
+		return std::strong_ordering::less;
+	}
+
+#endif // LSTL_HAS_THREE_WAY_COMPARISON
+
+	/**
+	* @brief optional<T&>、左辺値参照の部分特殊化
+	* @detail 参照先へのポインタのみを保持し、nullptrによって無効状態を表す（sizeof(optional<T&>) == sizeof(T*)）
+	* @detail 代入は参照先の値ではなく参照そのものを再束縛する、trivially copyable
+	* @tparam T 参照する型
+	*/
+	template<typename T>
+	class optional<T&> {
+
+		template<typename U>
+		friend class optional;
+
+		T* m_ptr = nullptr;
+
+	public:
+
+		using value_type = T&;
+
+		/**
+		* @brief 無効値を持つoptional初期化
+		*/
+		constexpr optional() noexcept = default;
+
+		/**
+		* @brief 無効値を持つoptional初期化
+		*/
+		constexpr optional(nullopt_t) noexcept
+		{}
+
+		/**
+		* @brief 左辺値を参照するoptional初期化
+		* @detail U* → T* へ変換可能である場合にのみオーバーロードに参加
+		* @param ref 参照するオブジェクト
+		*/
+		template<typename U, optional_traits::enabler<std::is_convertible<U*, T*>> = nullptr>
+		constexpr optional(U& ref) noexcept
+			: m_ptr{ std::addressof(ref) }
+		{}
+
+		/**
+		* @brief 変換可能な参照を持つoptionalからの構築
+		* @detail U* → T* へ変換可能である場合にのみオーバーロードに参加
+		* @param rhs U&を保持するoptional
+		*/
+		template<typename U, optional_traits::enabler<std::negation<std::is_same<T, U>>, std::is_convertible<U*, T*>> = nullptr>
+		constexpr optional(const optional<U&>& rhs) noexcept
+			: m_ptr{ rhs.m_ptr }
+		{}
+
+		optional(const optional&) = default;
+		optional(optional&&) = default;
+		optional& operator=(const optional&) = default;
+		optional& operator=(optional&&) = default;
+
+		/**
+		* @brief nulloptを代入する
+		* @return *this
+		*/
+		LSTL_CONSTEXPR20 optional& operator=(nullopt_t) noexcept {
+			m_ptr = nullptr;
+			return *this;
+		}
+
+		/**
+		* @brief 参照を再束縛する
+		* @detail 参照先の値への代入は行わない
+		* @param ref 新たに参照するオブジェクト
+		* @return *this
+		*/
+		template<typename U, optional_traits::enabler<std::is_convertible<U*, T*>> = nullptr>
+		LSTL_CONSTEXPR20 optional& operator=(U& ref) noexcept {
+			m_ptr = std::addressof(ref);
+			return *this;
+		}
+
+		/**
+		* @brief 参照を再束縛する
+		* @param ref 新たに参照するオブジェクト
+		* @return 参照先への参照
+		*/
+		template<typename U, optional_traits::enabler<std::is_convertible<U*, T*>> = nullptr>
+		LSTL_CONSTEXPR20 T& emplace(U& ref) noexcept {
+			m_ptr = std::addressof(ref);
+			return *m_ptr;
+		}
+
+		/**
+		* @brief 他のoptional<T&>と参照先を入れ替える
+		* @param rhs swapするoptional
+		*/
+		LSTL_CONSTEXPR20 void swap(optional& rhs) noexcept {
+			T* tmp = m_ptr;
+			m_ptr = rhs.m_ptr;
+			rhs.m_ptr = tmp;
+		}
+
+		/**
+		* @brief 中身に関数を適用しその結果をoptionalで返す
+		* @detail 渡される関数の戻り値はvoidでないこと
+		* @param func 適用するINVOKE可能な関数
+		* @return 有効値を保持する場合、f(this->value())の戻り値をoptionalで包んで返す、そうでないならnullopt
+		*/
+		template<typename F>
+		constexpr auto transform(F&& func) const noexcept(noexcept(func(*m_ptr))) -> optional<optional_traits::invoke_result_t<F, T&>> {
+			return (m_ptr == nullptr)
+				? optional<optional_traits::invoke_result_t<F, T&>>{}
+				: optional<optional_traits::invoke_result_t<F, T&>>{ in_place_invoke, std::forward<F>(func), *m_ptr };
+		}
+
+		/**
+		* @brief 中身に関数を適用しその結果をoptionalで返す
+		* @detail 渡される関数の戻り値が何らかのoptionalであること
+		* @param func 適用するINVOKE可能な関数（戻り値がoptionalであること）
+		* @return 有効値を保持する場合、f(this->value())、そうでないならnullopt
+		*/
+		template<typename F>
+		constexpr auto and_then(F&& func) const noexcept(noexcept(func(*m_ptr))) -> optional_traits::invoke_result_t<F, T&> {
+			return (m_ptr == nullptr)
+				? optional_traits::invoke_result_t<F, T&>{}
+				: func(*m_ptr);
+		}
+
+		/**
+		* @brief 中身がない時に関数を実行しその結果のoptionalを返す
+		* @detail 渡される関数の戻り値がoptional<T&>であること
+		* @param func 実行するINVOKE可能な関数
+		* @return 有効値を保持する場合、*this、そうでないならfunc()
+		*/
+		template<typename F>
+		constexpr optional or_else(F&& func) const noexcept(noexcept(func())) {
+			return (m_ptr != nullptr)
+				? (*this)
+				: optional{ func() };
+		}
+
+		constexpr T* operator->() const noexcept {
+			return m_ptr;
+		}
+
+		constexpr T& operator*() const noexcept {
+			return *m_ptr;
+		}
+
+		constexpr T& value() const {
+			return (m_ptr != nullptr) ? *m_ptr : (detail::raise_bad_access<bad_optional_access>(), *m_ptr);
+		}
+
+		/**
+		* @brief 検査せずに参照先を返す
+		* @detail 事前条件として、has_value() == trueであること（デバッグビルドでのみLSTL_ASSERTで検査する）
+		*/
+		constexpr T& value_unchecked() const {
+			return (LSTL_ASSERT(m_ptr != nullptr), *m_ptr);
+		}
+
+		/**
+		* @brief 参照先の値のコピーか、それが無ければ指定した値を返す
+		* @detail remove_cv_t<T>がコピー構築可能　かつ　U&& → remove_cv_t<T>へ変換可能であること
+		* @param v 無効値だった時に返す値
+		*/
+		template<typename U, optional_traits::enabler<std::is_copy_constructible<std::remove_cv_t<T>>, std::is_convertible<U&&, std::remove_cv_t<T>>> = nullptr>
+		constexpr std::remove_cv_t<T> value_or(U&& v) const {
+			return (m_ptr != nullptr) ? *m_ptr : static_cast<std::remove_cv_t<T>>(std::forward<U>(v));
+		}
+
+		constexpr explicit operator bool() const noexcept {
+			return m_ptr != nullptr;
+		}
+
+		constexpr bool has_value() const noexcept {
+			return m_ptr != nullptr;
+		}
+
+		LSTL_CONSTEXPR20 void reset() noexcept {
+			m_ptr = nullptr;
+		}
+	};
+
+	//右辺値参照型、nullopt_t、in_place_tとin_place_invoke_t及びそのCV修飾はoptionalの要素になれない
 
 	template<typename T>
 	struct optional<T&&>;
@@ -1372,6 +2139,28 @@ namespace lstl {
 	template<>
 	struct optional<volatile in_place_t>;
 
+	template<>
+	struct optional<in_place_invoke_t>;
+
+	template<>
+	struct optional<const in_place_invoke_t>;
+
+	template<>
+	struct optional<const volatile in_place_invoke_t>;
+
+	template<>
+	struct optional<volatile in_place_invoke_t>;
+
+	/**
+	* @brief optional<T>はTがtrivially relocatableならばtrivially relocatable
+	* @detail 有効値の有無のフラグもストレージ内にあるので、ストレージのバイト列のコピーで再配置できる
+	*/
+	template<typename T>
+	struct is_trivially_relocatable<optional<T>> : is_trivially_relocatable<T> {};
+
+	template<typename T>
+	struct is_trivially_relocatable<optional<T&>> : std::true_type {};
+
 	/**
 	* @brief optional同士のデータを入れ替える
 	* @detail Tがムーブ構築可能かつSwappableであること
@@ -1380,7 +2169,7 @@ namespace lstl {
 	* @param y swapするoptional
 	*/
 	template<typename T, optional_traits::enabler<std::is_move_constructible<T>, is_swappable<T>> = nullptr>
-	void swap(optional<T>& x, optional<T>& y) noexcept(noexcept(x.swap(y))) {
+	LSTL_CONSTEXPR20 void swap(optional<T>& x, optional<T>& y) noexcept(noexcept(x.swap(y))) {
 		x.swap(y);
 	}
 
@@ -1414,6 +2203,123 @@ namespace lstl {
 	constexpr auto make_optional(std::initializer_list<U> il, Args&&... args) -> optional<T> {
 		return optional<T>{ in_place, il, std::forward<Args>(args)... };
 	}
+
+	namespace detail {
+
+		/**
+		* @brief 無効値を保持するoptionalのハッシュ値
+		*/
+		constexpr std::size_t nullopt_hash = static_cast<std::size_t>(0x9e3779b97f4a7c15ull);
+
+		/**
+		* @brief 有効値のハッシュ値を、無効値のハッシュ値と衝突しないように補正する
+		* @detail 分岐せずに計算する
+		* @param h 有効値のハッシュ値
+		*/
+		constexpr std::size_t adjust_value_hash(std::size_t h) noexcept {
+			return h + static_cast<std::size_t>(h == nullopt_hash);
+		}
+
+		/**
+		* @brief std::hash<optional<T>>の実装
+		* @detail 値のハッシュが有効でない場合のもの、構築できない
+		*/
+		template<typename T, bool = std::is_default_constructible<std::hash<T>>::value>
+		struct optional_hash_base {
+			optional_hash_base() = delete;
+			optional_hash_base(const optional_hash_base&) = delete;
+			optional_hash_base& operator=(const optional_hash_base&) = delete;
+		};
+
+		/**
+		* @brief std::hash<optional<T>>の実装
+		* @detail 有効値を保持していればstd::hash<T>による値、そうでなければnullopt_hash
+		*/
+		template<typename T>
+		struct optional_hash_base<T, true> {
+
+			template<typename Optional>
+			std::size_t operator()(const Optional& x) const noexcept(noexcept(std::hash<T>{}(*x))) {
+				return (bool(x))
+					? (adjust_value_hash(std::hash<T>{}(*x)))
+					: (nullopt_hash);
+			}
+		};
+	}
+
+	namespace detail {
+
+		/**
+		* @brief hash_rangeで分岐しない経路を用いるか
+		* @detail trivialな型を保持するoptionalの配列（ポインタで渡された連続した範囲）
+		*/
+		template<typename InputIterator>
+		struct is_trivial_optional_array : std::false_type {};
+
+		template<typename T>
+		struct is_trivial_optional_array<optional<T>*> : std::is_trivial<T> {};
+
+		template<typename T>
+		struct is_trivial_optional_array<const optional<T>*> : std::is_trivial<T> {};
+
+		template<typename InputIterator, typename OutputIterator, typename Hash>
+		OutputIterator hash_range(std::false_type, InputIterator first, InputIterator last, OutputIterator out, Hash& hasher) {
+			for (; first != last; ++first, ++out) {
+				*out = (bool(*first))
+					? (detail::adjust_value_hash(hasher(**first)))
+					: (detail::nullopt_hash);
+			}
+			return out;
+		}
+
+		/**
+		* @brief trivialな型を保持するoptionalの配列の場合
+		* @detail 無効値の要素では値初期化したTを代わりにハッシュし、結果を選択する（分岐しない）
+		*/
+		template<typename Optional, typename OutputIterator, typename Hash>
+		OutputIterator hash_range(std::true_type, Optional* first, Optional* last, OutputIterator out, Hash& hasher) {
+			using value_type = std::remove_const_t<typename Optional::value_type>;
+			const value_type zero{};
+
+			for (; first != last; ++first, ++out) {
+				const bool has_value = first->has_value();
+
+				//未初期化の領域を読まないよう、ハッシュする値のアドレスを選択する
+				const value_type* const candidates[2] = { std::addressof(zero), first->operator->() };
+				const std::size_t h = detail::adjust_value_hash(hasher(*candidates[has_value]));
+				const std::size_t mask = std::size_t(0) - static_cast<std::size_t>(has_value);
+
+				*out = (h & mask) | (detail::nullopt_hash & ~mask);
+			}
+			return out;
+		}
+	}
+
+	/**
+	* @brief optionalの範囲の各要素のハッシュ値を計算する
+	* @detail 結果はstd::hash<optional<T>>の値と等しい
+	* @detail trivialな型を保持するoptionalの配列をポインタで渡した場合、有効値の有無で分岐せずに計算する
+	* @param first 範囲の先頭
+	* @param last 範囲の終端
+	* @param out ハッシュ値の出力先、範囲の要素数以上の領域があること
+	* @param hasher 有効値に適用するハッシュ関数
+	* @return 出力の終端
+	*/
+	template<typename InputIterator, typename OutputIterator, typename Hash = std::hash<std::remove_cv_t<std::remove_reference_t<typename std::iterator_traits<InputIterator>::value_type::value_type>>>>
+	OutputIterator hash_range(InputIterator first, InputIterator last, OutputIterator out, Hash hasher = Hash{}) {
+		return detail::hash_range(detail::is_trivial_optional_array<InputIterator>{}, first, last, out, hasher);
+	}
+}
+
+namespace std {
+
+	/**
+	* @brief lstl::optional<T>のハッシュ
+	* @detail std::hash<remove_const_t<T>>が有効である場合にのみ有効
+	* @detail 無効値のハッシュ値は有効値のハッシュ値とは常に異なる
+	*/
+	template<typename T>
+	struct hash<lstl::optional<T>> : lstl::detail::optional_hash_base<std::remove_const_t<std::remove_reference_t<T>>> {};
 }
 
 //警告抑止の解除
@@ -0,0 +1,314 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "optional.hpp"
+
+namespace lstl {
+
+	/**
+	* @brief 整列・分割において無効値を並べる位置
+	*/
+	enum class nullopt_position {
+		//先頭（operator<による順序と同じ）
+		front,
+		//末尾
+		back
+	};
+
+	/**
+	* @brief 無効値を先頭または末尾に集める
+	* @detail 1回の走査で有効値を詰めて移動し、残りの要素をリセットする、有効値の順序は保たれる（安定）
+	* @param first 範囲の先頭
+	* @param last 範囲の終端
+	* @param pos 無効値を集める位置
+	* @return 無効値と有効値の境界（frontなら最初の有効値、backなら最初の無効値）
+	*/
+	template<typename BidirIt>
+	BidirIt partition_nullopt(BidirIt first, BidirIt last, nullopt_position pos = nullopt_position::front) {
+		if (pos == nullopt_position::back) {
+			BidirIt out = first;
+			for (BidirIt it = first; it != last; ++it) {
+				if (it->has_value()) {
+					if (out != it) *out = std::move(*it);
+					++out;
+				}
+			}
+			for (BidirIt it = out; it != last; ++it) {
+				it->reset();
+			}
+			return out;
+		}
+
+		BidirIt out = last;
+		for (BidirIt it = last; it != first;) {
+			--it;
+			if (it->has_value()) {
+				--out;
+				if (out != it) *out = std::move(*it);
+			}
+		}
+		for (BidirIt it = first; it != out; ++it) {
+			it->reset();
+		}
+		return out;
+	}
+
+	namespace detail {
+
+		/**
+		* @brief 同じ大きさの符号無し整数型
+		*/
+		template<std::size_t Size>
+		struct unsigned_of_size;
+
+		template<>
+		struct unsigned_of_size<1> { using type = std::uint8_t; };
+
+		template<>
+		struct unsigned_of_size<2> { using type = std::uint16_t; };
+
+		template<>
+		struct unsigned_of_size<4> { using type = std::uint32_t; };
+
+		template<>
+		struct unsigned_of_size<8> { using type = std::uint64_t; };
+
+		/**
+		* @brief 基数ソートの対象とする型か
+		* @detail 整数型と、IEEE754の単精度・倍精度浮動小数点数型
+		*/
+		template<typename T>
+		struct is_radix_sortable : std::integral_constant<bool,
+			(std::is_integral<T>::value && sizeof(T) <= 8) ||
+			(std::is_floating_point<T>::value && std::numeric_limits<T>::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8))
+		> {};
+
+		/**
+		* @brief 値を、大小関係の等しい符号無し整数（基数ソートのキー）に変換する
+		*/
+		template<typename T, bool = std::is_floating_point<T>::value>
+		struct radix_key {
+			using type = typename unsigned_of_size<sizeof(T)>::type;
+
+			static constexpr type sign_bit = std::is_signed<T>::value ? type(type(1) << (sizeof(T) * 8 - 1)) : type(0);
+
+			/**
+			* @brief 符号付き整数は符号ビットを反転する
+			*/
+			static type get(T v) noexcept {
+				return static_cast<type>(static_cast<type>(v) ^ sign_bit);
+			}
+		};
+
+		template<typename T>
+		struct radix_key<T, true> {
+			using type = typename unsigned_of_size<sizeof(T)>::type;
+
+			static constexpr type sign_bit = type(type(1) << (sizeof(T) * 8 - 1));
+
+			/**
+			* @brief 正の数は符号ビットを立て、負の数は全ビットを反転する
+			* @detail -0.0は+0.0と同じキーとし（operator<で等しいので安定ソートで順序が入れ替わらない）、NaNは最大のキーとする
+			*/
+			static type get(T v) noexcept {
+				type bits;
+				std::memcpy(&bits, &v, sizeof(T));
+
+				bits = (v == T(0)) ? type(0) : bits;
+				const type mask = static_cast<type>(type(0) - (bits >> (sizeof(T) * 8 - 1))) | sign_bit;
+				return (v != v) ? (std::numeric_limits<type>::max)() : static_cast<type>(bits ^ mask);
+			}
+		};
+
+		/**
+		* @brief これより要素数が少ない範囲は比較ソートで整列する
+		*/
+		constexpr std::ptrdiff_t radix_sort_threshold = 256;
+
+		/**
+		* @brief LSD基数ソート（1バイトずつ、安定）
+		* @detail 全要素でそのバイトが等しい桁は飛ばす（値域の狭いタイムスタンプ等では上位の桁の多くが飛ばされる）
+		* @param first 整列する配列の先頭
+		* @param n 要素数
+		* @param buffer 作業領域、n要素
+		*/
+		template<typename T>
+		void radix_sort(T* first, std::size_t n, T* buffer) {
+			using key = radix_key<T>;
+			constexpr std::size_t passes = sizeof(T);
+
+			//全ての桁のヒストグラムを1回の走査で作る
+			std::size_t counts[passes][256] = {};
+			for (std::size_t i = 0; i < n; ++i) {
+				const auto k = key::get(first[i]);
+				for (std::size_t p = 0; p < passes; ++p) {
+					++counts[p][(k >> (p * 8)) & 0xff];
+				}
+			}
+
+			const auto first_key = key::get(first[0]);
+			T* src = first;
+			T* dst = buffer;
+
+			for (std::size_t p = 0; p < passes; ++p) {
+				std::size_t* count = counts[p];
+				if (count[(first_key >> (p * 8)) & 0xff] == n) continue;
+
+				std::size_t offset = 0;
+				for (std::size_t b = 0; b < 256; ++b) {
+					const std::size_t c = count[b];
+					count[b] = offset;
+					offset += c;
+				}
+
+				for (std::size_t i = 0; i < n; ++i) {
+					dst[count[(key::get(src[i]) >> (p * 8)) & 0xff]++] = src[i];
+				}
+				std::swap(src, dst);
+			}
+
+			if (src != first) {
+				std::memcpy(first, src, n * sizeof(T));
+			}
+		}
+
+		/**
+		* @brief 有効値同士を中身で比較する
+		* @detail 無効値を含まない範囲に用いるので、有効値の有無を見ない
+		*/
+		template<typename Compare>
+		struct value_compare {
+			Compare comp;
+
+			template<typename Optional>
+			bool operator()(const Optional& lhs, const Optional& rhs) {
+				return comp(*lhs, *rhs);
+			}
+		};
+
+		/**
+		* @brief 基数ソートのキーで比較する
+		* @detail 基数ソートを用いない小さい範囲に用い、基数ソートと同じ順序（浮動小数点数のNaNは最大）とする
+		*/
+		struct radix_key_less {
+			template<typename T>
+			bool operator()(const T& lhs, const T& rhs) const noexcept {
+				return radix_key<T>::get(lhs) < radix_key<T>::get(rhs);
+			}
+		};
+
+		/**
+		* @brief 有効値のみの範囲を、中身の値で整列する（比較ソート）
+		*/
+		template<typename RandomIt, typename Compare>
+		void sort_values(std::false_type, RandomIt first, RandomIt last, Compare comp, bool stable) {
+			if (stable) {
+				std::stable_sort(first, last, value_compare<Compare>{ comp });
+			}
+			else {
+				std::sort(first, last, value_compare<Compare>{ comp });
+			}
+		}
+
+		/**
+		* @brief 有効値のみの範囲を、中身の値で整列する（基数ソート）
+		* @detail 値を連続した配列に取り出して整列し、書き戻す
+		* @detail 比較関数はキーの順序と一致するもの（std::less等）に限られるので用いない
+		*/
+		template<typename RandomIt, typename Compare>
+		void sort_values(std::true_type, RandomIt first, RandomIt last, Compare, bool stable) {
+			using value_type = std::remove_const_t<typename std::iterator_traits<RandomIt>::value_type::value_type>;
+
+			const auto n = last - first;
+			if (n < radix_sort_threshold) {
+				sort_values(std::false_type{}, first, last, radix_key_less{}, stable);
+				return;
+			}
+
+			std::vector<value_type> values{};
+			values.reserve(static_cast<std::size_t>(n));
+			for (auto it = first; it != last; ++it) {
+				values.push_back(**it);
+			}
+
+			std::vector<value_type> buffer(static_cast<std::size_t>(n));
+			radix_sort(values.data(), values.size(), buffer.data());
+
+			auto v = values.begin();
+			for (auto it = first; it != last; ++it, ++v) {
+				**it = *v;
+			}
+		}
+
+		/**
+		* @brief 既定の順序（operator<）による整列で基数ソートを用いるか
+		*/
+		template<typename Optional, typename Compare>
+		struct use_radix_sort : std::integral_constant<bool,
+			is_radix_sortable<std::remove_const_t<typename Optional::value_type>>::value &&
+			(std::is_same<Compare, std::less<>>::value || std::is_same<Compare, std::less<std::remove_const_t<typename Optional::value_type>>>::value)
+		> {};
+
+		template<typename RandomIt, typename Compare>
+		void sort_optional_impl(RandomIt first, RandomIt last, Compare comp, nullopt_position pos, bool stable) {
+			using optional_type = typename std::iterator_traits<RandomIt>::value_type;
+
+			const RandomIt middle = partition_nullopt(first, last, pos);
+			const RandomIt values_first = (pos == nullopt_position::front) ? middle : first;
+			const RandomIt values_last = (pos == nullopt_position::front) ? last : middle;
+
+			sort_values(use_radix_sort<optional_type, Compare>{}, values_first, values_last, std::move(comp), stable);
+		}
+	}
+
+	/**
+	* @brief optionalの範囲を整列する
+	* @detail 無効値を先頭（または末尾）に集めてから、有効値の範囲のみを中身の値で整列する（有効値の有無による分岐が比較から無くなる）
+	* @detail 整数型と浮動小数点数型は基数ソートを用いる、浮動小数点数のNaNは有効値の最後に並ぶ
+	* @param first 範囲の先頭
+	* @param last 範囲の終端
+	* @param pos 無効値を並べる位置
+	*/
+	template<typename RandomIt>
+	void sort_optional(RandomIt first, RandomIt last, nullopt_position pos = nullopt_position::front) {
+		detail::sort_optional_impl(first, last, std::less<>{}, pos, false);
+	}
+
+	/**
+	* @brief optionalの範囲を、有効値同士の比較関数によって整列する
+	* @param comp 中身の値同士の比較関数
+	*/
+	template<typename RandomIt, typename Compare>
+	void sort_optional(RandomIt first, RandomIt last, Compare comp, nullopt_position pos = nullopt_position::front) {
+		detail::sort_optional_impl(first, last, std::move(comp), pos, false);
+	}
+
+	/**
+	* @brief optionalの範囲を安定に整列する
+	* @detail 等しい有効値の順序が保たれる、その他はsort_optionalと同じ
+	*/
+	template<typename RandomIt>
+	void stable_sort_optional(RandomIt first, RandomIt last, nullopt_position pos = nullopt_position::front) {
+		detail::sort_optional_impl(first, last, std::less<>{}, pos, true);
+	}
+
+	/**
+	* @brief optionalの範囲を、有効値同士の比較関数によって安定に整列する
+	* @param comp 中身の値同士の比較関数
+	*/
+	template<typename RandomIt, typename Compare>
+	void stable_sort_optional(RandomIt first, RandomIt last, Compare comp, nullopt_position pos = nullopt_position::front) {
+		detail::sort_optional_impl(first, last, std::move(comp), pos, true);
+	}
+}
\ No newline at end of file
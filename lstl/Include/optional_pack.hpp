@@ -0,0 +1,622 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <tuple>
+#include <new>
+
+#include "config.hpp"
+#include "optional.hpp"
+
+namespace lstl {
+
+	namespace detail {
+
+		/**
+		* @brief N個のフィールドの有無を保持する最小の符号なし整数型
+		*/
+		template<std::size_t N>
+		using pack_mask_t = std::conditional_t<(N <= 8), std::uint8_t,
+			std::conditional_t<(N <= 16), std::uint16_t,
+			std::conditional_t<(N <= 32), std::uint32_t, std::uint64_t>>>;
+
+		constexpr std::size_t pack_sum() noexcept {
+			return 0;
+		}
+
+		template<typename... Rest>
+		constexpr std::size_t pack_sum(std::size_t first, Rest... rest) noexcept {
+			return first + pack_sum(rest...);
+		}
+
+		constexpr std::size_t pack_max() noexcept {
+			return 1;
+		}
+
+		constexpr std::size_t pack_greater(std::size_t a, std::size_t b) noexcept {
+			return (a < b) ? b : a;
+		}
+
+		/**
+		* @brief 最大値、残りの最大値は1度だけ求める（フィールド数に対して線形）
+		*/
+		template<typename... Rest>
+		constexpr std::size_t pack_max(std::size_t first, Rest... rest) noexcept {
+			return pack_greater(first, pack_max(rest...));
+		}
+
+		constexpr std::uint64_t pack_bits() noexcept {
+			return 0;
+		}
+
+		/**
+		* @brief 指定した添え字のビットを立てたマスクを作る
+		*/
+		template<typename... Rest>
+		constexpr std::uint64_t pack_bits(std::size_t first, Rest... rest) noexcept {
+			return (std::uint64_t(1) << first) | pack_bits(rest...);
+		}
+
+		/**
+		* @brief 宣言順でj番目のフィールドがi番目のフィールドより前に配置されるか
+		* @detail アラインメントの降順、同じならば宣言順
+		*/
+		constexpr bool pack_precedes(std::size_t align_j, std::size_t j, std::size_t align_i, std::size_t i) noexcept {
+			return (align_i < align_j) || (align_j == align_i && j < i);
+		}
+
+		/**
+		* @brief フィールドの配置
+		* @detail 型をアラインメントの降順（同じならば宣言順）に並べ、先頭から詰めて配置する
+		* @detail 型の大きさはそのアラインメントの倍数なので、並べ替えた後はフィールド間にパディングが生じない
+		*/
+		template<typename... Ts>
+		struct pack_layout {
+
+			template<std::size_t I>
+			using type = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+			template<std::size_t I, std::size_t... J>
+			static constexpr std::size_t offset_impl(std::index_sequence<J...>) noexcept {
+				return pack_sum((pack_precedes(alignof(Ts), J, alignof(type<I>), I) ? sizeof(Ts) : 0)...);
+			}
+
+			/**
+			* @brief 宣言順でI番目のフィールドの、領域先頭からのオフセット
+			*/
+			template<std::size_t I>
+			static constexpr std::size_t offset() noexcept {
+				return offset_impl<I>(std::index_sequence_for<Ts...>{});
+			}
+
+			static constexpr std::size_t alignment() noexcept {
+				return pack_max(alignof(Ts)...);
+			}
+
+			static constexpr std::size_t size() noexcept {
+				return (pack_sum(sizeof(Ts)...) + alignment() - 1) / alignment() * alignment();
+			}
+		};
+
+		/**
+		* @brief 他optional_pack<Ts...>のフィールドをコピー/ムーブする際の参照型
+		* @detail Packが左辺値参照ならばconst T&、そうでなければT&&
+		*/
+		template<typename Pack, typename T>
+		using pack_forward_t = std::conditional_t<std::is_lvalue_reference<Pack>::value, const T&, T&&>;
+
+		/**
+		* @brief 添え字の列について、順に関数を呼び出す
+		* @param f void(std::integral_constant<std::size_t, I>)で呼び出し可能な関数
+		*/
+		template<typename F, std::size_t... I>
+		void pack_for_each(std::index_sequence<I...>, F&& f) {
+			using expand = int[];
+			(void)expand{ 0, (f(std::integral_constant<std::size_t, I>{}), 0)... };
+		}
+
+		/**
+		* @brief optional_pack<Ts...>の特殊メンバ関数の性質を表す型
+		* @detail optionalと共通のenable_special_menber_functionsにTの代わりに渡す
+		*/
+		template<typename... Ts>
+		struct optional_pack_members {};
+
+		template<typename T, typename... Ts>
+		struct optional_pack_members<T, Ts...> {
+			T m_head;
+			optional_pack_members<Ts...> m_tail;
+		};
+
+		/**
+		* @brief ストレージ領域の特殊メンバ関数を、Tの特殊メンバ関数がtrivialな場合のみ暗黙に定義させる
+		* @detail 非トリビアルな型を共用体のメンバとした場合と同じく、それ以外の場合はdeleteとなる
+		* @detail 非トリビアルな場合の定義はoptionalと共通の層が行う
+		*/
+		template<typename T, bool = std::is_trivially_move_assignable<T>::value>
+		struct pack_move_assign_control {};
+
+		template<typename T>
+		struct pack_move_assign_control<T, false> {
+			pack_move_assign_control() = default;
+			pack_move_assign_control(const pack_move_assign_control&) = default;
+			pack_move_assign_control(pack_move_assign_control&&) = default;
+			pack_move_assign_control& operator=(const pack_move_assign_control&) = default;
+			pack_move_assign_control& operator=(pack_move_assign_control&&) = delete;
+		};
+
+		template<typename T, bool = std::is_trivially_copy_assignable<T>::value>
+		struct pack_copy_assign_control : pack_move_assign_control<T> {};
+
+		template<typename T>
+		struct pack_copy_assign_control<T, false> : pack_move_assign_control<T> {
+			pack_copy_assign_control() = default;
+			pack_copy_assign_control(const pack_copy_assign_control&) = default;
+			pack_copy_assign_control(pack_copy_assign_control&&) = default;
+			pack_copy_assign_control& operator=(const pack_copy_assign_control&) = delete;
+			pack_copy_assign_control& operator=(pack_copy_assign_control&&) = default;
+		};
+
+		template<typename T, bool = std::is_trivially_move_constructible<T>::value>
+		struct pack_move_construct_control : pack_copy_assign_control<T> {};
+
+		template<typename T>
+		struct pack_move_construct_control<T, false> : pack_copy_assign_control<T> {
+			pack_move_construct_control() = default;
+			pack_move_construct_control(const pack_move_construct_control&) = default;
+			pack_move_construct_control(pack_move_construct_control&&) = delete;
+			pack_move_construct_control& operator=(const pack_move_construct_control&) = default;
+			pack_move_construct_control& operator=(pack_move_construct_control&&) = default;
+		};
+
+		template<typename T, bool = std::is_trivially_copy_constructible<T>::value>
+		struct pack_copy_construct_control : pack_move_construct_control<T> {};
+
+		template<typename T>
+		struct pack_copy_construct_control<T, false> : pack_move_construct_control<T> {
+			pack_copy_construct_control() = default;
+			pack_copy_construct_control(const pack_copy_construct_control&) = delete;
+			pack_copy_construct_control(pack_copy_construct_control&&) = default;
+			pack_copy_construct_control& operator=(const pack_copy_construct_control&) = default;
+			pack_copy_construct_control& operator=(pack_copy_construct_control&&) = default;
+		};
+
+		/**
+		* @brief optional_pack<Ts...>のためのストレージ領域
+		* @detail 全フィールドと有無のビットマスクを1つのバイト列に、pack_layoutに従って配置する
+		* @detail ビットマスクも1つのフィールドとして並べ替えの対象とする
+		*/
+		template<bool trivially_destructible, typename... Ts>
+		struct optional_pack_storage : pack_copy_construct_control<optional_pack_members<Ts...>> {
+			using mask_type = pack_mask_t<sizeof...(Ts)>;
+			using layout = pack_layout<Ts..., mask_type>;
+
+			template<std::size_t I>
+			using type = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+			alignas(layout::alignment()) unsigned char m_data[layout::size()];
+
+			optional_pack_storage(nullopt_t) noexcept {
+				::new (static_cast<void*>(m_data + layout::template offset<sizeof...(Ts)>())) mask_type(0);
+			}
+
+			/**
+			* @brief デストラクタ
+			* @detail nothrow_destructibleな型を前提とするのでnoexcept
+			*/
+			~optional_pack_storage() noexcept {
+				this->destroy_all();
+			}
+
+			mask_type& mask() noexcept {
+				return *reinterpret_cast<mask_type*>(m_data + layout::template offset<sizeof...(Ts)>());
+			}
+
+			const mask_type& mask() const noexcept {
+				return *reinterpret_cast<const mask_type*>(m_data + layout::template offset<sizeof...(Ts)>());
+			}
+
+			template<std::size_t I>
+			type<I>* ptr() noexcept {
+				return reinterpret_cast<type<I>*>(m_data + layout::template offset<I>());
+			}
+
+			template<std::size_t I>
+			const type<I>* ptr() const noexcept {
+				return reinterpret_cast<const type<I>*>(m_data + layout::template offset<I>());
+			}
+
+			template<std::size_t I>
+			bool test() const noexcept {
+				return (mask() >> I) & 1;
+			}
+
+			/**
+			* @brief I番目のフィールドを破棄し、無効とする
+			*/
+			template<std::size_t I>
+			void destroy() noexcept {
+				if (this->template test<I>()) {
+					detail::destroy_at(this->template ptr<I>());
+					mask() &= static_cast<mask_type>(~(mask_type(1) << I));
+				}
+			}
+
+			/**
+			* @brief 全フィールドを破棄する
+			*/
+			void destroy_all() noexcept {
+				pack_for_each(std::index_sequence_for<Ts...>{}, [this](auto i) {
+					this->template destroy<decltype(i)::value>();
+				});
+			}
+		};
+
+		/**
+		* @brief optional_pack<Ts...>のためのストレージ領域
+		* @detail 全てのフィールドの型がtrivially destructibleである場合、デストラクタはtrivialとなる
+		*/
+		template<typename... Ts>
+		struct optional_pack_storage<true, Ts...> : pack_copy_construct_control<optional_pack_members<Ts...>> {
+			using mask_type = pack_mask_t<sizeof...(Ts)>;
+			using layout = pack_layout<Ts..., mask_type>;
+
+			template<std::size_t I>
+			using type = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+			alignas(layout::alignment()) unsigned char m_data[layout::size()];
+
+			optional_pack_storage(nullopt_t) noexcept {
+				::new (static_cast<void*>(m_data + layout::template offset<sizeof...(Ts)>())) mask_type(0);
+			}
+
+			mask_type& mask() noexcept {
+				return *reinterpret_cast<mask_type*>(m_data + layout::template offset<sizeof...(Ts)>());
+			}
+
+			const mask_type& mask() const noexcept {
+				return *reinterpret_cast<const mask_type*>(m_data + layout::template offset<sizeof...(Ts)>());
+			}
+
+			template<std::size_t I>
+			type<I>* ptr() noexcept {
+				return reinterpret_cast<type<I>*>(m_data + layout::template offset<I>());
+			}
+
+			template<std::size_t I>
+			const type<I>* ptr() const noexcept {
+				return reinterpret_cast<const type<I>*>(m_data + layout::template offset<I>());
+			}
+
+			template<std::size_t I>
+			bool test() const noexcept {
+				return (mask() >> I) & 1;
+			}
+
+			/**
+			* @brief I番目のフィールドを無効とする
+			* @detail 破棄の必要はない
+			*/
+			template<std::size_t I>
+			void destroy() noexcept {
+				mask() &= static_cast<mask_type>(~(mask_type(1) << I));
+			}
+
+			void destroy_all() noexcept {
+				mask() = 0;
+			}
+		};
+
+		/**
+		* @brief optional_pack<Ts...>の共通処理
+		*/
+		template<typename... Ts>
+		struct optional_pack_common_base : optional_pack_storage<std::conjunction<std::is_trivially_destructible<Ts>...>::value, Ts...> {
+			using storage = optional_pack_storage<std::conjunction<std::is_trivially_destructible<Ts>...>::value, Ts...>;
+			using storage::storage;
+
+			/**
+			* @brief I番目のフィールドの構築
+			* @detail 事前条件として、I番目のフィールドが無効であること（呼び出し側で保証する）
+			* @return 構築したフィールドへの参照
+			*/
+			template<std::size_t I, typename... Args>
+			auto construct(Args&&... args) noexcept(std::is_nothrow_constructible<typename storage::template type<I>, Args&&...>::value) -> typename storage::template type<I>& {
+				auto& v = detail::construct_at(this->template ptr<I>(), std::forward<Args>(args)...);
+				this->mask() |= static_cast<typename storage::mask_type>(typename storage::mask_type(1) << I);
+				return v;
+			}
+
+			/**
+			* @brief 他optional_pack<Ts...>からのコピー/ムーブ構築
+			* @detail 事前条件として、全フィールドが無効であること（呼び出し側で保証する）
+			* @detail 途中で例外が投げられた場合、構築済みのフィールドはデストラクタで破棄される
+			*/
+			template<typename Pack>
+			void construct_from_other(Pack&& that) {
+				pack_for_each(std::index_sequence_for<Ts...>{}, [this, &that](auto i) {
+					constexpr std::size_t I = decltype(i)::value;
+					using field = typename storage::template type<I>;
+
+					if (that.template test<I>()) {
+						this->template construct<I>(static_cast<pack_forward_t<Pack, field>>(*that.template ptr<I>()));
+					}
+				});
+			}
+
+			/**
+			* @brief 他optional_pack<Ts...>からのコピー/ムーブ代入
+			*/
+			template<typename Pack>
+			void assign_from_other(Pack&& that) {
+				pack_for_each(std::index_sequence_for<Ts...>{}, [this, &that](auto i) {
+					constexpr std::size_t I = decltype(i)::value;
+					using field = typename storage::template type<I>;
+
+					if (that.template test<I>()) {
+						if (this->template test<I>()) {
+							*this->template ptr<I>() = static_cast<pack_forward_t<Pack, field>>(*that.template ptr<I>());
+						}
+						else {
+							this->template construct<I>(static_cast<pack_forward_t<Pack, field>>(*that.template ptr<I>()));
+						}
+					}
+					else {
+						this->template destroy<I>();
+					}
+				});
+			}
+		};
+	}
+
+	/**
+	* @brief 複数のoptionalなフィールドを、1つの有無のビットマスクと共に保持する型
+	* @detail optional<T>を並べた構造体と異なり、フィールドごとの有効値フラグとパディングを持たない
+	* @detail フィールドはアラインメントの降順に並べ替えて配置される（get<I>等の添え字は宣言順）
+	* @detail optionalと同じ層構造によって特殊メンバ関数を定義する、Ts...が全てtrivially copyableならば、optional_packもtrivially copyableとなる
+	* @detail 定数式中では利用できない
+	* @tparam Ts フィールドの型、64個まで
+	*/
+	template<typename... Ts>
+	class optional_pack : private detail::enable_special_menber_functions<detail::optional_pack_common_base<Ts...>, detail::optional_pack_members<Ts...>> {
+
+		using base_storage = detail::enable_special_menber_functions<detail::optional_pack_common_base<Ts...>, detail::optional_pack_members<Ts...>>;
+
+	public:
+
+		static_assert(std::conjunction<std::is_object<Ts>..., std::negation<std::is_array<Ts>>..., std::negation<std::is_const<Ts>>..., std::is_nothrow_destructible<Ts>...>::value, "Ts shall be non-const non-array object types and shall satisfy the requirements of Destructible.");
+		static_assert(std::conjunction<std::negation<std::is_same<std::remove_cv_t<Ts>, nullopt_t>>..., std::negation<std::is_same<std::remove_cv_t<Ts>, in_place_t>>...>::value, "Ts shall not be a tag type.");
+		static_assert(0 < sizeof...(Ts) && sizeof...(Ts) <= 64, "The number of fields shall be between 1 and 64.");
+
+		/**
+		* @brief フィールドの有無を表すビットマスクの型
+		* @detail 宣言順でI番目のフィールドがビットIに対応する
+		*/
+		using mask_type = detail::pack_mask_t<sizeof...(Ts)>;
+
+		/**
+		* @brief 宣言順でI番目のフィールドの型
+		*/
+		template<std::size_t I>
+		using element_type = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+		/**
+		* @brief 全てのフィールドが無効な状態で構築
+		*/
+		optional_pack() noexcept : base_storage{ nullopt }
+		{}
+
+		optional_pack(nullopt_t) noexcept : base_storage{ nullopt }
+		{}
+
+		/**
+		* @brief コピーコンストラクタ
+		* @detail Ts...が全てtrivially copy constructibleであればtrivial
+		*/
+		optional_pack(const optional_pack&) = default;
+
+		/**
+		* @brief ムーブコンストラクタ
+		* @detail Ts...が全てtrivially move constructibleであればtrivial
+		* @detail noexceptはTs...のムーブコンストラクタに従う
+		*/
+		optional_pack(optional_pack&&) = default;
+
+		optional_pack& operator=(const optional_pack&) = default;
+		optional_pack& operator=(optional_pack&&) = default;
+
+		/**
+		* @brief 全てのフィールドを無効にする
+		*/
+		optional_pack& operator=(nullopt_t) noexcept {
+			this->reset();
+			return *this;
+		}
+
+		/**
+		* @brief フィールドの数
+		*/
+		static constexpr std::size_t size() noexcept {
+			return sizeof...(Ts);
+		}
+
+		/**
+		* @brief 全フィールドの有無を表すビットマスク
+		*/
+		mask_type mask() const noexcept {
+			return base_storage::mask();
+		}
+
+		template<std::size_t I>
+		bool has_value() const noexcept {
+			static_assert(I < sizeof...(Ts), "index out of range");
+			return base_storage::template test<I>();
+		}
+
+		/**
+		* @brief 全てのフィールドが有効か
+		*/
+		bool all() const noexcept {
+			return this->mask() == all_bits();
+		}
+
+		/**
+		* @brief いずれかのフィールドが有効か
+		*/
+		bool any() const noexcept {
+			return this->mask() != 0;
+		}
+
+		/**
+		* @brief 全てのフィールドが無効か
+		*/
+		bool none() const noexcept {
+			return this->mask() == 0;
+		}
+
+		/**
+		* @brief 指定した全てのフィールドが有効か
+		* @detail ビットマスクに対する1回の検査で判定する
+		*/
+		template<std::size_t... I>
+		bool all_of() const noexcept {
+			static_assert(std::conjunction<std::integral_constant<bool, (I < sizeof...(Ts))>...>::value, "index out of range");
+			return (this->mask() & bits<I...>()) == bits<I...>();
+		}
+
+		/**
+		* @brief 指定したフィールドのいずれかが有効か
+		* @detail ビットマスクに対する1回の検査で判定する
+		*/
+		template<std::size_t... I>
+		bool any_of() const noexcept {
+			static_assert(std::conjunction<std::integral_constant<bool, (I < sizeof...(Ts))>...>::value, "index out of range");
+			return (this->mask() & bits<I...>()) != 0;
+		}
+
+		/**
+		* @brief I番目のフィールドへの参照をoptional<T&>で返す
+		*/
+		template<std::size_t I>
+		auto get() & noexcept -> optional<element_type<I>&> {
+			return this->template has_value<I>() ? optional<element_type<I>&>{ *base_storage::template ptr<I>() } : optional<element_type<I>&>{};
+		}
+
+		template<std::size_t I>
+		auto get() const & noexcept -> optional<const element_type<I>&> {
+			return this->template has_value<I>() ? optional<const element_type<I>&>{ *base_storage::template ptr<I>() } : optional<const element_type<I>&>{};
+		}
+
+		/**
+		* @brief I番目のフィールドの値を返す
+		* @detail 無効な場合はbad_optional_accessを投げる（例外を用いない設定ではbad_access_handlerを呼び出して停止する）
+		*/
+		template<std::size_t I>
+		auto value() & -> element_type<I>& {
+			return (this->template has_value<I>()) ? *base_storage::template ptr<I>() : (detail::raise_bad_access<bad_optional_access>(), *base_storage::template ptr<I>());
+		}
+
+		template<std::size_t I>
+		auto value() const & -> const element_type<I>& {
+			return (this->template has_value<I>()) ? *base_storage::template ptr<I>() : (detail::raise_bad_access<bad_optional_access>(), *base_storage::template ptr<I>());
+		}
+
+		template<std::size_t I>
+		auto value() && -> element_type<I>&& {
+			return std::move(this->template value<I>());
+		}
+
+		/**
+		* @brief I番目のフィールドに値を直接構築する
+		* @detail 既に有効値を保持していた場合は破棄してから構築する、構築中に例外が投げられた場合は無効となる
+		* @return 構築したフィールドへの参照
+		*/
+		template<std::size_t I, typename... Args>
+		auto emplace(Args&&... args) noexcept(std::is_nothrow_constructible<element_type<I>, Args&&...>::value) -> element_type<I>& {
+			static_assert(I < sizeof...(Ts), "index out of range");
+			base_storage::template destroy<I>();
+			return base_storage::template construct<I>(std::forward<Args>(args)...);
+		}
+
+		/**
+		* @brief I番目のフィールドを無効にする
+		*/
+		template<std::size_t I>
+		void reset() noexcept {
+			static_assert(I < sizeof...(Ts), "index out of range");
+			base_storage::template destroy<I>();
+		}
+
+		/**
+		* @brief 全てのフィールドを無効にする
+		*/
+		void reset() noexcept {
+			base_storage::destroy_all();
+		}
+
+		/**
+		* @brief 各フィールドを交換する
+		* @detail Ts...が全てtrivially copyableならば、領域全体を交換する
+		*/
+		void swap(optional_pack& other) noexcept(std::conjunction<std::is_nothrow_move_constructible<Ts>..., is_nothrow_swappable<Ts>...>::value) {
+			this->swap_impl(other, std::is_trivially_copyable<detail::optional_pack_members<Ts...>>{});
+		}
+
+	private:
+
+		static constexpr mask_type all_bits() noexcept {
+			return static_cast<mask_type>(~std::uint64_t(0) >> (64 - sizeof...(Ts)));
+		}
+
+		template<std::size_t... I>
+		static constexpr mask_type bits() noexcept {
+			return static_cast<mask_type>(detail::pack_bits(I...));
+		}
+
+		void swap_impl(optional_pack& other, std::true_type) noexcept {
+			optional_pack tmp = *this;
+			*this = other;
+			other = tmp;
+		}
+
+		void swap_impl(optional_pack& other, std::false_type) {
+			detail::pack_for_each(std::index_sequence_for<Ts...>{}, [this, &other](auto i) {
+				constexpr std::size_t I = decltype(i)::value;
+
+				if (this->template has_value<I>() && other.template has_value<I>()) {
+					using std::swap;
+					swap(*this->template ptr<I>(), *other.template ptr<I>());
+				}
+				else if (this->template has_value<I>()) {
+					other.template construct<I>(std::move(*this->template ptr<I>()));
+					this->template destroy<I>();
+				}
+				else if (other.template has_value<I>()) {
+					this->template construct<I>(std::move(*other.template ptr<I>()));
+					other.template destroy<I>();
+				}
+			});
+		}
+	};
+
+	/**
+	* @brief I番目のフィールドへの参照をoptional<T&>で返す
+	*/
+	template<std::size_t I, typename... Ts>
+	auto get(optional_pack<Ts...>& pack) noexcept -> optional<typename optional_pack<Ts...>::template element_type<I>&> {
+		return pack.template get<I>();
+	}
+
+	template<std::size_t I, typename... Ts>
+	auto get(const optional_pack<Ts...>& pack) noexcept -> optional<const typename optional_pack<Ts...>::template element_type<I>&> {
+		return pack.template get<I>();
+	}
+
+	template<typename... Ts>
+	void swap(optional_pack<Ts...>& x, optional_pack<Ts...>& y) noexcept(noexcept(x.swap(y))) {
+		x.swap(y);
+	}
+
+	template<typename... Ts>
+	struct is_trivially_relocatable<optional_pack<Ts...>> : std::conjunction<is_trivially_relocatable<Ts>...> {};
+}
\ No newline at end of file
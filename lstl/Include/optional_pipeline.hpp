@@ -0,0 +1,338 @@
+﻿#pragma once
+
+#include <type_traits>
+#include <cstddef>
+#include <utility>
+#include <tuple>
+#include <functional>
+
+#include "optional.hpp"
+
+namespace lstl {
+
+	template<typename Source, typename... Stages>
+	class optional_pipeline;
+
+	namespace detail {
+
+		/**
+		* @brief 値に関数を適用する段（transform相当）
+		*/
+		template<typename F>
+		struct map_stage {
+			F func;
+
+			//値Vにこの段を適用した結果の値の型
+			template<typename V>
+			using next_t = decltype(std::invoke(std::declval<F&>(), std::declval<V>()));
+		};
+
+		/**
+		* @brief optionalを返す関数を適用する段（and_then相当）
+		*/
+		template<typename F>
+		struct then_stage {
+			F func;
+
+			template<typename V>
+			using next_t = decltype(*std::declval<decltype(std::invoke(std::declval<F&>(), std::declval<V>()))>());
+		};
+
+		/**
+		* @brief 無効値の場合の値を与える終端（value_or相当）
+		*/
+		template<typename U>
+		struct value_or_stage {
+			U value;
+		};
+
+		/**
+		* @brief 無効値の場合に関数を実行する終端（or_else相当）
+		*/
+		template<typename F>
+		struct or_else_stage {
+			F func;
+		};
+
+		template<typename T>
+		struct is_pipeline_stage : std::false_type {};
+
+		template<typename F>
+		struct is_pipeline_stage<map_stage<F>> : std::true_type {};
+
+		template<typename F>
+		struct is_pipeline_stage<then_stage<F>> : std::true_type {};
+
+		/**
+		* @brief 値Vに[I, N)の段を適用した結果の値の型
+		*/
+		template<typename Stages, std::size_t I, typename V, bool = (I == std::tuple_size<Stages>::value)>
+		struct pipeline_value {
+			using type = V;
+		};
+
+		template<typename Stages, std::size_t I, typename V>
+		struct pipeline_value<Stages, I, V, false> : pipeline_value<Stages, I + 1, typename std::tuple_element_t<I, Stages>::template next_t<V>> {};
+
+		/**
+		* @brief パイプラインの結果をoptional<R>として返す
+		*/
+		template<typename R>
+		struct optional_sink {
+			using result_type = optional<R>;
+
+			//最後の段がmapの場合、結果の領域に直接構築する
+			template<typename F, typename V>
+			result_type invoke(F& func, V&& v) {
+				return result_type{ in_place_invoke, func, std::forward<V>(v) };
+			}
+
+			//最後の段がthenの場合、関数の戻り値をそのまま返す
+			template<typename F, typename V>
+			result_type invoke_optional(F& func, V&& v) {
+				return std::invoke(func, std::forward<V>(v));
+			}
+
+			template<typename V>
+			result_type value(V&& v) {
+				return result_type{ in_place, std::forward<V>(v) };
+			}
+
+			result_type empty() {
+				return result_type{};
+			}
+		};
+
+		/**
+		* @brief パイプラインの結果をRとして返す、無効値の場合はfallback
+		*/
+		template<typename R, typename U>
+		struct value_or_sink {
+			using result_type = R;
+
+			U& fallback;
+
+			template<typename F, typename V>
+			result_type invoke(F& func, V&& v) {
+				return std::invoke(func, std::forward<V>(v));
+			}
+
+			template<typename F, typename V>
+			result_type invoke_optional(F& func, V&& v) {
+				auto&& r = std::invoke(func, std::forward<V>(v));
+				return r.has_value() ? static_cast<R>(*std::forward<decltype(r)>(r)) : static_cast<R>(std::move(fallback));
+			}
+
+			template<typename V>
+			result_type value(V&& v) {
+				return static_cast<R>(std::forward<V>(v));
+			}
+
+			result_type empty() {
+				return static_cast<R>(std::move(fallback));
+			}
+		};
+
+		/**
+		* @brief パイプラインの結果をoptional<R>として返す、無効値の場合はfunc()
+		*/
+		template<typename R, typename G>
+		struct or_else_sink : optional_sink<R> {
+			G& func;
+
+			explicit or_else_sink(G& g) : func(g) {}
+
+			//最後の段がthenの場合も、その戻り値が無効値ならばfunc()
+			template<typename F, typename V>
+			optional<R> invoke_optional(F& f, V&& v) {
+				optional<R> r = std::invoke(f, std::forward<V>(v));
+				if (r.has_value() == false) {
+					return std::invoke(func);
+				}
+				return r;
+			}
+
+			optional<R> empty() {
+				return std::invoke(func);
+			}
+		};
+	}
+
+	/**
+	* @brief optionalに対する関数適用の連鎖を、評価時まで遅延させたもの
+	* @detail optional | lstl::then(f) | lstl::map(g) | lstl::value_or(x) のように構築する
+	* @detail 有効値の有無の検査は元のoptionalとthenの戻り値に対してのみ行い、mapの連鎖では中間のoptionalを作らない
+	* @detail 最後のmapの戻り値は結果のoptionalの領域に直接構築される（コピー省略）
+	* @detail 元のoptionalを参照で保持するので、同じ完全式の中で評価すること
+	* @tparam Source 元のoptionalへの参照型（Source&&で保持する）
+	* @tparam Stages 適用する段（map_stage、then_stage）
+	*/
+	template<typename Source, typename... Stages>
+	class optional_pipeline {
+		using stages_type = std::tuple<Stages...>;
+		using source_value = decltype(*std::declval<Source&&>());
+
+		static constexpr std::size_t stage_count = sizeof...(Stages);
+
+		template<std::size_t I>
+		using index = std::integral_constant<std::size_t, I>;
+
+		Source&& m_source;
+		stages_type m_stages;
+
+		template<typename S, typename... Ss>
+		friend class optional_pipeline;
+
+		//最後の段
+		template<typename Sink, std::size_t I, typename V, typename F>
+		static auto apply(Sink& sink, stages_type& stages, index<I>, std::true_type, V&& v, detail::map_stage<F>&) -> typename Sink::result_type {
+			return sink.invoke(std::get<I>(stages).func, std::forward<V>(v));
+		}
+
+		template<typename Sink, std::size_t I, typename V, typename F>
+		static auto apply(Sink& sink, stages_type& stages, index<I>, std::true_type, V&& v, detail::then_stage<F>&) -> typename Sink::result_type {
+			return sink.invoke_optional(std::get<I>(stages).func, std::forward<V>(v));
+		}
+
+		//途中の段、戻り値を一時オブジェクトのまま次の段へ渡す
+		template<typename Sink, std::size_t I, typename V, typename F>
+		static auto apply(Sink& sink, stages_type& stages, index<I>, std::false_type, V&& v, detail::map_stage<F>&) -> typename Sink::result_type {
+			return run(sink, stages, index<I + 1>{}, std::invoke(std::get<I>(stages).func, std::forward<V>(v)));
+		}
+
+		template<typename Sink, std::size_t I, typename V, typename F>
+		static auto apply(Sink& sink, stages_type& stages, index<I>, std::false_type, V&& v, detail::then_stage<F>&) -> typename Sink::result_type {
+			auto&& r = std::invoke(std::get<I>(stages).func, std::forward<V>(v));
+
+			if (r.has_value() == false) {
+				return sink.empty();
+			}
+			return run(sink, stages, index<I + 1>{}, *std::forward<decltype(r)>(r));
+		}
+
+		template<typename Sink, std::size_t I, typename V>
+		static auto run(Sink& sink, stages_type& stages, index<I>, V&& v) -> typename Sink::result_type {
+			return apply(sink, stages, index<I>{}, std::integral_constant<bool, I + 1 == stage_count>{}, std::forward<V>(v), std::get<I>(stages));
+		}
+
+		//段が無い場合
+		template<typename Sink, typename V>
+		static auto run(Sink& sink, stages_type&, index<stage_count>, V&& v) -> typename Sink::result_type {
+			return sink.value(std::forward<V>(v));
+		}
+
+		template<typename Sink>
+		auto evaluate(Sink&& sink) -> typename std::decay_t<Sink>::result_type {
+			if (m_source.has_value() == false) {
+				return sink.empty();
+			}
+			return run(sink, m_stages, index<0>{}, *std::forward<Source>(m_source));
+		}
+
+	public:
+
+		/**
+		* @brief 全ての段を適用した結果の値の型
+		*/
+		using value_type = std::decay_t<typename detail::pipeline_value<stages_type, 0, source_value>::type>;
+
+		optional_pipeline(Source&& source, stages_type&& stages)
+			: m_source(std::forward<Source>(source))
+			, m_stages(std::move(stages))
+		{}
+
+		optional_pipeline(const optional_pipeline&) = delete;
+		optional_pipeline& operator=(const optional_pipeline&) = delete;
+
+		/**
+		* @brief 評価してoptionalを得る
+		* @return 全ての段で有効値が得られればその値、そうでないならnullopt
+		*/
+		optional<value_type> evaluate() && {
+			return evaluate(detail::optional_sink<value_type>{});
+		}
+
+		/**
+		* @brief 評価してoptionalを得る
+		*/
+		operator optional<value_type>() && {
+			return evaluate(detail::optional_sink<value_type>{});
+		}
+
+		/**
+		* @brief 段を追加する
+		*/
+		template<typename Stage, optional_traits::enabler<detail::is_pipeline_stage<Stage>> = nullptr>
+		friend auto operator|(optional_pipeline&& p, Stage stage) -> optional_pipeline<Source, Stages..., Stage> {
+			return optional_pipeline<Source, Stages..., Stage>{ std::forward<Source>(p.m_source), std::tuple_cat(std::move(p.m_stages), std::make_tuple(std::move(stage))) };
+		}
+
+		/**
+		* @brief 評価し、無効値であればstage.valueを返す
+		*/
+		template<typename U>
+		friend value_type operator|(optional_pipeline&& p, detail::value_or_stage<U> stage) {
+			return p.evaluate(detail::value_or_sink<value_type, U>{ stage.value });
+		}
+
+		/**
+		* @brief 評価し、無効値であればstage.func()を返す
+		*/
+		template<typename G>
+		friend optional<value_type> operator|(optional_pipeline&& p, detail::or_else_stage<G> stage) {
+			return p.evaluate(detail::or_else_sink<value_type, G>{ stage.func });
+		}
+	};
+
+	/**
+	* @brief optionalからパイプラインを始める
+	*/
+	template<typename Opt, typename Stage, optional_traits::enabler<detail::is_optional<std::decay_t<Opt>>, detail::is_pipeline_stage<Stage>> = nullptr>
+	auto operator|(Opt&& opt, Stage stage) -> optional_pipeline<Opt&&, Stage> {
+		return optional_pipeline<Opt&&, Stage>{ std::forward<Opt>(opt), std::make_tuple(std::move(stage)) };
+	}
+
+	template<typename Opt, typename U, optional_traits::enabler<detail::is_optional<std::decay_t<Opt>>> = nullptr>
+	auto operator|(Opt&& opt, detail::value_or_stage<U> stage) -> typename optional_pipeline<Opt&&>::value_type {
+		return optional_pipeline<Opt&&>{ std::forward<Opt>(opt), std::tuple<>{} } | std::move(stage);
+	}
+
+	template<typename Opt, typename G, optional_traits::enabler<detail::is_optional<std::decay_t<Opt>>> = nullptr>
+	auto operator|(Opt&& opt, detail::or_else_stage<G> stage) -> optional<typename optional_pipeline<Opt&&>::value_type> {
+		return optional_pipeline<Opt&&>{ std::forward<Opt>(opt), std::tuple<>{} } | std::move(stage);
+	}
+
+	/**
+	* @brief 有効値に関数を適用する段（transform）
+	* @param func 値を受けて新しい値を返す関数
+	*/
+	template<typename F>
+	auto map(F&& func) -> detail::map_stage<std::decay_t<F>> {
+		return { std::forward<F>(func) };
+	}
+
+	/**
+	* @brief 有効値にoptionalを返す関数を適用する段（and_then）
+	* @param func 値を受けてoptionalを返す関数
+	*/
+	template<typename F>
+	auto then(F&& func) -> detail::then_stage<std::decay_t<F>> {
+		return { std::forward<F>(func) };
+	}
+
+	/**
+	* @brief パイプラインを評価し、無効値であればvを返す終端
+	*/
+	template<typename U>
+	auto value_or(U&& v) -> detail::value_or_stage<std::decay_t<U>> {
+		return { std::forward<U>(v) };
+	}
+
+	/**
+	* @brief パイプラインを評価し、無効値であればfunc()の戻り値（optional）を返す終端
+	*/
+	template<typename F>
+	auto or_else(F&& func) -> detail::or_else_stage<std::decay_t<F>> {
+		return { std::forward<F>(func) };
+	}
+}
\ No newline at end of file
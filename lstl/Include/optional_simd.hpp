@@ -0,0 +1,550 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include <limits>
+#include <algorithm>
+
+#include "optional.hpp"
+#include "optional_vector.hpp"
+
+//利用可能な命令セットの判定
+#if defined(__AVX2__)
+#define LSTL_SIMD_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LSTL_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace lstl {
+
+	/**
+	* @brief 算術型のoptionalの列に対する一括処理
+	* @detail 有効値ビットマップを持つ列（optional_vector、あるいは値配列とビットマップの組）に対してはSSE2/AVX2を用いる
+	* @detail optional<T>の配列に対しては、分岐を選択に置き換えたスカラ処理を行う
+	* @detail ビットマップの形式はoptional_vector::bitmap()と同じ、無効値の位置の値は初期化済みであること
+	*/
+	namespace simd {
+
+		namespace detail {
+
+			/**
+			* @brief SIMDレジスタ操作の型ごとの実装
+			* @detail 対応する命令が無い型はstd::false_typeとなり、スカラ処理にフォールバックする
+			*/
+			template<typename T>
+			struct vector_traits : std::false_type {};
+
+#if defined(LSTL_SIMD_AVX2)
+
+			template<>
+			struct vector_traits<double> : std::true_type {
+				using vec = __m256d;
+				static constexpr std::size_t lanes = 4;
+
+				static vec load(const double* p) noexcept { return _mm256_loadu_pd(p); }
+				static void store(double* p, vec v) noexcept { _mm256_storeu_pd(p, v); }
+				static vec set1(double v) noexcept { return _mm256_set1_pd(v); }
+
+				static vec mask(unsigned bits) noexcept {
+					const __m256i sel = _mm256_setr_epi64x(1, 2, 4, 8);
+					return _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(bits), sel), sel));
+				}
+
+				static vec select(vec m, vec a, vec b) noexcept { return _mm256_blendv_pd(b, a, m); }
+				static vec add(vec a, vec b) noexcept { return _mm256_add_pd(a, b); }
+				static vec min(vec a, vec b) noexcept { return _mm256_min_pd(a, b); }
+				static vec max(vec a, vec b) noexcept { return _mm256_max_pd(a, b); }
+			};
+
+			template<>
+			struct vector_traits<float> : std::true_type {
+				using vec = __m256;
+				static constexpr std::size_t lanes = 8;
+
+				static vec load(const float* p) noexcept { return _mm256_loadu_ps(p); }
+				static void store(float* p, vec v) noexcept { _mm256_storeu_ps(p, v); }
+				static vec set1(float v) noexcept { return _mm256_set1_ps(v); }
+
+				static vec mask(unsigned bits) noexcept {
+					const __m256i sel = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+					return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int>(bits)), sel), sel));
+				}
+
+				static vec select(vec m, vec a, vec b) noexcept { return _mm256_blendv_ps(b, a, m); }
+				static vec add(vec a, vec b) noexcept { return _mm256_add_ps(a, b); }
+				static vec min(vec a, vec b) noexcept { return _mm256_min_ps(a, b); }
+				static vec max(vec a, vec b) noexcept { return _mm256_max_ps(a, b); }
+			};
+
+			template<>
+			struct vector_traits<std::int32_t> : std::true_type {
+				using vec = __m256i;
+				static constexpr std::size_t lanes = 8;
+
+				static vec load(const std::int32_t* p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+				static void store(std::int32_t* p, vec v) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+				static vec set1(std::int32_t v) noexcept { return _mm256_set1_epi32(v); }
+
+				static vec mask(unsigned bits) noexcept {
+					const __m256i sel = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+					return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int>(bits)), sel), sel);
+				}
+
+				static vec select(vec m, vec a, vec b) noexcept { return _mm256_blendv_epi8(b, a, m); }
+				static vec add(vec a, vec b) noexcept { return _mm256_add_epi32(a, b); }
+				static vec min(vec a, vec b) noexcept { return _mm256_min_epi32(a, b); }
+				static vec max(vec a, vec b) noexcept { return _mm256_max_epi32(a, b); }
+			};
+
+			template<>
+			struct vector_traits<std::int64_t> : std::true_type {
+				using vec = __m256i;
+				static constexpr std::size_t lanes = 4;
+
+				static vec load(const std::int64_t* p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+				static void store(std::int64_t* p, vec v) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+				static vec set1(std::int64_t v) noexcept { return _mm256_set1_epi64x(v); }
+
+				static vec mask(unsigned bits) noexcept {
+					const __m256i sel = _mm256_setr_epi64x(1, 2, 4, 8);
+					return _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(bits), sel), sel);
+				}
+
+				static vec select(vec m, vec a, vec b) noexcept { return _mm256_blendv_epi8(b, a, m); }
+				static vec add(vec a, vec b) noexcept { return _mm256_add_epi64(a, b); }
+				//AVX2には64bit整数のmin/maxが無い
+				static vec min(vec a, vec b) noexcept { return select(_mm256_cmpgt_epi64(a, b), b, a); }
+				static vec max(vec a, vec b) noexcept { return select(_mm256_cmpgt_epi64(a, b), a, b); }
+			};
+
+#elif defined(LSTL_SIMD_SSE2)
+
+			template<>
+			struct vector_traits<double> : std::true_type {
+				using vec = __m128d;
+				static constexpr std::size_t lanes = 2;
+
+				static vec load(const double* p) noexcept { return _mm_loadu_pd(p); }
+				static void store(double* p, vec v) noexcept { _mm_storeu_pd(p, v); }
+				static vec set1(double v) noexcept { return _mm_set1_pd(v); }
+
+				static vec mask(unsigned bits) noexcept {
+					return _mm_castsi128_pd(_mm_set_epi32(-static_cast<int>((bits >> 1) & 1), -static_cast<int>((bits >> 1) & 1), -static_cast<int>(bits & 1), -static_cast<int>(bits & 1)));
+				}
+
+				//SSE2にはblendが無い
+				static vec select(vec m, vec a, vec b) noexcept { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+				static vec add(vec a, vec b) noexcept { return _mm_add_pd(a, b); }
+				static vec min(vec a, vec b) noexcept { return _mm_min_pd(a, b); }
+				static vec max(vec a, vec b) noexcept { return _mm_max_pd(a, b); }
+			};
+
+			template<>
+			struct vector_traits<float> : std::true_type {
+				using vec = __m128;
+				static constexpr std::size_t lanes = 4;
+
+				static vec load(const float* p) noexcept { return _mm_loadu_ps(p); }
+				static void store(float* p, vec v) noexcept { _mm_storeu_ps(p, v); }
+				static vec set1(float v) noexcept { return _mm_set1_ps(v); }
+
+				static vec mask(unsigned bits) noexcept {
+					const __m128i sel = _mm_setr_epi32(1, 2, 4, 8);
+					return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(static_cast<int>(bits)), sel), sel));
+				}
+
+				static vec select(vec m, vec a, vec b) noexcept { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+				static vec add(vec a, vec b) noexcept { return _mm_add_ps(a, b); }
+				static vec min(vec a, vec b) noexcept { return _mm_min_ps(a, b); }
+				static vec max(vec a, vec b) noexcept { return _mm_max_ps(a, b); }
+			};
+
+			template<>
+			struct vector_traits<std::int32_t> : std::true_type {
+				using vec = __m128i;
+				static constexpr std::size_t lanes = 4;
+
+				static vec load(const std::int32_t* p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+				static void store(std::int32_t* p, vec v) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+				static vec set1(std::int32_t v) noexcept { return _mm_set1_epi32(v); }
+
+				static vec mask(unsigned bits) noexcept {
+					const __m128i sel = _mm_setr_epi32(1, 2, 4, 8);
+					return _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(static_cast<int>(bits)), sel), sel);
+				}
+
+				static vec select(vec m, vec a, vec b) noexcept { return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+				static vec add(vec a, vec b) noexcept { return _mm_add_epi32(a, b); }
+				//SSE2には32bit整数のmin/maxが無い
+				static vec min(vec a, vec b) noexcept { return select(_mm_cmpgt_epi32(a, b), b, a); }
+				static vec max(vec a, vec b) noexcept { return select(_mm_cmpgt_epi32(a, b), a, b); }
+			};
+
+#endif
+
+			/**
+			* @brief 要素iから始まるlanes個分の有効値ビットを取り出す
+			* @detail lanesは64の約数であり、iはlanesの倍数であること
+			*/
+			template<std::size_t Lanes>
+			inline unsigned lane_bits(const std::uint64_t* bits, std::size_t i) noexcept {
+				return static_cast<unsigned>((bits[i / 64] >> (i % 64)) & ((std::uint64_t(1) << Lanes) - 1));
+			}
+
+			inline bool test(const std::uint64_t* bits, std::size_t i) noexcept {
+				return lstl::detail::bitmap::test(bits, i);
+			}
+
+			/**
+			* @brief SIMDレジスタ1本分の値を、スカラ値の配列として畳み込む
+			*/
+			template<typename V, typename T, typename Op>
+			T reduce(typename V::vec v, Op op) noexcept {
+				T lanes[V::lanes];
+				V::store(lanes, v);
+
+				T result = lanes[0];
+				for (std::size_t i = 1; i < V::lanes; ++i) {
+					result = op(result, lanes[i]);
+				}
+				return result;
+			}
+
+			template<typename T>
+			struct plus_op {
+				T operator()(T a, T b) const noexcept { return a + b; }
+			};
+
+			template<typename T>
+			struct min_op {
+				T operator()(T a, T b) const noexcept { return (b < a) ? b : a; }
+			};
+
+			template<typename T>
+			struct max_op {
+				T operator()(T a, T b) const noexcept { return (a < b) ? b : a; }
+			};
+
+			/**
+			* @brief min/maxの単位元
+			*/
+			template<typename T>
+			constexpr T lowest() noexcept {
+				return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+			}
+
+			template<typename T>
+			constexpr T highest() noexcept {
+				return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : (std::numeric_limits<T>::max)();
+			}
+
+			//fill_empty
+
+			template<typename T>
+			void fill_empty(T* values, const std::uint64_t* bits, std::size_t first, std::size_t n, T fill) noexcept {
+				for (std::size_t i = first; i < n; ++i) {
+					values[i] = test(bits, i) ? values[i] : fill;
+				}
+			}
+
+			template<typename T>
+			void fill_empty(T* values, const std::uint64_t* bits, std::size_t n, T fill, std::false_type) noexcept {
+				fill_empty(values, bits, 0, n, fill);
+			}
+
+			template<typename T>
+			void fill_empty(T* values, const std::uint64_t* bits, std::size_t n, T fill, std::true_type) noexcept {
+				using V = vector_traits<T>;
+
+				const auto f = V::set1(fill);
+				std::size_t i = 0;
+
+				for (; i + V::lanes <= n; i += V::lanes) {
+					const auto m = V::mask(lane_bits<V::lanes>(bits, i));
+					V::store(values + i, V::select(m, V::load(values + i), f));
+				}
+
+				fill_empty(values, bits, i, n, fill);
+			}
+
+			//masked reduce
+
+			template<typename T, typename Op>
+			T reduce_present(const T* values, const std::uint64_t* bits, std::size_t first, std::size_t n, T identity, Op op) noexcept {
+				T result = identity;
+				for (std::size_t i = first; i < n; ++i) {
+					result = op(result, test(bits, i) ? values[i] : identity);
+				}
+				return result;
+			}
+
+			template<typename T, typename Op, typename VecOp>
+			T reduce_present(const T* values, const std::uint64_t* bits, std::size_t n, T identity, Op op, VecOp, std::false_type) noexcept {
+				return reduce_present(values, bits, 0, n, identity, op);
+			}
+
+			template<typename T, typename Op, typename VecOp>
+			T reduce_present(const T* values, const std::uint64_t* bits, std::size_t n, T identity, Op op, VecOp vec_op, std::true_type) noexcept {
+				using V = vector_traits<T>;
+
+				const auto id = V::set1(identity);
+				auto acc = id;
+				std::size_t i = 0;
+
+				for (; i + V::lanes <= n; i += V::lanes) {
+					const auto m = V::mask(lane_bits<V::lanes>(bits, i));
+					acc = vec_op(acc, V::select(m, V::load(values + i), id));
+				}
+
+				return op(reduce<V, T>(acc, op), reduce_present(values, bits, i, n, identity, op));
+			}
+
+			template<typename V>
+			struct vec_add {
+				template<typename Vec>
+				Vec operator()(Vec a, Vec b) const noexcept { return V::add(a, b); }
+			};
+
+			template<typename V>
+			struct vec_min {
+				template<typename Vec>
+				Vec operator()(Vec a, Vec b) const noexcept { return V::min(a, b); }
+			};
+
+			template<typename V>
+			struct vec_max {
+				template<typename Vec>
+				Vec operator()(Vec a, Vec b) const noexcept { return V::max(a, b); }
+			};
+
+			template<typename T>
+			using enable_arithmetic = lstl::optional_traits::enabler<std::is_arithmetic<T>>;
+		}
+
+		//有効値ビットマップを持つ列に対する処理
+
+		/**
+		* @brief 有効値の数を数える
+		* @param bits 有効値ビットマップ
+		* @param n 要素数
+		*/
+		inline std::size_t count_present(const std::uint64_t* bits, std::size_t n) noexcept {
+			return lstl::detail::bitmap::count(bits, n);
+		}
+
+		/**
+		* @brief 無効値の位置を指定した値で埋める（一括value_or）
+		* @param values 値配列
+		* @param bits 有効値ビットマップ
+		* @param n 要素数
+		* @param fill 無効値の位置に書き込む値
+		*/
+		template<typename T, detail::enable_arithmetic<T> = nullptr>
+		void fill_empty(T* values, const std::uint64_t* bits, std::size_t n, T fill) noexcept {
+			detail::fill_empty(values, bits, n, fill, detail::vector_traits<T>{});
+		}
+
+		/**
+		* @brief 有効値のみを前に詰めて出力する
+		* @detail ビットマップを走査し、立っているビットの位置の値のみを読む
+		* @param values 値配列
+		* @param bits 有効値ビットマップ
+		* @param n 要素数
+		* @param out 出力先、count_present(bits, n)以上の領域があること
+		* @return 出力した要素数
+		*/
+		template<typename T, detail::enable_arithmetic<T> = nullptr>
+		std::size_t compress(const T* values, const std::uint64_t* bits, std::size_t n, T* out) noexcept {
+			std::size_t count = 0;
+
+			lstl::detail::bitmap::for_each_set(bits, n, [&](std::size_t i) {
+				out[count++] = values[i];
+			});
+
+			return count;
+		}
+
+		/**
+		* @brief 密な配列を、ビットマップに従って展開する（compressの逆操作）
+		* @param dense 有効値のみが並んだ配列、count_present(bits, n)以上の要素があること
+		* @param bits 有効値ビットマップ
+		* @param n 要素数
+		* @param out 出力先、n以上の領域があること
+		* @param fill 無効値の位置に書き込む値
+		* @return 読み込んだdenseの要素数
+		*/
+		template<typename T, detail::enable_arithmetic<T> = nullptr>
+		std::size_t expand(const T* dense, const std::uint64_t* bits, std::size_t n, T* out, T fill) noexcept {
+			std::fill_n(out, n, fill);
+
+			std::size_t count = 0;
+
+			lstl::detail::bitmap::for_each_set(bits, n, [&](std::size_t i) {
+				out[i] = dense[count++];
+			});
+
+			return count;
+		}
+
+		/**
+		* @brief 有効値の総和
+		* @detail 浮動小数点型の場合、加算順序はスカラ処理と異なる
+		* @return 有効値の総和、有効値が無ければT{}
+		*/
+		template<typename T, detail::enable_arithmetic<T> = nullptr>
+		T sum_present(const T* values, const std::uint64_t* bits, std::size_t n) noexcept {
+			using V = detail::vector_traits<T>;
+			return detail::reduce_present(values, bits, n, T{}, detail::plus_op<T>{}, detail::vec_add<V>{}, V{});
+		}
+
+		/**
+		* @brief 有効値の最小値
+		* @detail NaNを含む場合の結果は未規定
+		* @return 有効値の最小値、有効値が無ければnullopt
+		*/
+		template<typename T, detail::enable_arithmetic<T> = nullptr>
+		optional<T> min_present(const T* values, const std::uint64_t* bits, std::size_t n) noexcept {
+			using V = detail::vector_traits<T>;
+
+			if (count_present(bits, n) == 0) return nullopt;
+			return detail::reduce_present(values, bits, n, detail::highest<T>(), detail::min_op<T>{}, detail::vec_min<V>{}, V{});
+		}
+
+		/**
+		* @brief 有効値の最大値
+		* @detail NaNを含む場合の結果は未規定
+		* @return 有効値の最大値、有効値が無ければnullopt
+		*/
+		template<typename T, detail::enable_arithmetic<T> = nullptr>
+		optional<T> max_present(const T* values, const std::uint64_t* bits, std::size_t n) noexcept {
+			using V = detail::vector_traits<T>;
+
+			if (count_present(bits, n) == 0) return nullopt;
+			return detail::reduce_present(values, bits, n, detail::lowest<T>(), detail::max_op<T>{}, detail::vec_max<V>{}, V{});
+		}
+
+		//optional_vectorに対する処理
+
+		template<typename T, typename Allocator>
+		std::size_t count_present(const optional_vector<T, Allocator>& v) noexcept {
+			return v.count();
+		}
+
+		template<typename T, typename Allocator, detail::enable_arithmetic<T> = nullptr>
+		std::size_t compress(const optional_vector<T, Allocator>& v, T* out) noexcept {
+			return (v.empty()) ? 0 : compress(v.data(), v.bitmap(), v.size(), out);
+		}
+
+		template<typename T, typename Allocator, detail::enable_arithmetic<T> = nullptr>
+		T sum_present(const optional_vector<T, Allocator>& v) noexcept {
+			return (v.empty()) ? T{} : sum_present(v.data(), v.bitmap(), v.size());
+		}
+
+		template<typename T, typename Allocator, detail::enable_arithmetic<T> = nullptr>
+		optional<T> min_present(const optional_vector<T, Allocator>& v) noexcept {
+			return (v.empty()) ? optional<T>{} : min_present(v.data(), v.bitmap(), v.size());
+		}
+
+		template<typename T, typename Allocator, detail::enable_arithmetic<T> = nullptr>
+		optional<T> max_present(const optional_vector<T, Allocator>& v) noexcept {
+			return (v.empty()) ? optional<T>{} : max_present(v.data(), v.bitmap(), v.size());
+		}
+
+		//optional<T>の配列に対する処理
+
+		/**
+		* @brief 有効値の数を数える
+		*/
+		template<typename T>
+		std::size_t count_present(const optional<T>* first, std::size_t n) noexcept {
+			std::size_t count = 0;
+			for (std::size_t i = 0; i < n; ++i) {
+				count += static_cast<std::size_t>(first[i].has_value());
+			}
+			return count;
+		}
+
+		/**
+		* @brief 各要素のvalue_or(fill)を出力する
+		* @param out 出力先、n以上の領域があること
+		*/
+		template<typename T, detail::enable_arithmetic<T> = nullptr>
+		void value_or(const optional<T>* first, std::size_t n, T fill, T* out) noexcept {
+			for (std::size_t i = 0; i < n; ++i) {
+				out[i] = first[i].has_value() ? *first[i] : fill;
+			}
+		}
+
+		/**
+		* @brief 有効値のみを前に詰めて出力する
+		* @detail 出力は分岐せずに書き込み、有効値の場合にのみ出力位置を進める
+		* @param out 出力先、n以上の領域があること
+		* @return 出力した要素数
+		*/
+		template<typename T, detail::enable_arithmetic<T> = nullptr>
+		std::size_t compress(const optional<T>* first, std::size_t n, T* out) noexcept {
+			std::size_t count = 0;
+			for (std::size_t i = 0; i < n; ++i) {
+				const bool has = first[i].has_value();
+				out[count] = has ? *first[i] : T{};
+				count += static_cast<std::size_t>(has);
+			}
+			return count;
+		}
+
+		/**
+		* @brief 有効値の総和
+		* @return 有効値の総和、有効値が無ければT{}
+		*/
+		template<typename T, detail::enable_arithmetic<T> = nullptr>
+		T sum_present(const optional<T>* first, std::size_t n) noexcept {
+			T result{};
+			for (std::size_t i = 0; i < n; ++i) {
+				result += first[i].has_value() ? *first[i] : T{};
+			}
+			return result;
+		}
+
+		/**
+		* @brief 有効値の最小値
+		* @return 有効値の最小値、有効値が無ければnullopt
+		*/
+		template<typename T, detail::enable_arithmetic<T> = nullptr>
+		optional<T> min_present(const optional<T>* first, std::size_t n) noexcept {
+			T result = detail::highest<T>();
+			bool found = false;
+
+			for (std::size_t i = 0; i < n; ++i) {
+				const bool has = first[i].has_value();
+				result = detail::min_op<T>{}(result, has ? *first[i] : result);
+				found |= has;
+			}
+
+			return found ? optional<T>{ result } : optional<T>{};
+		}
+
+		/**
+		* @brief 有効値の最大値
+		* @return 有効値の最大値、有効値が無ければnullopt
+		*/
+		template<typename T, detail::enable_arithmetic<T> = nullptr>
+		optional<T> max_present(const optional<T>* first, std::size_t n) noexcept {
+			T result = detail::lowest<T>();
+			bool found = false;
+
+			for (std::size_t i = 0; i < n; ++i) {
+				const bool has = first[i].has_value();
+				result = detail::max_op<T>{}(result, has ? *first[i] : result);
+				found |= has;
+			}
+
+			return found ? optional<T>{ result } : optional<T>{};
+		}
+	}
+}
+
+#undef LSTL_SIMD_AVX2
+#undef LSTL_SIMD_SSE2
\ No newline at end of file
@@ -0,0 +1,772 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+
+#include "config.hpp"
+#include "optional.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif // defined(_MSC_VER)
+
+namespace lstl {
+
+	namespace detail {
+
+		/**
+		* @brief 有効値ビットマップ操作の補助関数群
+		* @detail 1ワード64要素、LSBが若い添え字に対応する
+		*/
+		namespace bitmap {
+
+			using word_type = std::uint64_t;
+
+			constexpr std::size_t word_bits = 64;
+
+			/**
+			* @brief n要素を保持するのに必要なワード数
+			*/
+			constexpr std::size_t word_count(std::size_t n) noexcept {
+				return (n + word_bits - 1) / word_bits;
+			}
+
+			/**
+			* @brief 立っているビットの数を数える
+			*/
+			inline int popcount(word_type w) noexcept {
+#if defined(_MSC_VER) && defined(_M_X64)
+				return static_cast<int>(__popcnt64(w));
+#elif defined(__GNUC__)
+				return __builtin_popcountll(w);
+#else
+				int count = 0;
+				for (; w != 0; w &= w - 1) ++count;
+				return count;
+#endif
+			}
+
+			/**
+			* @brief 最下位の立っているビットの位置を返す
+			* @detail 事前条件として、w != 0 であること
+			*/
+			inline int countr_zero(word_type w) noexcept {
+#if defined(_MSC_VER) && defined(_M_X64)
+				unsigned long index;
+				_BitScanForward64(&index, w);
+				return static_cast<int>(index);
+#elif defined(__GNUC__)
+				return __builtin_ctzll(w);
+#else
+				int index = 0;
+				for (; (w & 1) == 0; w >>= 1) ++index;
+				return index;
+#endif
+			}
+
+			inline bool test(const word_type* bits, std::size_t i) noexcept {
+				return (bits[i / word_bits] >> (i % word_bits)) & 1;
+			}
+
+			inline void set(word_type* bits, std::size_t i) noexcept {
+				bits[i / word_bits] |= word_type(1) << (i % word_bits);
+			}
+
+			inline void clear(word_type* bits, std::size_t i) noexcept {
+				bits[i / word_bits] &= ~(word_type(1) << (i % word_bits));
+			}
+
+			/**
+			* @brief 先頭n要素中の立っているビットの数を数える
+			*/
+			inline std::size_t count(const word_type* bits, std::size_t n) noexcept {
+				std::size_t result = 0;
+				const std::size_t full = n / word_bits;
+
+				for (std::size_t w = 0; w < full; ++w) {
+					result += popcount(bits[w]);
+				}
+				if (n % word_bits != 0) {
+					result += popcount(bits[full] & ((word_type(1) << (n % word_bits)) - 1));
+				}
+
+				return result;
+			}
+
+			/**
+			* @brief 先頭n要素中の立っているビットの添え字について、昇順に関数を呼び出す
+			* @param func void(std::size_t)で呼び出し可能な関数
+			*/
+			template<typename F>
+			void for_each_set(const word_type* bits, std::size_t n, F&& func) {
+				const std::size_t words = word_count(n);
+
+				for (std::size_t w = 0; w < words; ++w) {
+					word_type word = bits[w];
+
+					//最終ワードの範囲外のビットは常に0に保たれている
+					while (word != 0) {
+						func(w * word_bits + countr_zero(word));
+						word &= word - 1;
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	* @brief 値を密に並べ、有効値の有無をビットマップで保持するoptional<T>の列
+	* @detail std::vector<optional<T>>と異なり、要素ごとの有効値フラグとパディングを持たない
+	* @detail 無効な要素の領域にはオブジェクトが構築されない、ただしTがtrivialな型の場合はT{}で埋められる
+	* @tparam T 格納する要素型
+	* @tparam Allocator 値領域のためのアロケータ
+	*/
+	template<typename T, typename Allocator = std::allocator<T>>
+	class optional_vector {
+
+		using alloc_traits = std::allocator_traits<Allocator>;
+		using word_type = detail::bitmap::word_type;
+		using word_allocator = typename alloc_traits::template rebind_alloc<word_type>;
+		using word_alloc_traits = std::allocator_traits<word_allocator>;
+
+		//無効な要素の領域を値で埋めておくか（SIMD等で全体を読み出せるようにする）
+		static constexpr bool fill_empty = std::is_trivial<T>::value;
+
+	public:
+
+		static_assert(std::conjunction<std::is_object<T>, std::negation<std::is_const<T>>, std::is_nothrow_destructible<T>>::value, "T shall be a non-const object type and shall satisfy the requirements of Destructible.");
+
+		using value_type = T;
+		using allocator_type = Allocator;
+		using size_type = std::size_t;
+		using reference = optional<T&>;
+		using const_reference = optional<const T&>;
+
+		optional_vector() noexcept(std::is_nothrow_default_constructible<Allocator>::value)
+			: optional_vector(Allocator{})
+		{}
+
+		explicit optional_vector(const Allocator& alloc) noexcept
+			: m_alloc{ alloc }
+		{}
+
+		/**
+		* @brief n個の無効値で初期化
+		*/
+		optional_vector(size_type n, nullopt_t, const Allocator& alloc = Allocator{})
+			: m_alloc{ alloc }
+		{
+			append(n, nullopt);
+		}
+
+		optional_vector(std::initializer_list<optional<T>> il, const Allocator& alloc = Allocator{})
+			: m_alloc{ alloc }
+		{
+			append(il.begin(), il.end());
+		}
+
+		optional_vector(const optional_vector& other)
+			: m_alloc{ alloc_traits::select_on_container_copy_construction(other.m_alloc) }
+		{
+			reserve(other.m_size);
+			copy_from(other);
+		}
+
+		optional_vector(optional_vector&& other) noexcept
+			: m_alloc{ std::move(other.m_alloc) }
+			, m_values{ other.m_values }
+			, m_bits{ other.m_bits }
+			, m_size{ other.m_size }
+			, m_capacity{ other.m_capacity }
+		{
+			other.m_values = nullptr;
+			other.m_bits = nullptr;
+			other.m_size = 0;
+			other.m_capacity = 0;
+		}
+
+		optional_vector& operator=(const optional_vector& other) {
+			if (this != &other) {
+				clear();
+				reserve(other.m_size);
+				copy_from(other);
+			}
+			return *this;
+		}
+
+		optional_vector& operator=(optional_vector&& other) noexcept {
+			if (this != &other) {
+				optional_vector tmp{ std::move(other) };
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		~optional_vector() noexcept {
+			clear();
+			deallocate();
+		}
+
+		size_type size() const noexcept {
+			return m_size;
+		}
+
+		size_type capacity() const noexcept {
+			return m_capacity;
+		}
+
+		bool empty() const noexcept {
+			return m_size == 0;
+		}
+
+		/**
+		* @brief 有効値を保持する要素の数
+		* @detail ビットマップのpopcountによって求める
+		*/
+		size_type count() const noexcept {
+			return (m_bits == nullptr) ? 0 : detail::bitmap::count(m_bits, m_size);
+		}
+
+		/**
+		* @brief 値領域の先頭ポインタ
+		* @detail 無効な要素の位置にはオブジェクトが構築されていない（Tがtrivialな型ならT{}）
+		*/
+		T* data() noexcept {
+			return m_values;
+		}
+
+		const T* data() const noexcept {
+			return m_values;
+		}
+
+		/**
+		* @brief 有効値ビットマップの先頭ポインタ
+		* @detail 要素iの有無は (bitmap()[i / 64] >> (i % 64)) & 1 、size()以降のビットは常に0
+		*/
+		const std::uint64_t* bitmap() const noexcept {
+			return m_bits;
+		}
+
+		bool has_value(size_type i) const noexcept {
+			return detail::bitmap::test(m_bits, i);
+		}
+
+		/**
+		* @brief 要素への参照をoptional<T&>で返す
+		* @detail 事前条件として、i < size()であること
+		*/
+		reference operator[](size_type i) noexcept {
+			return has_value(i) ? reference{ m_values[i] } : reference{};
+		}
+
+		const_reference operator[](size_type i) const noexcept {
+			return has_value(i) ? const_reference{ m_values[i] } : const_reference{};
+		}
+
+		/**
+		* @brief 範囲チェック付きの要素アクセス
+		* @detail i >= size() の場合、std::out_of_range例外を投げる
+		*/
+		reference at(size_type i) {
+			return (i < m_size) ? (*this)[i] : (detail::raise_bad_access<std::out_of_range>("optional_vector::at"), reference{});
+		}
+
+		const_reference at(size_type i) const {
+			return (i < m_size) ? (*this)[i] : (detail::raise_bad_access<std::out_of_range>("optional_vector::at"), const_reference{});
+		}
+
+		/**
+		* @brief 要素の値をoptional<T>としてコピーして返す
+		*/
+		optional<T> get(size_type i) const {
+			return has_value(i) ? optional<T>{ m_values[i] } : optional<T>{};
+		}
+
+		void reserve(size_type new_capacity) {
+			if (m_capacity < new_capacity) {
+				reallocate(new_capacity);
+			}
+		}
+
+		/**
+		* @brief 全要素を破棄する
+		* @detail 確保済みの領域は解放しない
+		*/
+		void clear() noexcept {
+			destroy_range(0, m_size);
+			std::fill_n(m_bits, detail::bitmap::word_count(m_size), word_type(0));
+			m_size = 0;
+		}
+
+		/**
+		* @brief 末尾に有効値を直接構築する
+		* @return 構築した要素への参照
+		*/
+		template<typename... Args>
+		T& emplace_back(Args&&... args) {
+			if (m_size == m_capacity) {
+				//引数がこの列の要素を参照している場合があるので、再配置より先に構築する
+				return emplace_back_grow(std::forward<Args>(args)...);
+			}
+
+			T& v = construct_slot(m_size, std::forward<Args>(args)...);
+			++m_size;
+			return v;
+		}
+
+		void push_back(const T& v) {
+			emplace_back(v);
+		}
+
+		void push_back(T&& v) {
+			emplace_back(std::move(v));
+		}
+
+		void push_back(nullopt_t) {
+			append(1, nullopt);
+		}
+
+		template<typename U>
+		void push_back(const optional<U>& v) {
+			if (v) {
+				emplace_back(*v);
+			}
+			else {
+				push_back(nullopt);
+			}
+		}
+
+		template<typename U>
+		void push_back(optional<U>&& v) {
+			if (v) {
+				emplace_back(std::move(*v));
+			}
+			else {
+				push_back(nullopt);
+			}
+		}
+
+		/**
+		* @brief 末尾にn個の無効値を追加する
+		* @detail ビットマップはゼロのままなので、値領域以外は触らない
+		*/
+		void append(size_type n, nullopt_t) {
+			grow_for(m_size + n);
+
+			if (fill_empty) {
+				fill_trivial(m_size, m_size + n);
+			}
+			m_size += n;
+		}
+
+		/**
+		* @brief 範囲の要素を末尾に追加する
+		* @detail 要素はT、optional<U>、nulloptのいずれかであること
+		*/
+		template<typename InputIterator>
+		void append(InputIterator first, InputIterator last) {
+			using category = typename std::iterator_traits<InputIterator>::iterator_category;
+
+			if (std::is_base_of<std::forward_iterator_tag, category>::value) {
+				grow_for(m_size + static_cast<size_type>(std::distance(first, last)));
+			}
+
+			for (; first != last; ++first) {
+				push_back(*first);
+			}
+		}
+
+		void pop_back() noexcept {
+			--m_size;
+			destroy_slot(m_size);
+		}
+
+		/**
+		* @brief i番目の要素に値を直接構築する
+		* @detail 既に有効値を保持していた場合は破棄してから構築する
+		* @return 構築した要素への参照
+		*/
+		template<typename... Args>
+		T& emplace(size_type i, Args&&... args) {
+			destroy_slot(i);
+			return construct_slot(i, std::forward<Args>(args)...);
+		}
+
+		/**
+		* @brief i番目の要素を無効値にする
+		*/
+		void reset(size_type i) noexcept {
+			destroy_slot(i);
+		}
+
+		/**
+		* @brief i番目の要素を削除し、後続の要素を前に詰める
+		*/
+		void erase(size_type i) {
+			erase(i, i + 1);
+		}
+
+		/**
+		* @brief [first, last)の要素を削除し、後続の要素を前に詰める
+		*/
+		void erase(size_type first, size_type last) {
+			if (first == last) return;
+
+			destroy_range(first, last);
+
+			size_type dst = first;
+			for (size_type src = last; src < m_size; ++src, ++dst) {
+				if (has_value(src)) {
+					relocate_slot(src, dst);
+				}
+				else if (fill_empty) {
+					fill_trivial(dst, dst + 1);
+				}
+			}
+
+			m_size = dst;
+		}
+
+		/**
+		* @brief 有効値を保持する要素についてのみ、添え字の昇順に関数を呼び出す
+		* @detail ビットマップを走査するので、無効値の多い列ほど高速
+		* @param func void(std::size_t, T&)で呼び出し可能な関数
+		*/
+		template<typename F>
+		void for_each_value(F&& func) {
+			if (m_bits == nullptr) return;
+
+			detail::bitmap::for_each_set(m_bits, m_size, [this, &func](std::size_t i) {
+				func(i, m_values[i]);
+			});
+		}
+
+		template<typename F>
+		void for_each_value(F&& func) const {
+			if (m_bits == nullptr) return;
+
+			detail::bitmap::for_each_set(m_bits, m_size, [this, &func](std::size_t i) {
+				func(i, static_cast<const T&>(m_values[i]));
+			});
+		}
+
+		void swap(optional_vector& other) noexcept {
+			using std::swap;
+
+			swap(m_alloc, other.m_alloc);
+			swap(m_values, other.m_values);
+			swap(m_bits, other.m_bits);
+			swap(m_size, other.m_size);
+			swap(m_capacity, other.m_capacity);
+		}
+
+		allocator_type get_allocator() const noexcept {
+			return m_alloc;
+		}
+
+	private:
+		Allocator m_alloc;
+		T* m_values = nullptr;
+		word_type* m_bits = nullptr;
+		size_type m_size = 0;
+		size_type m_capacity = 0;
+
+		/**
+		* @brief 無効値の位置に値を構築し、有効値ビットを立てる
+		* @detail 事前条件として、has_value(i) == false であること
+		*/
+		template<typename... Args>
+		T& construct_slot(size_type i, Args&&... args) {
+			T& v = detail::construct_at(m_values + i, std::forward<Args>(args)...);
+			detail::bitmap::set(m_bits, i);
+			return v;
+		}
+
+		/**
+		* @brief 有効値を破棄し、有効値ビットを下ろす
+		*/
+		void destroy_slot(size_type i) noexcept {
+			if (has_value(i)) {
+				detail::destroy_at(m_values + i);
+				detail::bitmap::clear(m_bits, i);
+			}
+			if (fill_empty) {
+				fill_trivial(i, i + 1);
+			}
+		}
+
+		/**
+		* @brief 有効値をsrcからdstへ再配置し、有効値ビットを移す
+		* @detail 事前条件として、has_value(src) == true かつ has_value(dst) == false であること
+		*/
+		void relocate_slot(size_type src, size_type dst) {
+			lstl::relocate_at(m_values + src, m_values + dst);
+			detail::bitmap::set(m_bits, dst);
+			detail::bitmap::clear(m_bits, src);
+			if (fill_empty) {
+				fill_trivial(src, src + 1);
+			}
+		}
+
+		void destroy_range(size_type first, size_type last) noexcept {
+			if (std::is_trivially_destructible<T>::value && !fill_empty) {
+				//値の破棄は不要、ビットだけ下ろす
+				for (size_type i = first; i < last; ++i) {
+					detail::bitmap::clear(m_bits, i);
+				}
+				return;
+			}
+
+			for (size_type i = first; i < last; ++i) {
+				destroy_slot(i);
+			}
+		}
+
+		void fill_trivial(size_type first, size_type last) noexcept {
+			fill_trivial(first, last, std::integral_constant<bool, fill_empty>{});
+		}
+
+		void fill_trivial(size_type first, size_type last, std::true_type) noexcept {
+			for (size_type i = first; i < last; ++i) {
+				detail::construct_at(m_values + i);
+			}
+		}
+
+		//デフォルト構築可能でない型のためにインスタンス化を避ける
+		void fill_trivial(size_type, size_type, std::false_type) noexcept {}
+
+		void copy_from(const optional_vector& other) {
+			for (size_type i = 0; i < other.m_size; ++i) {
+				if (other.has_value(i)) {
+					construct_slot(i, other.m_values[i]);
+				}
+				else if (fill_empty) {
+					fill_trivial(i, i + 1);
+				}
+				++m_size;
+			}
+		}
+
+		void grow_for(size_type required) {
+			if (m_capacity < required) {
+				reallocate((std::max)(required, m_capacity * 2));
+			}
+		}
+
+		/**
+		* @brief 新たに確保した値領域とビットマップ
+		*/
+		struct buffer {
+			T* values;
+			word_type* bits;
+			size_type capacity;
+		};
+
+		/**
+		* @brief 少なくともnew_capacity要素の領域を確保する、ビットマップはゼロで初期化する
+		*/
+		buffer allocate_buffer(size_type new_capacity) {
+			//64要素単位で確保し、ビットマップの端数を作らない
+			new_capacity = detail::bitmap::word_count(new_capacity) * detail::bitmap::word_bits;
+
+			word_allocator walloc{ m_alloc };
+			const size_type words = detail::bitmap::word_count(new_capacity);
+
+			T* values = alloc_traits::allocate(m_alloc, new_capacity);
+			word_type* bits;
+			LSTL_TRY {
+				bits = word_alloc_traits::allocate(walloc, words);
+			}
+			LSTL_CATCH_ALL {
+				alloc_traits::deallocate(m_alloc, values, new_capacity);
+				LSTL_RETHROW;
+			}
+
+			std::fill_n(bits, words, word_type(0));
+
+			return buffer{ values, bits, new_capacity };
+		}
+
+		void deallocate_buffer(const buffer& b) noexcept {
+			word_allocator walloc{ m_alloc };
+
+			alloc_traits::deallocate(m_alloc, b.values, b.capacity);
+			word_alloc_traits::deallocate(walloc, b.bits, detail::bitmap::word_count(b.capacity));
+		}
+
+		/**
+		* @brief バイト列ごと再配置できるか
+		*/
+		static constexpr bool relocate_bytes = fill_empty || is_trivially_relocatable<T>::value;
+
+		/**
+		* @brief 全要素を新しい領域にムーブ（又はコピー）する、元の要素はまだ破棄しない
+		* @detail 構築に失敗した場合は、新しい領域に構築済みの要素を破棄して再送出する（元の列は変更されない）
+		*/
+		void transfer_to(const buffer& b) {
+			if (m_values == nullptr) return;
+
+			if (relocate_bytes) {
+				//無効値の領域も含めてバイト列ごと再配置する
+				std::memcpy(static_cast<void*>(b.values), static_cast<const void*>(m_values), sizeof(T) * m_size);
+				return;
+			}
+
+			size_type i = 0;
+			LSTL_TRY {
+				for (; i < m_size; ++i) {
+					if (has_value(i)) {
+						detail::construct_at(b.values + i, std::move_if_noexcept(m_values[i]));
+					}
+				}
+			}
+			LSTL_CATCH_ALL {
+				for (size_type j = 0; j < i; ++j) {
+					if (has_value(j)) {
+						detail::destroy_at(b.values + j);
+					}
+				}
+				LSTL_RETHROW;
+			}
+		}
+
+		/**
+		* @brief 要素を移し終えた新しい領域に切り替える、元の要素を破棄して元の領域を解放する
+		*/
+		void adopt(const buffer& b) noexcept {
+			if (m_values != nullptr) {
+				if (!relocate_bytes && !std::is_trivially_destructible<T>::value) {
+					for (size_type i = 0; i < m_size; ++i) {
+						if (has_value(i)) {
+							detail::destroy_at(m_values + i);
+						}
+					}
+				}
+				std::copy_n(m_bits, detail::bitmap::word_count(m_size), b.bits);
+			}
+
+			deallocate();
+
+			m_values = b.values;
+			m_bits = b.bits;
+			m_capacity = b.capacity;
+		}
+
+		void reallocate(size_type new_capacity) {
+			const buffer b = allocate_buffer(new_capacity);
+
+			LSTL_TRY {
+				transfer_to(b);
+			}
+			LSTL_CATCH_ALL {
+				deallocate_buffer(b);
+				LSTL_RETHROW;
+			}
+
+			adopt(b);
+		}
+
+		/**
+		* @brief 領域を拡張して末尾に構築する
+		* @detail 新しい領域に末尾の要素を構築してから既存の要素を移す、どの段階で失敗しても列は変更されない
+		*/
+		template<typename... Args>
+		LSTL_NOINLINE_COLD T& emplace_back_grow(Args&&... args) {
+			const buffer b = allocate_buffer((std::max)(m_size + 1, m_capacity * 2));
+
+			T* v;
+			LSTL_TRY {
+				v = std::addressof(detail::construct_at(b.values + m_size, std::forward<Args>(args)...));
+			}
+			LSTL_CATCH_ALL {
+				deallocate_buffer(b);
+				LSTL_RETHROW;
+			}
+
+			LSTL_TRY {
+				transfer_to(b);
+			}
+			LSTL_CATCH_ALL {
+				detail::destroy_at(v);
+				deallocate_buffer(b);
+				LSTL_RETHROW;
+			}
+
+			adopt(b);
+
+			detail::bitmap::set(m_bits, m_size);
+			++m_size;
+			return *v;
+		}
+
+		void deallocate() noexcept {
+			if (m_values != nullptr) {
+				word_allocator walloc{ m_alloc };
+
+				alloc_traits::deallocate(m_alloc, m_values, m_capacity);
+				word_alloc_traits::deallocate(walloc, m_bits, detail::bitmap::word_count(m_capacity));
+
+				m_values = nullptr;
+				m_bits = nullptr;
+			}
+		}
+	};
+
+	template<typename T, typename Allocator>
+	void swap(optional_vector<T, Allocator>& x, optional_vector<T, Allocator>& y) noexcept {
+		x.swap(y);
+	}
+
+	namespace detail {
+
+		template<typename T, typename Allocator, typename OutputIterator, typename Hash>
+		OutputIterator hash_range(std::false_type, const optional_vector<T, Allocator>& v, OutputIterator out, Hash& hasher) {
+			const std::size_t size = v.size();
+
+			for (std::size_t i = 0; i < size; ++i, ++out) {
+				*out = (v.has_value(i))
+					? (detail::adjust_value_hash(hasher(*v[i])))
+					: (detail::nullopt_hash);
+			}
+			return out;
+		}
+
+		/**
+		* @brief Tがtrivialな型の場合、無効値の位置は値初期化されているので全要素をハッシュできる
+		*/
+		template<typename T, typename Allocator, typename OutputIterator, typename Hash>
+		OutputIterator hash_range(std::true_type, const optional_vector<T, Allocator>& v, OutputIterator out, Hash& hasher) {
+			const std::size_t size = v.size();
+			const T* values = v.data();
+			const std::uint64_t* bits = v.bitmap();
+
+			for (std::size_t i = 0; i < size; ++i, ++out) {
+				//両方を計算してから選択する
+				const std::size_t h = detail::adjust_value_hash(hasher(values[i]));
+				const std::size_t mask = std::size_t(0) - static_cast<std::size_t>(detail::bitmap::test(bits, i));
+
+				*out = (h & mask) | (detail::nullopt_hash & ~mask);
+			}
+			return out;
+		}
+	}
+
+	/**
+	* @brief optional_vectorの各要素のハッシュ値を計算する
+	* @detail 結果はstd::hash<optional<T>>の値と等しい
+	* @detail Tがtrivialな型の場合、無効値の位置も含めて全要素をハッシュし、ビットマップによって結果を選択する（分岐しない）
+	* @param v ハッシュする列
+	* @param out ハッシュ値の出力先、v.size()以上の領域があること
+	* @param hasher 有効値に適用するハッシュ関数
+	* @return 出力の終端
+	*/
+	template<typename T, typename Allocator, typename OutputIterator, typename Hash = std::hash<T>>
+	OutputIterator hash_range(const optional_vector<T, Allocator>& v, OutputIterator out, Hash hasher = Hash{}) {
+		return detail::hash_range(std::is_trivial<T>{}, v, out, hasher);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+﻿#pragma once
+
+#include <type_traits>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace lstl {
+
+	/**
+	* @brief Tがtrivially relocatableであるかを表す
+	* @detail 新しい領域へのムーブ構築と元のオブジェクトの破棄の組が、バイト列のコピーと等価である型
+	* @detail デフォルトではtrivially copyableな型のみ、それ以外の型は特殊化によって明示的に宣言する
+	* @detail 自己を指すポインタを持つ型（libstdc++のstd::string等）は該当しないので注意
+	*/
+	template<typename T>
+	struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+	template<typename T>
+	struct is_trivially_relocatable<const T> : is_trivially_relocatable<T> {};
+
+	namespace detail {
+
+		template<typename T>
+		T* relocate_at_impl(T* src, T* dst, std::true_type) noexcept {
+			std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(T));
+			return dst;
+		}
+
+		template<typename T>
+		T* relocate_at_impl(T* src, T* dst, std::false_type) noexcept(std::is_nothrow_move_constructible<T>::value) {
+			T* p = ::new(static_cast<void*>(dst)) T(std::move(*src));
+			src->~T();
+			return p;
+		}
+
+		template<typename T>
+		T* uninitialized_relocate_impl(T* first, T* last, T* d_first, std::true_type) noexcept {
+			if (first != last) {
+				std::memmove(static_cast<void*>(d_first), static_cast<const void*>(first), sizeof(T) * static_cast<std::size_t>(last - first));
+			}
+			return d_first + (last - first);
+		}
+
+		template<typename T>
+		T* uninitialized_relocate_impl(T* first, T* last, T* d_first, std::false_type) noexcept(std::is_nothrow_move_constructible<T>::value) {
+			for (; first != last; ++first, ++d_first) {
+				relocate_at_impl(first, d_first, std::false_type{});
+			}
+			return d_first;
+		}
+	}
+
+	/**
+	* @brief srcのオブジェクトをdstへ再配置する
+	* @detail dstは未初期化の領域であること、呼び出し後srcは未初期化の領域となる（デストラクタを呼んではならない）
+	* @detail Tがtrivially relocatableならばバイト列のコピー、そうでなければムーブ構築と破棄
+	* @return dstに配置されたオブジェクトへのポインタ
+	*/
+	template<typename T>
+	T* relocate_at(T* src, T* dst) noexcept(std::disjunction<is_trivially_relocatable<T>, std::is_nothrow_move_constructible<T>>::value) {
+		return detail::relocate_at_impl(src, dst, is_trivially_relocatable<T>{});
+	}
+
+	/**
+	* @brief [first, last)のオブジェクトをd_firstから始まる領域へ再配置する
+	* @detail 移動先は未初期化の領域であること、呼び出し後[first, last)は未初期化の領域となる
+	* @detail 移動先が移動元より前方にあれば、領域が重なっていてもよい
+	* @detail ムーブ構築が例外を投げた場合、再配置済みの要素は移動先に、未処理の要素は移動元に残る
+	* @return 移動先の終端
+	*/
+	template<typename T>
+	T* uninitialized_relocate(T* first, T* last, T* d_first) noexcept(std::disjunction<is_trivially_relocatable<T>, std::is_nothrow_move_constructible<T>>::value) {
+		return detail::uninitialized_relocate_impl(first, last, d_first, is_trivially_relocatable<T>{});
+	}
+}
\ No newline at end of file
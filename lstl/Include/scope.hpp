@@ -3,6 +3,28 @@
 #include <type_traits>
 #include <exception>
 #include <limits>
+#include <functional>
+#include <utility>
+#include <tuple>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <initializer_list>
+
+#include "config.hpp"
+#include "invalid_value.hpp"
+
+/**
+* @brief Itanium C++ ABI（libstdc++、libc++abi）のスレッドごとの例外情報（__cxa_eh_globals）を直接読めるか
+* @detail 先頭はcaughtExceptions（ポインタ）、続いてuncaughtExceptions（unsigned int）というレイアウトがABIで共通
+*/
+#if LSTL_HAS_EXCEPTIONS && (defined(__GLIBCXX__) || (defined(_LIBCPP_VERSION) && !defined(_WIN32)))
+#include <cxxabi.h>
+#define LSTL_HAS_CXA_EH_GLOBALS 1
+#else
+#define LSTL_HAS_CXA_EH_GLOBALS 0
+#endif
 
 //MSVC用、2クラス以上継承時にEmpty Base Optimizationを有効にする
 #if defined(_MSC_VER) && 190023918 <= _MSC_FULL_VER
@@ -30,29 +52,97 @@ namespace lstl {
 			}
 		};
 
-		struct fail {
-			int m_BeforExceptions = std::uncaught_exceptions();
+		/**
+		* @brief std::uncaught_exceptions()によって投げられている例外の数を得る
+		* @detail libstdc++等では関数呼び出しを経てスレッドローカル変数を読む
+		*/
+		struct std_uncaught_exceptions {
+			static int count() noexcept {
+				return std::uncaught_exceptions();
+			}
+		};
+
+		/**
+		* @brief スレッドごとの例外情報へのポインタをキャッシュし、投げられている例外の数を直接読む
+		* @detail ポインタはスレッドの生存中変化しないので、各スレッドで最初の1回のみ__cxa_get_globals()を呼び出す
+		* @detail 例外が無効ならば常に0、Itanium C++ ABIでない環境ではstd::uncaught_exceptions()と同じ
+		*/
+		struct cached_uncaught_exceptions {
+#if LSTL_HAS_CXA_EH_GLOBALS
+
+			struct eh_globals {
+				void* caught_exceptions;
+				unsigned int uncaught_exceptions;
+			};
+
+			LSTL_NOINLINE_COLD static eh_globals* load_globals() noexcept {
+				return reinterpret_cast<eh_globals*>(abi::__cxa_get_globals());
+			}
+
+			static int count() noexcept {
+				//定数初期化されるので、アクセスのたびの初期化検査は無い
+				static thread_local eh_globals* globals = nullptr;
+
+				eh_globals* g = globals;
+				if (g == nullptr) {
+					g = globals = load_globals();
+				}
+				return static_cast<int>(g->uncaught_exceptions);
+			}
+
+#elif LSTL_HAS_EXCEPTIONS
+
+			static int count() noexcept {
+				return std::uncaught_exceptions();
+			}
+
+#else
+
+			//例外が無効ならば、デストラクタが例外による巻き戻し中に呼ばれることは無い
+			static constexpr int count() noexcept {
+				return 0;
+			}
+
+#endif // LSTL_HAS_CXA_EH_GLOBALS
+		};
+
+		/**
+		* @brief 構築時よりも投げられている例外が増えていれば実行する
+		* @tparam Counter 投げられている例外の数を得る方法
+		*/
+		template<typename Counter>
+		struct basic_fail {
+			int m_BeforExceptions = Counter::count();
 
 			void release() noexcept {
 				m_BeforExceptions = (std::numeric_limits<int>::max)();
 			}
 
 			explicit operator bool() const noexcept {
-				return m_BeforExceptions < std::uncaught_exceptions();
+				return m_BeforExceptions < Counter::count();
 			}
 		};
 
-		struct succes {
-			int m_BeforExceptions = std::uncaught_exceptions();
+		/**
+		* @brief 構築時よりも投げられている例外が増えていなければ実行する
+		* @tparam Counter 投げられている例外の数を得る方法
+		*/
+		template<typename Counter>
+		struct basic_succes {
+			int m_BeforExceptions = Counter::count();
 
 			void release() noexcept {
 				m_BeforExceptions = -1;
 			}
 
 			explicit operator bool() const noexcept {
-				return std::uncaught_exceptions() <= m_BeforExceptions;
+				return Counter::count() <= m_BeforExceptions;
 			}
 		};
+
+		using fail = basic_fail<cached_uncaught_exceptions>;
+
+		using succes = basic_succes<cached_uncaught_exceptions>;
 	}
 
 	/**
@@ -72,29 +162,40 @@ namespace lstl {
 			}
 		};
 
-		//template<typename R, typename... Args>
-		//struct bind_storage {
+		/**
+		* @brief 束縛する引数を保持する型
+		* @detail 非constな左辺値参照の引数は参照として、それ以外は値として保持する
+		*/
+		template<typename Arg>
+		using bound_argument_t = std::conditional_t<std::conjunction<std::is_lvalue_reference<Arg>, std::negation<std::is_const<std::remove_reference_t<Arg>>>>::value, Arg, std::decay_t<Arg>>;
+
+		/**
+		* @brief 引数を束縛した関数ポインタ用のストレージ基底
+		* @detail 引数はstd::tupleに保持するので、空のクラス型の引数は領域を取らない
+		* @detail 呼び出しは1度だけなので、値として保持した引数はムーブして渡す
+		*/
+		template<typename R, typename... Args>
+		struct bind_storage {
+			R(*m_funcPtr)(Args...);
+			std::tuple<bound_argument_t<Args>...> m_args;
 
-		//	template<typename... BindArgs>
-		//	constexpr bind_storage(BindArgs&&... args)
-		//		: m_Args{ std::forward<BindArgs>(args)... }
-		//	{
-		//		static_assert(std::conjunction<std::is_same<Args, BindArgs>...>);
-		//	}
+			template<typename... BindArgs, std::enable_if_t<sizeof...(Args) == sizeof...(BindArgs), std::nullptr_t> = nullptr>
+			constexpr bind_storage(R(*funcPtr)(Args...), BindArgs&&... args)
+				: m_funcPtr{ funcPtr }
+				, m_args(std::forward<BindArgs>(args)...)
+			{}
 
-		//	void operator()() {
-		//		this->call(std::make_index_sequence<sizeof...(Args)>{})
-		//	}
+			void operator()() {
+				this->call(std::index_sequence_for<Args...>{});
+			}
 
-		//private:
-		//	R(*m_FuncPtr)(Args...);
-		//	std::tuple<Args...> m_Args;
+		private:
 
-		//	template<std::size_t... Index>
-		//	void call(std::index_sequence<Index...>) {
-		//		m_FuncPtr(std::get<Index>(m_Args)...);
-		//	}
-		//};
+			template<std::size_t... Index>
+			void call(std::index_sequence<Index...>) {
+				m_funcPtr(static_cast<Args&&>(std::get<Index>(m_args))...);
+			}
+		};
 
 		/**
 		* @brief 継承不可能な関数オブジェクト用のストレージ基底
@@ -149,7 +250,26 @@ namespace lstl {
 		* @brief 関数ポインタ、引数あり
 		*/
 		template<typename R, typename Arg, typename... Args>
-		struct functor_storage_traits<R(*)(Arg, Args...)>;
+		struct functor_storage_traits<R(*)(Arg, Args...)> {
+			using type = bind_storage<R, Arg, Args...>;
+		};
+
+#ifdef __cpp_noexcept_function_type
+
+		/**
+		* @brief noexceptな関数ポインタ（C++17以降は別の型となる）
+		*/
+		template<typename R>
+		struct functor_storage_traits<R(*)() noexcept> {
+			using type = funcptr_storage<R>;
+		};
+
+		template<typename R, typename Arg, typename... Args>
+		struct functor_storage_traits<R(*)(Arg, Args...) noexcept> {
+			using type = bind_storage<R, Arg, Args...>;
+		};
+
+#endif // __cpp_noexcept_function_type
 	}
 
 
@@ -183,17 +303,26 @@ namespace lstl {
 			: Storage{ std::move(functor) }
 		{}
 
+		/**
+		* @brief 関数ポインタと、それに束縛する引数から構築
+		* @detail ExitFunctorが引数を取る関数ポインタであるときのみ有効、引数は関数ポインタと共にこのオブジェクト内に保持される
+		*/
+		template<typename Arg, typename... BindArgs, std::enable_if_t<std::is_constructible<Storage, ExitFunctor, Arg, BindArgs...>::value, std::nullptr_t> = nullptr>
+		constexpr common_scope_exit(ExitFunctor functor, Arg&& arg, BindArgs&&... args) noexcept(std::is_nothrow_constructible<Storage, ExitFunctor, Arg, BindArgs...>::value)
+			: Storage(functor, std::forward<Arg>(arg), std::forward<BindArgs>(args)...)
+		{}
+
 		~common_scope_exit() noexcept {
-			try {
+			LSTL_TRY {
 				if (*this) (*this)();
 			}
-			catch (...) {}
+			LSTL_CATCH_ALL {}
 		}
 
 		/**
 		* @brief ムーブコンストラクタ
 		*/
-		common_scope_exit(common_scope_exit&& other) noexcept(std::conjunction<std::is_nothrow_move_constructible<Policy>, std::is_nothrow_move_constructible<ExitFunctor>>::value)
+		common_scope_exit(common_scope_exit&& other) noexcept(std::conjunction<std::is_nothrow_move_constructible<Policy>, std::is_nothrow_move_constructible<Storage>>::value)
 			: Policy{ other }
 			, Storage{ std::move(other) }
 		{
@@ -252,22 +381,650 @@ namespace lstl {
 	template<typename R, typename... Args>
 	scope_exit(R(Args...))->scope_exit<R(*)(Args...)>;
 
+	template<typename R, typename... Params, typename Arg, typename... BindArgs>
+	scope_exit(R(*)(Params...), Arg&&, BindArgs&&...)->scope_exit<R(*)(Params...)>;
+
 	template<typename Functor>
 	scope_exit(Functor&&)->scope_exit<std::remove_cv_t<std::remove_reference_t<Functor>>>;
 
 	template<typename R, typename... Args>
 	scope_fail(R(Args...))->scope_fail<R(*)(Args...)>;
 
+	template<typename R, typename... Params, typename Arg, typename... BindArgs>
+	scope_fail(R(*)(Params...), Arg&&, BindArgs&&...)->scope_fail<R(*)(Params...)>;
+
 	template<typename Functor>
 	scope_fail(Functor&&)->scope_fail<std::remove_cv_t<std::remove_reference_t<Functor>>>;
 
 	template<typename R, typename... Args>
 	scope_success(R(Args...))->scope_success<R(*)(Args...)>;
 
+	template<typename R, typename... Params, typename Arg, typename... BindArgs>
+	scope_success(R(*)(Params...), Arg&&, BindArgs&&...)->scope_success<R(*)(Params...)>;
+
 	template<typename Functor>
 	scope_success(Functor&&)->scope_success<std::remove_cv_t<std::remove_reference_t<Functor>>>;
 
 #endif // __cpp_deduction_guides
+
+	namespace detail {
+
+		/**
+		* @brief unique_resourceの削除子のストレージ基底を選択する
+		* @detail 継承可能なクラス型はそれ自身（空ならEBOによって領域を取らない）、それ以外はメンバとして保持する
+		*/
+		template<typename Deleter, bool = std::is_class<Deleter>::value>
+		struct deleter_storage_traits : adapt_is_inheritable<Deleter> {};
+
+		/**
+		* @brief 関数ポインタ等の削除子
+		*/
+		template<typename Deleter>
+		struct deleter_storage_traits<Deleter, false> {
+			using type = not_inheritable_storage<Deleter>;
+		};
+
+		/**
+		* @brief ストレージ基底から削除子を取り出す
+		*/
+		template<typename Deleter>
+		Deleter& stored_functor(Deleter& storage) noexcept {
+			return storage;
+		}
+
+		template<typename Deleter>
+		const Deleter& stored_functor(const Deleter& storage) noexcept {
+			return storage;
+		}
+
+		template<typename Deleter>
+		Deleter& stored_functor(not_inheritable_storage<Deleter>& storage) noexcept {
+			return storage.m_functor;
+		}
+
+		template<typename Deleter>
+		const Deleter& stored_functor(const not_inheritable_storage<Deleter>& storage) noexcept {
+			return storage.m_functor;
+		}
+
+		/**
+		* @brief 例外を投げずに構築できるならば右辺値として、そうでなければ左辺値として（コピーさせるために）渡す
+		* @detail 構築に失敗しても、元の資源と削除子が有効なまま残るようにする
+		*/
+		template<typename T, typename U>
+		std::conditional_t<std::is_nothrow_constructible<T, U>::value, U&&, U&> forward_if_nothrow(U& value) noexcept {
+			return static_cast<std::conditional_t<std::is_nothrow_constructible<T, U>::value, U&&, U&>>(value);
+		}
+
+		/**
+		* @brief Tを構築する、例外が投げられた場合は（所有していれば）資源を削除してから再送出する
+		* @param value 構築に用いる値
+		* @param deleter 失敗時に呼び出す削除子
+		* @param resource 失敗時に削除する資源
+		* @param owns 資源を所有しているか
+		*/
+		template<typename T, typename U, typename Deleter, typename Resource>
+		T construct_or_delete(U&& value, Deleter& deleter, Resource& resource, bool owns) {
+			LSTL_TRY {
+				return T(std::forward<U>(value));
+			}
+			LSTL_CATCH_ALL {
+				if (owns) deleter(resource);
+				LSTL_RETHROW;
+			}
+		}
+
+		/**
+		* @brief unique_resourceの資源と所有状態のストレージ
+		* @detail 無効値が宣言されていない場合、所有しているかをboolで保持する
+		* @tparam R 資源の型、参照型ならばstd::reference_wrapperで保持する
+		*/
+		template<typename R, typename Traits, bool = std::conjunction<std::negation<std::is_reference<R>>, has_invalid_value_of<Traits, R>>::value>
+		struct resource_storage {
+			using stored_type = std::conditional_t<std::is_reference<R>::value, std::reference_wrapper<std::remove_reference_t<R>>, R>;
+
+			stored_type m_resource{};
+			bool m_execute_on_reset = false;
+
+			resource_storage() = default;
+
+			template<typename U>
+			resource_storage(U&& resource, bool execute_on_reset) noexcept(std::is_nothrow_constructible<stored_type, U>::value)
+				: m_resource(std::forward<U>(resource))
+				, m_execute_on_reset{ execute_on_reset }
+			{}
+
+			bool owns() const noexcept {
+				return m_execute_on_reset;
+			}
+
+			void release() noexcept {
+				m_execute_on_reset = false;
+			}
+
+			/**
+			* @brief 新しい資源を代入し、所有する
+			*/
+			template<typename U>
+			void adopt(U&& resource) {
+				m_resource = std::forward<U>(resource);
+				m_execute_on_reset = true;
+			}
+
+			/**
+			* @brief 所有していれば、所有を放棄してから削除子を呼び出す
+			*/
+			template<typename Deleter>
+			void reset(Deleter& deleter) noexcept {
+				if (m_execute_on_reset) {
+					m_execute_on_reset = false;
+					deleter(static_cast<R&>(m_resource));
+				}
+			}
+		};
+
+		/**
+		* @brief 無効値が宣言されている資源のストレージ
+		* @detail 資源が無効値でなければ所有しているとみなし、boolを持たない（sizeof(resource_storage) == sizeof(R)）
+		*/
+		template<typename R, typename Traits>
+		struct resource_storage<R, Traits, true> {
+			static_assert(std::is_trivially_copyable<R>::value, "An invalid value can be declared only for trivially copyable resources.");
+
+			using stored_type = R;
+
+			R m_resource = Traits::invalid_value();
+
+			resource_storage() = default;
+
+			template<typename U>
+			resource_storage(U&& resource, bool execute_on_reset) noexcept(std::is_nothrow_constructible<R, U>::value)
+				: m_resource(execute_on_reset ? R(std::forward<U>(resource)) : Traits::invalid_value())
+			{}
+
+			bool owns() const noexcept {
+				return !Traits::is_invalid(m_resource);
+			}
+
+			void release() noexcept {
+				m_resource = Traits::invalid_value();
+			}
+
+			/**
+			* @brief 新しい資源を代入する、無効値ならば所有しない
+			*/
+			template<typename U>
+			void adopt(U&& resource) {
+				m_resource = std::forward<U>(resource);
+			}
+
+			template<typename Deleter>
+			void reset(Deleter& deleter) noexcept {
+				if (!Traits::is_invalid(m_resource)) {
+					const R resource = m_resource;
+					m_resource = Traits::invalid_value();
+					deleter(resource);
+				}
+			}
+		};
+
+		/**
+		* @brief make_unique_resource_checkedに指定された無効値の宣言、指定が無ければinvalid_value_traits<R>
+		*/
+		template<typename Traits, typename R>
+		using select_invalid_value_traits = std::conditional_t<std::is_void<Traits>::value, invalid_value_traits<R>, Traits>;
+	}
+
+	/**
+	* @brief 資源を所有し、破棄時に削除子を呼び出すクラス
+	* @detail 削除子が空のクラス型ならば領域を取らない
+	* @detail Traitsが資源の無効値を宣言している場合、無効値によって所有していない状態を表し、所有状態のboolを持たない
+	* @detail   unique_resource<int, close_fn, invalid_value_constant<int, -1>> は sizeof(int) となる
+	* @detail   その場合、無効値で構築された資源は所有されず、release()の後のget()は無効値を返す
+	* @tparam R 資源の型、参照型でもよい
+	* @tparam D 削除子の型、Rの左辺値を受けて呼び出し可能であること
+	* @tparam Traits 無効値の宣言（invalid_value_constant等）、既定はinvalid_value_traits<R>
+	*/
+	template<typename R, typename D, typename Traits = invalid_value_traits<std::remove_cv_t<R>>>
+	class ENABLE_EBO unique_resource : private detail::resource_storage<R, Traits>, private detail::deleter_storage_traits<D>::type {
+		static_assert(std::is_object<D>::value, "D shall be an object type.");
+
+		using Resource = detail::resource_storage<R, Traits>;
+		using Storage = typename detail::deleter_storage_traits<D>::type;
+		using stored_type = typename Resource::stored_type;
+
+		template<typename, typename RR, typename DD, typename S>
+		friend auto make_unique_resource_checked(RR&&, const S&, DD&&);
+
+		Resource& resource() noexcept {
+			return *this;
+		}
+
+		const Resource& resource() const noexcept {
+			return *this;
+		}
+
+		D& deleter() noexcept {
+			return detail::stored_functor(static_cast<Storage&>(*this));
+		}
+
+		/**
+		* @brief 資源を所有するかを指定して構築
+		*/
+		template<typename RR, typename DD>
+		unique_resource(RR&& r, DD&& d, bool execute_on_reset)
+			: Resource(detail::construct_or_delete<stored_type>(detail::forward_if_nothrow<stored_type, RR>(r), d, r, execute_on_reset), execute_on_reset)
+			, Storage{ detail::construct_or_delete<D>(detail::forward_if_nothrow<D, DD>(d), d, static_cast<R&>(this->m_resource), execute_on_reset) }
+		{}
+
+		/**
+		* @brief ムーブ元の削除子を移す、コピーに失敗した場合、資源が既にムーブされていればムーブ元の削除子で削除する
+		*/
+		static D take_deleter(unique_resource& other, R& moved_resource) {
+			LSTL_TRY {
+				return D(std::move_if_noexcept(other.deleter()));
+			}
+			LSTL_CATCH_ALL {
+				if (std::is_nothrow_move_constructible<stored_type>::value && other.resource().owns()) {
+					other.deleter()(moved_resource);
+					other.release();
+				}
+				LSTL_RETHROW;
+			}
+		}
+
+		/**
+		* @brief ムーブ代入の実装、資源のムーブ代入が例外を投げない場合
+		* @detail 削除子を先に代入し、失敗しても所有しない状態のままとする
+		*/
+		void move_assign(unique_resource& other, std::true_type) {
+			this->deleter() = std::move_if_noexcept(other.deleter());
+			this->resource() = std::move(other.resource());
+		}
+
+		/**
+		* @brief ムーブ代入の実装、資源をコピーする場合
+		* @detail 資源と削除子の代入が共に成功してから所有する（無効値を宣言した資源は常にこちらではない）
+		*/
+		void move_assign(unique_resource& other, std::false_type) {
+			this->m_resource = static_cast<const stored_type&>(other.m_resource);
+			this->deleter() = std::move_if_noexcept(other.deleter());
+			this->m_execute_on_reset = other.m_execute_on_reset;
+		}
+
+	public:
+
+		/**
+		* @brief デフォルトコンストラクタ、資源を所有しない
+		*/
+		unique_resource() noexcept(std::conjunction<std::is_nothrow_default_constructible<Resource>, std::is_nothrow_default_constructible<D>>::value)
+			: Resource()
+			, Storage()
+		{}
+
+		/**
+		* @brief 資源と削除子を受けて構築
+		* @detail 資源又は削除子の構築に失敗した場合、d(r)を呼び出してから例外を再送出する
+		*/
+		template<typename RR, typename DD, std::enable_if_t<std::conjunction<std::is_constructible<stored_type, RR>, std::is_constructible<D, DD>>::value, std::nullptr_t> = nullptr>
+		unique_resource(RR&& r, DD&& d) noexcept(std::conjunction<std::is_nothrow_constructible<stored_type, RR>, std::is_nothrow_constructible<D, DD>>::value)
+			: unique_resource(std::forward<RR>(r), std::forward<DD>(d), true)
+		{}
+
+		/**
+		* @brief ムーブコンストラクタ
+		* @detail ムーブ元は所有を放棄する
+		*/
+		unique_resource(unique_resource&& other) noexcept(std::conjunction<std::is_nothrow_move_constructible<stored_type>, std::is_nothrow_move_constructible<D>>::value)
+			: Resource(std::move_if_noexcept(other.resource()))
+			, Storage{ take_deleter(other, static_cast<R&>(this->m_resource)) }
+		{
+			other.release();
+		}
+
+		/**
+		* @brief ムーブ代入
+		* @detail 所有する資源を削除してから、ムーブ元の資源と削除子を移す
+		*/
+		unique_resource& operator=(unique_resource&& other) noexcept(std::conjunction<std::is_nothrow_move_assignable<stored_type>, std::is_nothrow_move_assignable<D>>::value) {
+			if (this == &other) return *this;
+
+			this->reset();
+			this->move_assign(other, std::integral_constant<bool, std::is_nothrow_move_assignable<stored_type>::value>{});
+			other.release();
+			return *this;
+		}
+
+		~unique_resource() {
+			this->reset();
+		}
+
+		unique_resource(const unique_resource&) = delete;
+		unique_resource& operator=(const unique_resource&) = delete;
+
+		/**
+		* @brief 所有していれば資源を削除する
+		*/
+		void reset() noexcept {
+			this->resource().reset(this->deleter());
+		}
+
+		/**
+		* @brief 所有する資源を削除し、新しい資源を所有する
+		* @detail 代入に失敗した場合、新しい資源を削除してから例外を再送出する
+		*/
+		template<typename RR>
+		void reset(RR&& r) {
+			this->reset();
+
+			LSTL_TRY {
+				this->resource().adopt(detail::forward_if_nothrow<stored_type, RR>(r));
+			}
+			LSTL_CATCH_ALL {
+				this->deleter()(r);
+				LSTL_RETHROW;
+			}
+		}
+
+		/**
+		* @brief 所有を放棄する、資源は削除されない
+		* @detail 無効値が宣言されている場合、以降のget()は無効値を返す
+		*/
+		void release() noexcept {
+			this->resource().release();
+		}
+
+		/**
+		* @brief 資源を取得する
+		*/
+		const R& get() const noexcept {
+			return this->m_resource;
+		}
+
+		/**
+		* @brief 削除子を取得する
+		*/
+		const D& get_deleter() const noexcept {
+			return detail::stored_functor(static_cast<const Storage&>(*this));
+		}
+
+		/**
+		* @brief ポインタである資源の参照先を取得する
+		*/
+		template<typename RR = R, std::enable_if_t<std::conjunction<std::is_pointer<RR>, std::negation<std::is_void<std::remove_pointer_t<RR>>>>::value, std::nullptr_t> = nullptr>
+		std::add_lvalue_reference_t<std::remove_pointer_t<RR>> operator*() const noexcept {
+			return *this->get();
+		}
+
+		/**
+		* @brief ポインタである資源を取得する
+		*/
+		template<typename RR = R, std::enable_if_t<std::is_pointer<RR>::value, std::nullptr_t> = nullptr>
+		R operator->() const noexcept {
+			return this->get();
+		}
+	};
+
+#ifdef __cpp_deduction_guides
+
+	template<typename R, typename D>
+	unique_resource(R, D)->unique_resource<R, D>;
+
+#endif // __cpp_deduction_guides
+
+	/**
+	* @brief 資源が無効値と等しくなければ所有するunique_resourceを作成する
+	* @detail 無効値と等しい場合、削除子は呼ばれない
+	* @tparam Traits unique_resourceの無効値の宣言、voidならばinvalid_value_traits<R>
+	* @param r 資源
+	* @param invalid 資源の取得の失敗を表す値
+	* @param d 削除子
+	*/
+	template<typename Traits = void, typename RR, typename DD, typename S>
+	auto make_unique_resource_checked(RR&& r, const S& invalid, DD&& d) {
+		using resource_type = std::decay_t<RR>;
+		using result_type = unique_resource<resource_type, std::decay_t<DD>, detail::select_invalid_value_traits<Traits, resource_type>>;
+
+		const bool execute_on_reset = !bool(r == invalid);
+		return result_type(std::forward<RR>(r), std::forward<DD>(d), execute_on_reset);
+	}
+
+	namespace detail {
+
+		/**
+		* @brief scope_stackの内部のバッファ
+		*/
+		template<std::size_t BufferSize>
+		struct scope_stack_buffer {
+			std::aligned_storage_t<BufferSize, alignof(std::max_align_t)> m_buffer;
+
+			unsigned char* buffer() noexcept {
+				return reinterpret_cast<unsigned char*>(&m_buffer);
+			}
+		};
+
+		/**
+		* @brief バッファを持たない場合、空の基底となり領域を取らない
+		*/
+		template<>
+		struct scope_stack_buffer<0> {
+			unsigned char* buffer() noexcept {
+				return nullptr;
+			}
+		};
+	}
+
+	/**
+	* @brief 実行時に登録される任意個の関数を、スコープを抜けるときに登録と逆順に実行するスタック
+	* @detail 関数オブジェクトは内部のバッファ（又は与えられた領域）に詰めて保持し、足りなくなった場合にのみ動的に確保する
+	* @detail 関数ポインタと束縛する引数を登録することもできる（scope_exitと同様）
+	* @detail 実行条件はscope_exit等と同じポリシーで決まる、既定では例外によってスコープを抜けるときのみ（ロールバック）
+	* @detail 登録した関数が例外を投げた場合は無視して、残りを実行する
+	* @tparam Policy 実行条件を決めるポリシークラス（policy配下の3つ）
+	* @tparam BufferSize 内部のバッファのバイト数、0ならば持たない（オブジェクトの大きさにも含まれない）
+	*/
+	template<typename Policy = policy::fail, std::size_t BufferSize = 512>
+	class ENABLE_EBO scope_stack : private Policy, private detail::scope_stack_buffer<BufferSize> {
+
+		/**
+		* @brief 登録された関数の管理情報、直後に（アラインして）関数オブジェクトが置かれる
+		*/
+		struct entry {
+			entry* m_prev;
+			void(*m_invoke)(entry*) noexcept;
+			//トリビアルに破棄可能ならばnullptr
+			void(*m_destroy)(entry*) noexcept;
+		};
+
+		/**
+		* @brief 動的に確保した領域の先頭
+		*/
+		struct chunk {
+			chunk* m_prev;
+		};
+
+		static std::uintptr_t align_up(std::uintptr_t p, std::size_t align) noexcept {
+			return (p + (align - 1)) & ~static_cast<std::uintptr_t>(align - 1);
+		}
+
+		template<typename F>
+		static F* object(entry* e) noexcept {
+			return reinterpret_cast<F*>(align_up(reinterpret_cast<std::uintptr_t>(e + 1), alignof(F)));
+		}
+
+		template<typename F>
+		static void invoke(entry* e) noexcept {
+			F* f = object<F>(e);
+
+			LSTL_TRY {
+				(*f)();
+			}
+			LSTL_CATCH_ALL {}
+
+			f->~F();
+		}
+
+		template<typename F>
+		static void destroy(entry* e) noexcept {
+			object<F>(e)->~F();
+		}
+
+		entry* m_top = nullptr;
+		//現在の領域
+		unsigned char* m_begin;
+		unsigned char* m_cur;
+		unsigned char* m_end;
+		//最初の領域（内部のバッファか与えられた領域）
+		unsigned char* m_initial;
+		unsigned char* m_initial_end;
+		chunk* m_chunks = nullptr;
+		std::size_t m_size = 0;
+		//破棄が必要な関数オブジェクトの数
+		std::size_t m_nontrivial = 0;
+
+		/**
+		* @brief 関数オブジェクトを置く領域を確保する
+		* @detail 現在の領域に収まらなければ、必要量と直前の領域の2倍の大きい方を新たに確保する
+		*/
+		template<typename F>
+		entry* allocate() {
+			static_assert(alignof(F) <= alignof(std::max_align_t), "Over-aligned callables are not supported.");
+			static_assert(alignof(entry) <= alignof(std::max_align_t), "");
+
+			constexpr std::size_t required = sizeof(entry) + alignof(entry) + sizeof(F) + alignof(F);
+
+			std::uintptr_t p = align_up(reinterpret_cast<std::uintptr_t>(m_cur), alignof(entry));
+			std::uintptr_t end = align_up(p + sizeof(entry), alignof(F)) + sizeof(F);
+
+			if (reinterpret_cast<std::uintptr_t>(m_end) < end) {
+				this->grow(required);
+
+				p = align_up(reinterpret_cast<std::uintptr_t>(m_cur), alignof(entry));
+				end = align_up(p + sizeof(entry), alignof(F)) + sizeof(F);
+			}
+
+			m_cur = reinterpret_cast<unsigned char*>(end);
+			return reinterpret_cast<entry*>(p);
+		}
+
+		LSTL_NOINLINE_COLD void grow(std::size_t required) {
+			const std::size_t previous = static_cast<std::size_t>(m_end - m_begin);
+			const std::size_t capacity = (std::max)({ required, previous * 2, std::size_t(256) });
+
+			void* memory = ::operator new(sizeof(chunk) + capacity);
+			chunk* c = ::new (memory) chunk{ m_chunks };
+			m_chunks = c;
+
+			m_begin = m_cur = reinterpret_cast<unsigned char*>(c + 1);
+			m_end = m_begin + capacity;
+		}
+
+		/**
+		* @brief 全ての関数オブジェクトを、実行するか単に破棄して空にする
+		*/
+		void unwind(bool execute) noexcept {
+			if (execute) {
+				for (entry* e = m_top; e != nullptr; e = e->m_prev) {
+					e->m_invoke(e);
+				}
+			}
+			else if (m_nontrivial != 0) {
+				for (entry* e = m_top; e != nullptr; e = e->m_prev) {
+					if (e->m_destroy != nullptr) e->m_destroy(e);
+				}
+			}
+
+			for (chunk* c = m_chunks; c != nullptr;) {
+				chunk* prev = c->m_prev;
+				::operator delete(c);
+				c = prev;
+			}
+
+			m_top = nullptr;
+			m_chunks = nullptr;
+			m_size = 0;
+			m_nontrivial = 0;
+
+			m_begin = m_cur = m_initial;
+			m_end = m_initial_end;
+		}
+
+	public:
+
+		/**
+		* @brief 内部のバッファを用いて構築
+		*/
+		scope_stack() noexcept
+			: m_initial{ this->buffer() }
+			, m_initial_end{ this->buffer() + BufferSize }
+		{
+			m_begin = m_cur = m_initial;
+			m_end = m_initial_end;
+		}
+
+		/**
+		* @brief 与えられた領域を（内部のバッファの代わりに）用いて構築
+		* @detail 領域はこのオブジェクトよりも長く生存していなければならない
+		* @param arena 領域の先頭
+		* @param size 領域のバイト数
+		*/
+		scope_stack(void* arena, std::size_t size) noexcept
+			: m_initial{ static_cast<unsigned char*>(arena) }
+			, m_initial_end{ static_cast<unsigned char*>(arena) + size }
+		{
+			m_begin = m_cur = m_initial;
+			m_end = m_initial_end;
+		}
+
+		~scope_stack() noexcept {
+			this->unwind(static_cast<bool>(static_cast<const Policy&>(*this)));
+		}
+
+		scope_stack(const scope_stack&) = delete;
+		scope_stack& operator=(const scope_stack&) = delete;
+
+		/**
+		* @brief 関数を登録する
+		* @detail 領域の確保や関数オブジェクトの構築に失敗した場合は例外を送出し、関数は登録されない
+		* @param f 引数無しで呼び出し可能な関数オブジェクト、又は関数ポインタ
+		* @param args fが関数ポインタの場合、束縛する引数
+		*/
+		template<typename F, typename... BindArgs>
+		void push(F&& f, BindArgs&&... args) {
+			using callable = std::conditional_t<sizeof...(BindArgs) == 0, std::decay_t<F>, typename detail::functor_storage_traits<std::decay_t<F>>::type>;
+
+			entry* e = this->allocate<callable>();
+			::new (static_cast<void*>(object<callable>(e))) callable(std::forward<F>(f), std::forward<BindArgs>(args)...);
+
+			e->m_prev = m_top;
+			e->m_invoke = &invoke<callable>;
+			e->m_destroy = std::is_trivially_destructible<callable>::value ? nullptr : &destroy<callable>;
+
+			m_top = e;
+			++m_size;
+			m_nontrivial += std::is_trivially_destructible<callable>::value ? 0 : 1;
+		}
+
+		/**
+		* @brief 登録された全ての関数を実行せずに取り除く（コミット）
+		* @detail 関数オブジェクトが全てトリビアルに破棄可能で、動的な確保も無ければO(1)
+		* @detail 以降も関数を登録でき、実行条件は変わらない
+		*/
+		void release() noexcept {
+			this->unwind(false);
+		}
+
+		/**
+		* @brief 登録されている関数の数
+		*/
+		std::size_t size() const noexcept {
+			return m_size;
+		}
+
+		bool empty() const noexcept {
+			return m_size == 0;
+		}
+	};
 }
 
 #undef ENABLE_EBO
\ No newline at end of file
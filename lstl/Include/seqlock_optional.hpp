@@ -0,0 +1,135 @@
+﻿#pragma once
+
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <atomic>
+#include <thread>
+
+#include "optional.hpp"
+
+namespace lstl {
+
+	/**
+	* @brief 1つの書き込み側が最新の値を公開し、複数の読み込み側がそれを取得するためのセル（seqlock）
+	* @detail 読み込み側はロックを取らず、書き込み中であれば読み直す。書き込み側は読み込み側によって待たされない
+	* @detail optional<T>のオブジェクト表現（値と有効値フラグ）をワード単位のアトミック変数に保持する、無効値は未公開を表す
+	* @detail publish/resetは1つのスレッドからのみ呼ぶこと
+	* @tparam T 格納する要素型、trivially copyableであること
+	*/
+	template<typename T>
+	class seqlock_optional {
+		static_assert(std::is_trivially_copyable<T>::value, "T shall be trivially copyable.");
+		static_assert(!std::is_const<T>::value && !std::is_volatile<T>::value, "T shall not be cv-qualified.");
+
+		using word_type = std::uint64_t;
+
+		static constexpr std::size_t word_count = (sizeof(optional<T>) + sizeof(word_type) - 1) / sizeof(word_type);
+
+		//読み込みを再試行する回数の上限、超えるとスレッドを譲る
+		static constexpr unsigned spin_limit = 64;
+
+		//書き込み側の更新するシーケンス番号と値は別のキャッシュラインに置く
+		alignas(64) std::atomic<std::uint64_t> m_seq;
+		alignas(64) std::atomic<word_type> m_words[word_count];
+
+		void write_words(const optional<T>& v) noexcept {
+			word_type buf[word_count] = {};
+			std::memcpy(buf, std::addressof(v), sizeof(v));
+
+			for (std::size_t i = 0; i < word_count; ++i) {
+				m_words[i].store(buf[i], std::memory_order_relaxed);
+			}
+		}
+
+		void write(const optional<T>& v) noexcept {
+			const std::uint64_t seq = m_seq.load(std::memory_order_relaxed);
+
+			//奇数の間は書き込み中
+			m_seq.store(seq + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+
+			write_words(v);
+
+			m_seq.store(seq + 2, std::memory_order_release);
+		}
+
+	public:
+
+		using value_type = T;
+
+		/**
+		* @brief 未公開の状態で初期化
+		*/
+		seqlock_optional() noexcept : m_seq{ 0 }
+		{
+			write_words(nullopt);
+		}
+
+		seqlock_optional(const seqlock_optional&) = delete;
+		seqlock_optional& operator=(const seqlock_optional&) = delete;
+
+		/**
+		* @brief 値を公開する（書き込み側）
+		*/
+		void publish(const T& v) noexcept {
+			write(v);
+		}
+
+		/**
+		* @brief 未公開の状態に戻す（書き込み側）
+		*/
+		void reset() noexcept {
+			write(nullopt);
+		}
+
+		/**
+		* @brief 最新の値を取得する（読み込み側）
+		* @param version 取得した値の版、publish/resetごとに増加する
+		* @return 最新の値のコピー、未公開であればnullopt
+		*/
+		optional<T> load(std::uint64_t& version) const noexcept {
+			word_type buf[word_count];
+
+			for (unsigned retry = 0; ; ++retry) {
+				//書き込み側が書き込み中に中断された場合に備え、しばらく読めなければ譲る
+				if (spin_limit <= retry) {
+					std::this_thread::yield();
+				}
+
+				const std::uint64_t before = m_seq.load(std::memory_order_acquire);
+
+				if ((before & 1) == 0) {
+					for (std::size_t i = 0; i < word_count; ++i) {
+						buf[i] = m_words[i].load(std::memory_order_relaxed);
+					}
+					std::atomic_thread_fence(std::memory_order_acquire);
+
+					//読んでいる間に書き込まれなかった
+					if (m_seq.load(std::memory_order_relaxed) == before) {
+						version = before / 2;
+						break;
+					}
+				}
+			}
+
+			optional<T> result;
+			std::memcpy(std::addressof(result), buf, sizeof(result));
+			return result;
+		}
+
+		optional<T> load() const noexcept {
+			std::uint64_t version;
+			return load(version);
+		}
+
+		/**
+		* @brief 現在の版を取得する（読み込み側）
+		* @detail 前回取得した版と比較することで、値を読まずに更新の有無を調べられる
+		*/
+		std::uint64_t version() const noexcept {
+			return m_seq.load(std::memory_order_acquire) / 2;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+﻿//atomic_optionalの競合時のベンチマーク
+//複数のスレッドが1つのスロットに値を置き、取り出すことを繰り返す（ハンドオフ）
+//
+//使い方: atomic_optional_bench [名前の一部...]
+
+#include "bench.hpp"
+
+#include "Include/atomic_optional.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+	using namespace lstl::bench;
+
+	//0を無効値とする識別子
+	enum class ticket : std::uint64_t {};
+}
+
+namespace lstl {
+
+	template<>
+	struct invalid_value_traits<ticket> : invalid_value_constant<ticket, ticket(0)> {};
+}
+
+namespace {
+
+	/**
+	* @brief ミューテックスで保護したoptional<uint64_t>
+	*/
+	struct mutex_slot {
+		static constexpr const char* name = "std::mutex + optional<uint64_t>";
+
+		std::mutex m;
+		lstl::optional<std::uint64_t> slot;
+
+		bool put(std::uint64_t v) {
+			std::lock_guard<std::mutex> lock{ m };
+			if (slot) return false;
+			slot = v;
+			return true;
+		}
+
+		bool take() {
+			std::lock_guard<std::mutex> lock{ m };
+			if (!slot) return false;
+			slot.reset();
+			return true;
+		}
+	};
+
+	/**
+	* @brief atomic_optional<uint64_t>、値とフラグで16バイトのワード
+	* @detail cmpxchg16bにはロードが無いので、読み出しもCAS（キャッシュラインへの書き込み）となる
+	*/
+	struct atomic_slot {
+		static constexpr const char* name = "atomic_optional<uint64_t> (16B, load is CAS)";
+
+		lstl::atomic_optional<std::uint64_t> slot;
+
+		bool put(std::uint64_t v) {
+			lstl::optional<std::uint64_t> expected{};
+			return slot.compare_exchange_strong(expected, v, std::memory_order_release, std::memory_order_relaxed);
+		}
+
+		bool take() {
+			return slot.take(std::memory_order_acquire).has_value();
+		}
+	};
+
+	/**
+	* @brief atomic_optional<ticket>、無効値を持つので8バイトのワード
+	*/
+	struct atomic_niche_slot {
+		static constexpr const char* name = "atomic_optional<ticket> (8B niche)";
+
+		lstl::atomic_optional<ticket> slot;
+
+		bool put(std::uint64_t v) {
+			lstl::optional<ticket> expected{};
+			return slot.compare_exchange_strong(expected, ticket(v | 1), std::memory_order_release, std::memory_order_relaxed);
+		}
+
+		bool take() {
+			return slot.take(std::memory_order_acquire).has_value();
+		}
+	};
+
+	/**
+	* @brief threads個のスレッドで置く・取り出すを交互に行う、1操作あたりの時間（全スレッドの合計の操作数で割る）
+	*/
+	template<typename Slot>
+	result bench_handoff(unsigned threads) {
+		return measure(Slot::name, [threads](std::size_t n) {
+			Slot slot{};
+			const std::size_t per_thread = n / threads + 1;
+
+			std::vector<std::thread> workers{};
+			for (unsigned t = 0; t < threads; ++t) {
+				workers.emplace_back([&slot, per_thread, t] {
+					std::size_t done = 0;
+					for (std::size_t i = 0; i < per_thread; ++i) {
+						done += (i & 1) ? slot.take() : slot.put(i + t);
+					}
+					do_not_optimize(done);
+				});
+			}
+			for (auto& w : workers) w.join();
+		}, 3);
+	}
+}
+
+int main(int argc, char** argv) {
+	const lstl::bench::filter f{ argc, argv };
+
+	for (unsigned threads : { 1u, 2u, 4u, 8u, 16u, 32u }) {
+		const std::string title = "handoff threads=" + std::to_string(threads);
+		if (f.match(title)) {
+			report(title, { bench_handoff<mutex_slot>(threads), bench_handoff<atomic_slot>(threads), bench_handoff<atomic_niche_slot>(threads) });
+		}
+	}
+}
\ No newline at end of file
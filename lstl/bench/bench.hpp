@@ -0,0 +1,117 @@
+﻿#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <string>
+
+namespace lstl::bench {
+
+	/**
+	* @brief 値の計算を最適化によって消去させない
+	*/
+	template<typename T>
+	inline void do_not_optimize(T& value) noexcept {
+#if defined(__GNUC__)
+		asm volatile("" : "+m"(value) : : "memory");
+#else
+		static volatile char sink;
+		sink = *reinterpret_cast<volatile char*>(&value);
+#endif
+	}
+
+	/**
+	* @brief メモリへの書き込みの並べ替えを抑止する
+	*/
+	inline void clobber() noexcept {
+#if defined(__GNUC__)
+		asm volatile("" : : : "memory");
+#endif
+	}
+
+	/**
+	* @brief コマンドライン引数によるベンチマークの選択
+	* @detail 引数が無ければ全て、あれば名前にいずれかの引数を含むものだけを実行する
+	*/
+	class filter {
+		std::vector<std::string> m_patterns;
+
+	public:
+		filter(int argc, char** argv) {
+			for (int i = 1; i < argc; ++i) {
+				m_patterns.emplace_back(argv[i]);
+			}
+		}
+
+		bool match(const std::string& name) const {
+			if (m_patterns.empty()) return true;
+
+			return std::any_of(m_patterns.begin(), m_patterns.end(), [&name](const std::string& p) {
+				return name.find(p) != std::string::npos;
+			});
+		}
+	};
+
+	/**
+	* @brief 1回の計測結果
+	*/
+	struct result {
+		std::string name;
+		double ns_per_op;
+	};
+
+	/**
+	* @brief 関数を繰り返し実行し、1回あたりの時間を計測する
+	* @detail func(std::size_t iterations)がiterations回の操作を行う
+	* @detail 0.1秒程度になるまで回数を増やしてから、repeat回計測して中央値をとる
+	* @param name 表示名
+	* @param func 計測する関数
+	* @param repeat 計測の繰り返し回数
+	*/
+	template<typename F>
+	result measure(const std::string& name, F&& func, int repeat = 5) {
+		using clock = std::chrono::steady_clock;
+
+		std::size_t iterations = 1;
+		for (;;) {
+			const auto start = clock::now();
+			func(iterations);
+			const auto elapsed = std::chrono::duration<double>(clock::now() - start).count();
+
+			if (elapsed > 0.02 || iterations >= (std::size_t(1) << 34)) {
+				iterations = static_cast<std::size_t>(iterations * (0.1 / (std::max)(elapsed, 1e-9))) + 1;
+				break;
+			}
+			iterations *= 8;
+		}
+
+		std::vector<double> samples{};
+		for (int r = 0; r < repeat; ++r) {
+			const auto start = clock::now();
+			func(iterations);
+			const auto elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+			samples.push_back(elapsed / static_cast<double>(iterations));
+		}
+
+		std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+		return result{ name, samples[samples.size() / 2] };
+	}
+
+	/**
+	* @brief 計測結果の表を出力する
+	* @detail 基準（最初の列）に対する比も出力する
+	*/
+	inline void report(const std::string& title, const std::vector<result>& results) {
+		if (results.empty()) return;
+
+		std::printf("%-48s %12s %8s\n", title.c_str(), "ns/op", "ratio");
+		for (const auto& r : results) {
+			std::printf("  %-46s %12.3f %8.2f\n", r.name.c_str(), r.ns_per_op, r.ns_per_op / results.front().ns_per_op);
+		}
+		std::printf("\n");
+	}
+}
\ No newline at end of file
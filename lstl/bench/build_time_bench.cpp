@@ -0,0 +1,148 @@
+﻿//optional.hpp のコンパイル時間のベンチマーク
+//N個の異なる型Tについてoptional<T>を実体化する翻訳単位を生成し、コンパイルにかかる時間と最大メモリ使用量を計測する
+//コード生成は含めない（-fsyntax-only）、テンプレートの実体化とオーバーロード解決のコストを見るため
+//std::optionalによる同じ翻訳単位を基準とする
+//
+//使い方: build_time_bench [名前の一部...]
+//POSIX環境のみ（fork/exec、wait4によって子プロセスの資源使用量を得る）
+
+#include "bench.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef LSTL_BENCH_CXX
+#error "LSTL_BENCH_CXX (compiler path) shall be defined"
+#endif
+
+#ifndef LSTL_BENCH_INCLUDE_DIR
+#error "LSTL_BENCH_INCLUDE_DIR shall be defined"
+#endif
+
+namespace {
+
+	using namespace lstl::bench;
+
+	/**
+	* @brief 1回のコンパイルの計測結果
+	*/
+	struct compile_result {
+		std::string name;
+		double seconds;
+		double max_rss_mib;
+	};
+
+	/**
+	* @brief n個の異なる要素型についてoptionalの基本操作を実体化するソースを生成する
+	* @detail trivially copyableな型と、非トリビアルな特殊メンバ関数を持つ型を交互に用いる
+	* @param optional_template 実体化するクラステンプレート名
+	*/
+	std::string generate_source(const char* header, const char* optional_template, int n) {
+		std::ostringstream src{};
+
+		src << "#include " << header << "\n#include <string>\n#include <utility>\n\n";
+
+		for (int i = 0; i < n; ++i) {
+			if (i % 2 == 0) {
+				src << "struct t" << i << " { int v; double d; };\n";
+			}
+			else {
+				src << "struct t" << i << " { std::string s; int v; };\n";
+			}
+
+			src << "using o" << i << " = " << optional_template << "<t" << i << ">;\n"
+				<< "o" << i << " f" << i << "(const o" << i << "& a, o" << i << "&& b) {\n"
+				<< "\to" << i << " c = a;\n"
+				<< "\tc = std::move(b);\n"
+				<< "\to" << i << " d{ std::move(c) };\n"
+				<< "\tif (!d.has_value()) d.emplace();\n"
+				<< "\td = a;\n"
+				<< "\treturn d;\n"
+				<< "}\n\n";
+		}
+
+		return src.str();
+	}
+
+	/**
+	* @brief コンパイラを子プロセスとして実行し、経過時間と最大常駐メモリを得る
+	*/
+	compile_result compile(const std::string& name, const std::string& path, const std::string& standard) {
+		const std::string include = std::string("-I") + LSTL_BENCH_INCLUDE_DIR;
+
+		const auto start = std::chrono::steady_clock::now();
+
+		const pid_t pid = ::fork();
+		if (pid == 0) {
+			::execlp(LSTL_BENCH_CXX, LSTL_BENCH_CXX, standard.c_str(), include.c_str(), "-w", "-fsyntax-only", path.c_str(), static_cast<char*>(nullptr));
+			std::_Exit(127);
+		}
+
+		int status = 0;
+		struct rusage usage {};
+		::wait4(pid, &status, 0, &usage);
+
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			std::fprintf(stderr, "compilation failed: %s\n", path.c_str());
+			std::exit(1);
+		}
+
+		//Linuxではru_maxrssはKiB単位
+		return compile_result{ name, seconds, static_cast<double>(usage.ru_maxrss) / 1024.0 };
+	}
+
+	/**
+	* @brief 3回コンパイルし、時間が中央値となった結果をとる
+	*/
+	compile_result measure_compile(const std::string& name, const std::string& source, const std::string& standard) {
+		const std::string path = "build_time_bench_" + std::to_string(::getpid()) + ".cpp";
+		{
+			std::ofstream out{ path };
+			out << source;
+		}
+
+		std::vector<compile_result> samples{};
+		for (int r = 0; r < 3; ++r) {
+			samples.push_back(compile(name, path, standard));
+		}
+
+		std::remove(path.c_str());
+
+		std::sort(samples.begin(), samples.end(), [](const compile_result& a, const compile_result& b) {
+			return a.seconds < b.seconds;
+		});
+		return samples[1];
+	}
+
+	void report_compile(const std::string& title, const std::vector<compile_result>& results) {
+		std::printf("%-48s %12s %8s %12s\n", title.c_str(), "seconds", "ratio", "MaxRSS MiB");
+		for (const auto& r : results) {
+			std::printf("  %-46s %12.3f %8.2f %12.1f\n", r.name.c_str(), r.seconds, r.seconds / results.front().seconds, r.max_rss_mib);
+		}
+		std::printf("\n");
+	}
+}
+
+int main(int argc, char** argv) {
+	const lstl::bench::filter f{ argc, argv };
+
+	for (const char* standard : { "-std=c++17", "-std=c++20" }) {
+		for (int n : { 100, 200 }) {
+			const std::string title = std::string("instantiate N=") + std::to_string(n) + " (" + (standard + 5) + ")";
+			if (!f.match(title)) continue;
+
+			report_compile(title, {
+				measure_compile("std::optional", generate_source("<optional>", "std::optional", n), standard),
+				measure_compile("lstl::optional", generate_source("\"Include/optional.hpp\"", "lstl::optional", n), standard),
+			});
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+# value()の呼び出し側に例外送出のコードが残らないことを検査する
+# codegen/optional_value.cppを例外の有無の設定を変えてコンパイルし、アセンブリとオブジェクトの大きさを比べる
+#
+# exceptions : 既定の設定、送出はインライン展開されない関数（raise_bad_access）に追い出されていること
+# no-exceptions : -fno-exceptions、例外の仕組み（__cxa_*、personality、例外表）が一切無いこと
+# trap : -fno-exceptions -DLSTL_BAD_ACCESS_TRAP、呼び出し側にトラップ命令だけが展開されること
+#
+# 使い方: cmake -DCXX=<コンパイラ> -DSOURCE=<ソース> -DINCLUDE_DIR=<インクルードディレクトリ> -DWORK_DIR=<作業ディレクトリ> -P check_no_exceptions.cmake
+
+set(functions
+  lstl_codegen_optional_value
+  lstl_codegen_optional_value_unchecked
+  lstl_codegen_expected_value
+)
+
+set(failed FALSE)
+
+# 関数の本体（分割された.cold部分も含む）を取り出す
+function(function_body asm name out)
+  set(body "")
+
+  string(FIND "${asm}" "\n${name}:" begin)
+  if(NOT begin EQUAL -1)
+    string(SUBSTRING "${asm}" ${begin} -1 rest)
+    string(FIND "${rest}" ".cfi_endproc" end)
+    string(SUBSTRING "${rest}" 0 ${end} body)
+  endif()
+
+  string(FIND "${asm}" "\n${name}.cold:" begin)
+  if(NOT begin EQUAL -1)
+    string(SUBSTRING "${asm}" ${begin} -1 rest)
+    string(FIND "${rest}" ".size" end)
+    string(SUBSTRING "${rest}" 0 ${end} cold)
+    string(APPEND body "${cold}")
+  endif()
+
+  set(${out} "${body}" PARENT_SCOPE)
+endfunction()
+
+foreach(mode exceptions no-exceptions trap)
+  if(mode STREQUAL "exceptions")
+    set(flags "")
+  elseif(mode STREQUAL "no-exceptions")
+    set(flags -fno-exceptions)
+  else()
+    set(flags -fno-exceptions -DLSTL_BAD_ACCESS_TRAP)
+  endif()
+
+  execute_process(
+    COMMAND ${CXX} -std=c++17 -O2 -DNDEBUG ${flags} -S -o - -I${INCLUDE_DIR} ${SOURCE}
+    OUTPUT_VARIABLE asm
+    ERROR_VARIABLE error
+    RESULT_VARIABLE status
+  )
+  if(NOT status EQUAL 0)
+    message(FATAL_ERROR "compile failed (${mode}):\n${error}")
+  endif()
+
+  foreach(name IN LISTS functions)
+    function_body("${asm}" ${name} body)
+    if(body STREQUAL "")
+      message(SEND_ERROR "${mode}: ${name} not found")
+      set(failed TRUE)
+    elseif(body MATCHES "__cxa_|_Unwind_")
+      message(SEND_ERROR "${mode}: ${name} contains exception handling code")
+      set(failed TRUE)
+    elseif(mode STREQUAL "trap" AND body MATCHES "call")
+      message(SEND_ERROR "${mode}: ${name} calls a function")
+      set(failed TRUE)
+    endif()
+  endforeach()
+
+  if(NOT mode STREQUAL "exceptions" AND asm MATCHES "__cxa_|_Unwind_|__gxx_personality|gcc_except_table")
+    message(SEND_ERROR "${mode}: exception handling code remains in the translation unit")
+    set(failed TRUE)
+  endif()
+
+  # オブジェクトの大きさ（参考値）
+  set(object ${WORK_DIR}/optional_value_${mode}.o)
+  execute_process(
+    COMMAND ${CXX} -std=c++17 -O2 -DNDEBUG ${flags} -c -o ${object} -I${INCLUDE_DIR} ${SOURCE}
+    RESULT_VARIABLE status
+  )
+  if(status EQUAL 0 AND NOT CMAKE_VERSION VERSION_LESS 3.14)
+    file(SIZE ${object} size)
+    message(STATUS "${mode}: object size ${size} bytes")
+  endif()
+endforeach()
+
+if(failed)
+  message(FATAL_ERROR "codegen check failed")
+endif()
+
+message(STATUS "no exception handling code at value() call sites")
@@ -0,0 +1,59 @@
+# optional<T>の戻り値がレジスタで返されることを検査する
+# codegen/optional_return.cppのアセンブリを出力し、呼び出し側の関数の本体を調べる
+#
+# 引数(const char*)は通常RDIで渡されるが、戻り値がメモリで返される場合はRDIが戻り値の領域のアドレスとなり、引数はRSIにずれる
+# そのため、parse関数の呼び出しまでにRSIが使われていればメモリで返されていると判断できる
+#
+# 使い方: cmake -DCXX=<コンパイラ> -DSOURCE=<ソース> -DINCLUDE_DIR=<インクルードディレクトリ> -P check_register_return.cmake
+
+execute_process(
+  COMMAND ${CXX} -std=c++17 -O2 -S -o - -I${INCLUDE_DIR} ${SOURCE}
+  OUTPUT_VARIABLE asm
+  ERROR_VARIABLE error
+  RESULT_VARIABLE status
+)
+
+if(NOT status EQUAL 0)
+  message(FATAL_ERROR "compile failed:\n${error}")
+endif()
+
+# 関数名 : 期待する戻り値の返し方
+set(expectations
+  int:register
+  double:register
+  long_long:register
+  string:memory
+)
+
+set(failed FALSE)
+
+foreach(expectation IN LISTS expectations)
+  string(REPLACE ":" ";" pair ${expectation})
+  list(GET pair 0 type)
+  list(GET pair 1 expected)
+
+  # 関数の先頭からparse関数の呼び出しまで
+  string(REGEX MATCH "\nlstl_codegen_call_${type}:.*call[ \t]+lstl_codegen_parse_${type}" body "${asm}")
+  if(body STREQUAL "")
+    message(SEND_ERROR "lstl_codegen_call_${type}: call not found")
+    set(failed TRUE)
+    continue()
+  endif()
+
+  if(body MATCHES "%rsi")
+    set(actual memory)
+  else()
+    set(actual register)
+  endif()
+
+  if(actual STREQUAL expected)
+    message(STATUS "optional<${type}>: returned in ${actual}")
+  else()
+    message(SEND_ERROR "optional<${type}>: returned in ${actual}, expected ${expected}")
+    set(failed TRUE)
+  endif()
+endforeach()
+
+if(failed)
+  message(FATAL_ERROR "codegen check failed")
+endif()
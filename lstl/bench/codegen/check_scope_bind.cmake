@@ -0,0 +1,70 @@
+# 引数を束縛した関数ポインタのscope_exitが、同じ関数を呼び出すラムダ式のscope_exitと同じ程度に最適化されることを検査する
+# codegen/scope_bind.cppのアセンブリを出力し、2つの関数の本体（例外時の.cold部分も含む）を比べる
+#
+# 束縛した関数ポインタは定数として伝播され、間接呼び出しが残らないこと
+# 命令数がラムダ式の場合以下であること
+#
+# 使い方: cmake -DCXX=<コンパイラ> -DSOURCE=<ソース> -DINCLUDE_DIR=<インクルードディレクトリ> -P check_scope_bind.cmake
+
+execute_process(
+  COMMAND ${CXX} -std=c++17 -O2 -DNDEBUG -S -o - -I${INCLUDE_DIR} ${SOURCE}
+  OUTPUT_VARIABLE asm
+  ERROR_VARIABLE error
+  RESULT_VARIABLE status
+)
+
+if(NOT status EQUAL 0)
+  message(FATAL_ERROR "compile failed:\n${error}")
+endif()
+
+# 関数の本体（分割された.cold部分も含む）の命令数を数える
+function(count_instructions asm name out_count out_body)
+  set(body "")
+
+  string(FIND "${asm}" "\n${name}:" begin)
+  if(NOT begin EQUAL -1)
+    string(SUBSTRING "${asm}" ${begin} -1 rest)
+    string(FIND "${rest}" ".cfi_endproc" end)
+    string(SUBSTRING "${rest}" 0 ${end} body)
+  endif()
+
+  string(FIND "${asm}" "\n${name}.cold:" begin)
+  if(NOT begin EQUAL -1)
+    string(SUBSTRING "${asm}" ${begin} -1 rest)
+    string(FIND "${rest}" ".size" end)
+    string(SUBSTRING "${rest}" 0 ${end} cold)
+    string(APPEND body "${cold}")
+  endif()
+
+  # 命令の行はタブに続く英字で始まる（ディレクティブは'.'で始まる）
+  string(REGEX MATCHALL "\n\t[a-z][^\n]*" instructions "${body}")
+  list(LENGTH instructions count)
+
+  set(${out_count} ${count} PARENT_SCOPE)
+  set(${out_body} "${body}" PARENT_SCOPE)
+endfunction()
+
+count_instructions("${asm}" lstl_codegen_scope_bind bind_count bind_body)
+count_instructions("${asm}" lstl_codegen_scope_lambda lambda_count lambda_body)
+
+if(bind_count EQUAL 0 OR lambda_count EQUAL 0)
+  message(FATAL_ERROR "function not found")
+endif()
+
+message(STATUS "bound function pointer: ${bind_count} instructions, lambda: ${lambda_count} instructions")
+
+set(failed FALSE)
+
+if(bind_body MATCHES "(call|jmp)[a-z]*\t\\*")
+  message(SEND_ERROR "the bound function pointer is called indirectly")
+  set(failed TRUE)
+endif()
+
+if(bind_count GREATER lambda_count)
+  message(SEND_ERROR "the bound function pointer needs more instructions than the lambda")
+  set(failed TRUE)
+endif()
+
+if(failed)
+  message(FATAL_ERROR "codegen check failed")
+endif()
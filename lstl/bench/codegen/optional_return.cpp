@@ -0,0 +1,36 @@
+﻿//optional<T>の戻り値がレジスタで返されることを確認するためのソース
+//check_register_return.cmakeがアセンブリを出力し、呼び出し側の各関数の本体を検査する
+//
+//SysV ABIでは、trivially copyableかつ16バイト以下の型はRAX/RDX、XMM0/XMM1で返される
+//そうでない型は呼び出し元がスタック上に領域を用意し、そのアドレスをRDIで渡す
+
+#include "Include/optional.hpp"
+
+#include <string>
+
+extern "C" {
+
+	//定義は与えない、呼び出し側のコードだけを生成させる
+	lstl::optional<int> lstl_codegen_parse_int(const char* str);
+	lstl::optional<double> lstl_codegen_parse_double(const char* str);
+	lstl::optional<long long> lstl_codegen_parse_long_long(const char* str);
+	lstl::optional<std::string> lstl_codegen_parse_string(const char* str);
+
+	//レジスタで返されること
+	int lstl_codegen_call_int(const char* str) {
+		return lstl_codegen_parse_int(str).value_or(-1);
+	}
+
+	double lstl_codegen_call_double(const char* str) {
+		return lstl_codegen_parse_double(str).value_or(-1.0);
+	}
+
+	long long lstl_codegen_call_long_long(const char* str) {
+		return lstl_codegen_parse_long_long(str).value_or(-1);
+	}
+
+	//メモリで返されること（検査自体が機能していることの確認）
+	std::size_t lstl_codegen_call_string(const char* str) {
+		return lstl_codegen_parse_string(str).value_or(std::string{}).size();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+﻿//value()の呼び出し側に例外送出のコードが残らないことを確認するためのソース
+//check_no_exceptions.cmakeが例外の有無の設定を変えてアセンブリを出力し、各関数の本体を検査する
+
+#include "Include/optional.hpp"
+#include "Include/expected.hpp"
+
+extern "C" {
+
+	int lstl_codegen_optional_value(const lstl::optional<int>& o) {
+		return o.value();
+	}
+
+	int lstl_codegen_optional_value_unchecked(const lstl::optional<int>& o) {
+		return o.value_unchecked();
+	}
+
+	int lstl_codegen_expected_value(const lstl::expected<int, int>& e) {
+		return e.value();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+﻿//引数を束縛した関数ポインタのscope_exitと、同じ関数を呼び出すラムダ式のscope_exitを比べるためのソース
+//check_scope_bind.cmakeがアセンブリを出力し、2つの関数の本体を比べる
+
+#include "Include/scope.hpp"
+
+#include <cstddef>
+
+extern "C" {
+
+	//定義しない（アセンブリの出力のみ）
+	void lstl_codegen_release(void* p, std::size_t n) noexcept;
+	void lstl_codegen_work(void* p);
+
+	void lstl_codegen_scope_bind(void* p, std::size_t n) {
+		lstl::scope_exit guard{ &lstl_codegen_release, p, n };
+		lstl_codegen_work(p);
+	}
+
+	void lstl_codegen_scope_lambda(void* p, std::size_t n) {
+		lstl::scope_exit guard{ [p, n]() { lstl_codegen_release(p, n); } };
+		lstl_codegen_work(p);
+	}
+}
\ No newline at end of file
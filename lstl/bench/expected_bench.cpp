@@ -0,0 +1,135 @@
+﻿//エラー経路のコストのベンチマーク
+//整数の文字列を読み、一定の割合で含まれる不正な入力を例外、optionalと出力引数、expectedで報告する
+//
+//使い方: expected_bench [名前の一部...]
+
+#include "bench.hpp"
+
+#include "Include/expected.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+	using namespace lstl::bench;
+
+	enum class parse_error {
+		empty,
+		not_digit
+	};
+
+	/**
+	* @brief 不正な入力で例外を投げる
+	*/
+	int parse_throw(const std::string& str) {
+		if (str.empty()) throw std::invalid_argument("empty");
+
+		int result = 0;
+		for (char c : str) {
+			if (c < '0' || '9' < c) throw std::invalid_argument("not digit");
+			result = result * 10 + (c - '0');
+		}
+		return result;
+	}
+
+	/**
+	* @brief 不正な入力でnulloptを返し、理由を出力引数に書く
+	*/
+	lstl::optional<int> parse_optional(const std::string& str, parse_error& err) {
+		if (str.empty()) {
+			err = parse_error::empty;
+			return lstl::nullopt;
+		}
+
+		int result = 0;
+		for (char c : str) {
+			if (c < '0' || '9' < c) {
+				err = parse_error::not_digit;
+				return lstl::nullopt;
+			}
+			result = result * 10 + (c - '0');
+		}
+		return result;
+	}
+
+	/**
+	* @brief 不正な入力でエラー値を返す
+	*/
+	lstl::expected<int, parse_error> parse_expected(const std::string& str) {
+		if (str.empty()) return lstl::make_unexpected(parse_error::empty);
+
+		int result = 0;
+		for (char c : str) {
+			if (c < '0' || '9' < c) return lstl::make_unexpected(parse_error::not_digit);
+			result = result * 10 + (c - '0');
+		}
+		return result;
+	}
+
+	/**
+	* @brief 不正な入力をpercent%含む入力列
+	*/
+	std::vector<std::string> make_inputs(unsigned percent) {
+		std::vector<std::string> inputs{};
+		std::uint32_t seed = 12345;
+
+		for (int i = 0; i < 4096; ++i) {
+			seed = seed * 1664525u + 1013904223u;
+			inputs.push_back((seed >> 8) % 100 < percent ? std::string("12x4") : std::to_string(seed % 100000));
+		}
+		return inputs;
+	}
+
+	result bench_throw(const std::vector<std::string>& inputs) {
+		return measure("exception", [&inputs](std::size_t n) {
+			std::int64_t sum = 0;
+			for (std::size_t i = 0; i < n; ++i) {
+				try {
+					sum += parse_throw(inputs[i % inputs.size()]);
+				}
+				catch (const std::invalid_argument&) {
+					--sum;
+				}
+			}
+			do_not_optimize(sum);
+		});
+	}
+
+	result bench_optional(const std::vector<std::string>& inputs) {
+		return measure("optional + out parameter", [&inputs](std::size_t n) {
+			std::int64_t sum = 0;
+			for (std::size_t i = 0; i < n; ++i) {
+				parse_error err{};
+				const auto r = parse_optional(inputs[i % inputs.size()], err);
+				sum += r ? *r : -1;
+			}
+			do_not_optimize(sum);
+		});
+	}
+
+	result bench_expected(const std::vector<std::string>& inputs) {
+		return measure("expected", [&inputs](std::size_t n) {
+			std::int64_t sum = 0;
+			for (std::size_t i = 0; i < n; ++i) {
+				const auto r = parse_expected(inputs[i % inputs.size()]);
+				sum += r ? *r : -1;
+			}
+			do_not_optimize(sum);
+		});
+	}
+}
+
+int main(int argc, char** argv) {
+	const lstl::bench::filter f{ argc, argv };
+
+	for (unsigned percent : { 0u, 1u, 10u, 50u }) {
+		const std::string name = "parse int errors=" + std::to_string(percent) + "%";
+		if (!f.match(name)) continue;
+
+		const auto inputs = make_inputs(percent);
+		report(name, { bench_throw(inputs), bench_optional(inputs), bench_expected(inputs) });
+	}
+}
\ No newline at end of file
@@ -0,0 +1,446 @@
+﻿//lstl::optionalの基本操作のベンチマーク
+//std::optional、及びポインタ/番兵値による表現と比較する
+//
+//使い方: optional_bench [名前の一部...]
+
+#include "bench.hpp"
+
+#include "Include/optional.hpp"
+#include "Include/optional_pipeline.hpp"
+
+#include <optional>
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace {
+
+	using namespace lstl::bench;
+
+	//計測対象の要素型
+
+	struct pod64 {
+		std::uint64_t v[8];
+	};
+
+	struct move_only {
+		int v;
+
+		explicit move_only(int x) noexcept : v{ x } {}
+		move_only(move_only&& other) noexcept : v{ other.v } { other.v = 0; }
+		move_only& operator=(move_only&& other) noexcept { v = other.v; other.v = 0; return *this; }
+		move_only(const move_only&) = delete;
+		move_only& operator=(const move_only&) = delete;
+	};
+
+	/**
+	* @brief 要素型ごとの値の生成とキーの取り出し
+	*/
+	template<typename T>
+	struct value_traits;
+
+	template<>
+	struct value_traits<int> {
+		static constexpr const char* name = "int";
+		static int make(int seed) { return seed; }
+		static int key(const int& v) { return v; }
+	};
+
+	template<>
+	struct value_traits<std::string> {
+		static constexpr const char* name = "std::string";
+		//SSOに収まらない長さ
+		static std::string make(int seed) { return std::string(32, static_cast<char>('a' + seed % 26)); }
+		static int key(const std::string& v) { return v[0]; }
+	};
+
+	template<>
+	struct value_traits<pod64> {
+		static constexpr const char* name = "pod64";
+		static pod64 make(int seed) { pod64 p{}; p.v[0] = seed; p.v[7] = seed; return p; }
+		static int key(const pod64& v) { return static_cast<int>(v.v[0]); }
+	};
+
+	template<>
+	struct value_traits<move_only> {
+		static constexpr const char* name = "move_only";
+		static move_only make(int seed) { return move_only{ seed }; }
+		static int key(const move_only& v) { return v.v; }
+	};
+
+	/**
+	* @brief value_orに与える値
+	*/
+	template<typename T>
+	const T& fallback() {
+		static const T value = value_traits<T>::make(2);
+		return value;
+	}
+
+	//比較する実装、共通のインターフェースで包む
+
+	template<typename T>
+	struct lstl_impl {
+		static constexpr const char* name = "lstl::optional";
+		using type = lstl::optional<T>;
+
+		static type make(int seed) { return type{ value_traits<T>::make(seed) }; }
+		static type empty() { return type{}; }
+		static void emplace(type& o, int seed) { o.emplace(value_traits<T>::make(seed)); }
+		static void swap(type& a, type& b) { lstl::swap(a, b); }
+
+		static int chain(const type& o) {
+			const auto r = o.and_then([](const T& v) { return lstl::optional<int>{ value_traits<T>::key(v) }; })
+				.and_then([](int k) { return (k < 0) ? lstl::optional<int>{} : lstl::optional<int>{ k + 1 }; });
+			return r.value_or(-1);
+		}
+
+		static int value_or(const type& o) { return value_traits<T>::key(o.value_or(fallback<T>())); }
+	};
+
+	template<typename T>
+	struct std_impl {
+		static constexpr const char* name = "std::optional";
+		using type = std::optional<T>;
+
+		static type make(int seed) { return type{ value_traits<T>::make(seed) }; }
+		static type empty() { return type{}; }
+		static void emplace(type& o, int seed) { o.emplace(value_traits<T>::make(seed)); }
+		static void swap(type& a, type& b) { std::swap(a, b); }
+
+		static int chain(const type& o) {
+#if defined(__cpp_lib_optional) && __cpp_lib_optional >= 202110L
+			const auto r = o.and_then([](const T& v) { return std::optional<int>{ value_traits<T>::key(v) }; })
+				.and_then([](int k) { return (k < 0) ? std::optional<int>{} : std::optional<int>{ k + 1 }; });
+#else
+			std::optional<int> r{};
+			if (o) {
+				const std::optional<int> k{ value_traits<T>::key(*o) };
+				if (k && 0 <= *k) r = *k + 1;
+			}
+#endif
+			return r.value_or(-1);
+		}
+
+		static int value_or(const type& o) { return value_traits<T>::key(o.value_or(fallback<T>())); }
+	};
+
+	/**
+	* @brief ポインタによる表現（nullptrが無効値）
+	* @detail 値は別の場所に既に存在しているものとする、構築のコストを含まない下限値
+	*/
+	template<typename T>
+	struct pointer_impl {
+		static constexpr const char* name = "T* (nullptr)";
+		using type = const T*;
+
+		static const T& storage(int seed) {
+			static const T values[2] = { value_traits<T>::make(0), value_traits<T>::make(1) };
+			return values[seed & 1];
+		}
+
+		static type make(int seed) { return &storage(seed); }
+		static type empty() { return nullptr; }
+		static void emplace(type& o, int seed) { o = &storage(seed); }
+		static void swap(type& a, type& b) { std::swap(a, b); }
+
+		static int chain(const type& o) {
+			if (o == nullptr) return -1;
+			const int k = value_traits<T>::key(*o);
+			return (k < 0) ? -1 : k + 1;
+		}
+
+		static int value_or(const type& o) {
+			const T v = (o != nullptr) ? *o : fallback<T>();
+			return value_traits<T>::key(v);
+		}
+	};
+
+	/**
+	* @brief 番兵値による表現（INT_MINが無効値）、intのみ
+	*/
+	struct sentinel_impl {
+		static constexpr const char* name = "int (INT_MIN sentinel)";
+		using type = int;
+
+		static type make(int seed) { return seed; }
+		static type empty() { return INT_MIN; }
+		static void emplace(type& o, int seed) { o = seed; }
+		static void swap(type& a, type& b) { std::swap(a, b); }
+
+		static int chain(const type& o) {
+			if (o == INT_MIN) return -1;
+			return (o < 0) ? -1 : o + 1;
+		}
+
+		static int value_or(const type& o) { return (o != INT_MIN) ? o : -1; }
+	};
+
+	//各操作の計測
+
+	template<typename Impl>
+	result bench_construct() {
+		return measure(Impl::name, [](std::size_t n) {
+			int seed = 1;
+			do_not_optimize(seed);
+			for (std::size_t i = 0; i < n; ++i) {
+				auto o = Impl::make(seed);
+				do_not_optimize(o);
+			}
+		});
+	}
+
+	template<typename Impl>
+	result bench_copy() {
+		return measure(Impl::name, [](std::size_t n) {
+			const auto src = Impl::make(1);
+			for (std::size_t i = 0; i < n; ++i) {
+				auto o = src;
+				do_not_optimize(o);
+			}
+		});
+	}
+
+	template<typename Impl>
+	result bench_move() {
+		return measure(Impl::name, [](std::size_t n) {
+			auto a = Impl::make(1);
+			for (std::size_t i = 0; i < n; ++i) {
+				auto b = std::move(a);
+				do_not_optimize(b);
+				a = std::move(b);
+			}
+			do_not_optimize(a);
+		});
+	}
+
+	template<typename Impl>
+	result bench_assign() {
+		return measure(Impl::name, [](std::size_t n) {
+			const auto src = Impl::make(1);
+			auto a = Impl::empty();
+			for (std::size_t i = 0; i < n; ++i) {
+				a = src;
+				do_not_optimize(a);
+			}
+		});
+	}
+
+	template<typename Impl>
+	result bench_swap() {
+		return measure(Impl::name, [](std::size_t n) {
+			auto a = Impl::make(1);
+			auto b = Impl::empty();
+			for (std::size_t i = 0; i < n; ++i) {
+				Impl::swap(a, b);
+				do_not_optimize(a);
+				do_not_optimize(b);
+			}
+		});
+	}
+
+	template<typename Impl>
+	result bench_emplace() {
+		return measure(Impl::name, [](std::size_t n) {
+			auto a = Impl::empty();
+			for (std::size_t i = 0; i < n; ++i) {
+				Impl::emplace(a, static_cast<int>(i & 1));
+				do_not_optimize(a);
+			}
+		});
+	}
+
+	/**
+	* @brief std::vectorへの追加（再確保を含む）
+	* @detail 再確保時に要素がムーブされるかコピーされるかで差が出る
+	*/
+	template<typename Impl>
+	result bench_vector_growth() {
+		return measure(Impl::name, [](std::size_t n) {
+			const auto src = Impl::make(1);
+			std::vector<typename Impl::type> v{};
+			for (std::size_t i = 0; i < n; ++i) {
+				//一定の長さで解放し、再確保を繰り返させる
+				if (v.size() == 1024) {
+					v = std::vector<typename Impl::type>{};
+				}
+				v.push_back((i & 1) ? src : Impl::empty());
+				clobber();
+			}
+			do_not_optimize(v);
+		});
+	}
+
+	template<typename Impl>
+	result bench_chain() {
+		return measure(Impl::name, [](std::size_t n) {
+			typename Impl::type values[2] = { Impl::make(1), Impl::empty() };
+			int sum = 0;
+			for (std::size_t i = 0; i < n; ++i) {
+				do_not_optimize(values);
+				sum += Impl::chain(values[i & 1]);
+			}
+			do_not_optimize(sum);
+		});
+	}
+
+	template<typename Impl>
+	result bench_value_or() {
+		return measure(Impl::name, [](std::size_t n) {
+			typename Impl::type values[2] = { Impl::make(1), Impl::empty() };
+			int sum = 0;
+			for (std::size_t i = 0; i < n; ++i) {
+				do_not_optimize(values);
+				sum += Impl::value_or(values[i & 1]);
+			}
+			do_not_optimize(sum);
+		});
+	}
+
+	/**
+	* @brief 比較対象の実装の一覧
+	*/
+	template<typename T>
+	struct impl_list {
+		template<template<typename> class Bench>
+		static std::vector<result> run() {
+			return { Bench<lstl_impl<T>>::run(), Bench<std_impl<T>>::run(), Bench<pointer_impl<T>>::run() };
+		}
+	};
+
+	template<>
+	struct impl_list<int> {
+		template<template<typename> class Bench>
+		static std::vector<result> run() {
+			return { Bench<lstl_impl<int>>::run(), Bench<std_impl<int>>::run(), Bench<pointer_impl<int>>::run(), Bench<sentinel_impl>::run() };
+		}
+	};
+
+#define LSTL_BENCH_OPERATION(op) \
+	template<typename Impl> \
+	struct op##_op { \
+		static result run() { return bench_##op<Impl>(); } \
+	};
+
+	LSTL_BENCH_OPERATION(construct)
+	LSTL_BENCH_OPERATION(copy)
+	LSTL_BENCH_OPERATION(move)
+	LSTL_BENCH_OPERATION(assign)
+	LSTL_BENCH_OPERATION(swap)
+	LSTL_BENCH_OPERATION(emplace)
+	LSTL_BENCH_OPERATION(vector_growth)
+	LSTL_BENCH_OPERATION(chain)
+	LSTL_BENCH_OPERATION(value_or)
+
+#undef LSTL_BENCH_OPERATION
+
+	template<typename T>
+	void run_all(const filter& f) {
+		const std::string type = value_traits<T>::name;
+
+		auto section = [&](const char* op, auto runner) {
+			const std::string title = std::string(op) + "<" + type + ">";
+			if (f.match(title)) {
+				report(title, runner());
+			}
+		};
+
+		section("construct", [] { return impl_list<T>::template run<construct_op>(); });
+		//ムーブオンリーな型はコピーを伴う操作を計測しない
+		if constexpr (std::is_copy_constructible<T>::value) {
+			section("copy", [] { return impl_list<T>::template run<copy_op>(); });
+			section("assign", [] { return impl_list<T>::template run<assign_op>(); });
+			section("vector growth", [] { return impl_list<T>::template run<vector_growth_op>(); });
+		}
+		section("move", [] { return impl_list<T>::template run<move_op>(); });
+		section("swap", [] { return impl_list<T>::template run<swap_op>(); });
+		section("emplace", [] { return impl_list<T>::template run<emplace_op>(); });
+		section("and_then chain", [] { return impl_list<T>::template run<chain_op>(); });
+		if constexpr (std::is_copy_constructible<T>::value) {
+			section("value_or", [] { return impl_list<T>::template run<value_or_op>(); });
+		}
+	}
+}
+
+namespace {
+
+	//6段のデコード処理の各段
+	//関数オブジェクトとして渡し、どちらの実装でもインライン展開されるようにする
+	const auto check = [](std::string&& s) {
+		return s.empty() ? lstl::optional<std::string>{} : lstl::optional<std::string>{ lstl::in_place, std::move(s) };
+	};
+
+	const auto upper = [](std::string&& s) {
+		s[0] = static_cast<char>(s[0] & ~0x20);
+		return std::move(s);
+	};
+
+	const auto append = [](std::string&& s) {
+		s.back() = '!';
+		return std::move(s);
+	};
+
+	const auto length = [](std::string&& s) {
+		return s.size();
+	};
+
+	/**
+	* @brief メンバ関数の連鎖、段ごとに中間のoptionalを作る
+	*/
+	result bench_member_chain() {
+		return measure("lstl::optional members", [](std::size_t n) {
+			const std::string src(40, 'a');
+			std::size_t sum = 0;
+			for (std::size_t i = 0; i < n; ++i) {
+				lstl::optional<std::string> o{ src };
+				do_not_optimize(o);
+				sum += std::move(o)
+					.and_then(check)
+					.transform(upper)
+					.and_then(check)
+					.transform(append)
+					.transform(upper)
+					.transform(length)
+					.value_or(0);
+			}
+			do_not_optimize(sum);
+		});
+	}
+
+	/**
+	* @brief 融合したパイプライン
+	*/
+	result bench_pipeline() {
+		return measure("lstl::optional_pipeline", [](std::size_t n) {
+			const std::string src(40, 'a');
+			std::size_t sum = 0;
+			for (std::size_t i = 0; i < n; ++i) {
+				lstl::optional<std::string> o{ src };
+				do_not_optimize(o);
+				sum += std::move(o)
+					| lstl::then(check)
+					| lstl::map(upper)
+					| lstl::then(check)
+					| lstl::map(append)
+					| lstl::map(upper)
+					| lstl::map(length)
+					| lstl::value_or(std::size_t(0));
+			}
+			do_not_optimize(sum);
+		});
+	}
+}
+
+int main(int argc, char** argv) {
+	const lstl::bench::filter f{ argc, argv };
+
+	run_all<int>(f);
+	run_all<std::string>(f);
+	run_all<pod64>(f);
+	run_all<move_only>(f);
+
+	if (f.match("decode chain<std::string>")) {
+		report("decode chain<std::string>", { bench_member_chain(), bench_pipeline() });
+	}
+}
\ No newline at end of file
@@ -0,0 +1,183 @@
+﻿//optionalの比較と整列のベンチマーク
+//一定の割合で無効値を含むoptionalの配列を整列し、整列済みの配列を二分探索する
+//sort_optionalは無効値を集めてから有効値のみを（整数型と浮動小数点数型は基数ソートで）整列する
+//通常の比較（operator<）は有効値の有無で分岐し、順序キーによる比較（order_key_less）は分岐しない
+//std::sortは比較結果で分岐するので前者が速く、分岐の無い二分探索では比較の中の分岐が予測の失敗となるので後者が速い
+//
+//使い方: optional_sort_bench [名前の一部...]
+
+#include "bench.hpp"
+
+#include "Include/optional.hpp"
+#include "Include/optional_algorithm.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace {
+
+	using namespace lstl::bench;
+
+	constexpr std::size_t element_count = 4096;
+
+	/**
+	* @brief 無効値をpercent%含む、ランダムな値のoptionalの配列
+	*/
+	template<typename Optional, typename T>
+	std::vector<Optional> make_inputs(unsigned percent) {
+		std::vector<Optional> inputs{};
+		std::uint32_t seed = 12345;
+
+		for (std::size_t i = 0; i < element_count; ++i) {
+			seed = seed * 1664525u + 1013904223u;
+			if ((seed >> 8) % 100 < percent) {
+				inputs.emplace_back();
+			}
+			else {
+				inputs.emplace_back(static_cast<T>(static_cast<std::int32_t>(seed) >> 4));
+			}
+		}
+		return inputs;
+	}
+
+	/**
+	* @brief 入力の複製を整列する、1回の整列を1操作とする
+	*/
+	template<typename Optional, typename Compare>
+	result bench_sort(const std::string& name, const std::vector<Optional>& inputs, Compare comp) {
+		std::vector<Optional> work(inputs.size());
+
+		return measure(name, [&](std::size_t n) {
+			for (std::size_t i = 0; i < n; ++i) {
+				std::copy(inputs.begin(), inputs.end(), work.begin());
+				std::sort(work.begin(), work.end(), comp);
+				do_not_optimize(work.front());
+			}
+		});
+	}
+
+	/**
+	* @brief 入力の複製をsort_optional等で整列する、1回の整列を1操作とする
+	*/
+	template<typename Optional, typename Sort>
+	result bench_sort_optional(const std::string& name, const std::vector<Optional>& inputs, Sort sort) {
+		std::vector<Optional> work(inputs.size());
+
+		return measure(name, [&](std::size_t n) {
+			for (std::size_t i = 0; i < n; ++i) {
+				std::copy(inputs.begin(), inputs.end(), work.begin());
+				sort(work.begin(), work.end());
+				do_not_optimize(work.front());
+			}
+		});
+	}
+
+	/**
+	* @brief 無効値をpercent%含む、ナノ秒単位のタイムスタンプの列
+	* @detail 1日の範囲に散らばった時刻、上位の桁はほとんどの要素で等しい
+	*/
+	template<typename Optional>
+	std::vector<Optional> make_timestamps(std::size_t count, unsigned percent) {
+		std::vector<Optional> inputs{};
+		std::uint64_t seed = 12345;
+		const std::int64_t base = 1700000000LL * 1000000000LL;
+
+		for (std::size_t i = 0; i < count; ++i) {
+			seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			if ((seed >> 40) % 100 < percent) {
+				inputs.emplace_back();
+			}
+			else {
+				inputs.emplace_back(base + static_cast<std::int64_t>((seed >> 11) % (86400ULL * 1000000000ULL)));
+			}
+		}
+		return inputs;
+	}
+
+	const auto lstl_sort_optional = [](auto first, auto last) { lstl::sort_optional(first, last); };
+	const auto lstl_stable_sort_optional = [](auto first, auto last) { lstl::stable_sort_optional(first, last); };
+
+	/**
+	* @brief 分岐の無い二分探索（比較結果で探索範囲の先頭を条件付き移動する）、1回の探索を1操作とする
+	*/
+	template<typename Optional, typename Compare>
+	result bench_search(const std::string& name, const std::vector<Optional>& inputs, Compare comp) {
+		std::vector<Optional> sorted = inputs;
+		std::sort(sorted.begin(), sorted.end(), comp);
+
+		return measure(name, [&](std::size_t n) {
+			std::size_t sum = 0;
+			for (std::size_t i = 0; i < n; ++i) {
+				const Optional& key = inputs[i % inputs.size()];
+				const Optional* base = sorted.data();
+				std::size_t length = sorted.size();
+
+				while (1 < length) {
+					const std::size_t half = length / 2;
+					base = comp(base[half - 1], key) ? base + half : base;
+					length -= half;
+				}
+				sum += static_cast<std::size_t>(base - sorted.data());
+			}
+			do_not_optimize(sum);
+		});
+	}
+
+	template<typename T>
+	void run(const filter& f, const char* type_name) {
+		static_assert(sizeof(T) < sizeof(long long), "order_key requires an integer narrower than long long");
+
+		for (unsigned percent : { 0u, 10u, 50u, 90u }) {
+			const std::string suffix = std::string(" optional<") + type_name + "> x" + std::to_string(element_count) + " null=" + std::to_string(percent) + "%";
+
+			const auto std_inputs = make_inputs<std::optional<T>, T>(percent);
+			const auto lstl_inputs = make_inputs<lstl::optional<T>, T>(percent);
+
+			if (f.match("sort" + suffix)) {
+				report("sort" + suffix, {
+					bench_sort("std::optional", std_inputs, std::less<>{}),
+					bench_sort("lstl::optional", lstl_inputs, std::less<>{}),
+					bench_sort("lstl::optional order_key_less", lstl_inputs, lstl::order_key_less{}),
+					bench_sort_optional("lstl::sort_optional", lstl_inputs, lstl_sort_optional),
+					bench_sort_optional("lstl::stable_sort_optional", lstl_inputs, lstl_stable_sort_optional),
+				});
+			}
+
+			if (f.match("search" + suffix)) {
+				report("search" + suffix, {
+					bench_search("std::optional", std_inputs, std::less<>{}),
+					bench_search("lstl::optional", lstl_inputs, std::less<>{}),
+					bench_search("lstl::optional order_key_less", lstl_inputs, lstl::order_key_less{}),
+				});
+			}
+		}
+	}
+
+	void run_timestamps(const filter& f) {
+		for (std::size_t count : { std::size_t(4096), std::size_t(1) << 20 }) {
+			for (unsigned percent : { 10u, 50u }) {
+				const std::string title = "sort timestamp optional<int64_t> x" + std::to_string(count) + " null=" + std::to_string(percent) + "%";
+				if (!f.match(title)) continue;
+
+				const auto std_inputs = make_timestamps<std::optional<std::int64_t>>(count, percent);
+				const auto lstl_inputs = make_timestamps<lstl::optional<std::int64_t>>(count, percent);
+
+				report(title, {
+					bench_sort("std::optional", std_inputs, std::less<>{}),
+					bench_sort("lstl::optional", lstl_inputs, std::less<>{}),
+					bench_sort_optional("lstl::sort_optional", lstl_inputs, lstl_sort_optional),
+					bench_sort_optional("lstl::stable_sort_optional", lstl_inputs, lstl_stable_sort_optional),
+				});
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	const lstl::bench::filter f{ argc, argv };
+
+	run<int>(f, "int");
+	run<short>(f, "short");
+	run_timestamps(f);
+}
\ No newline at end of file
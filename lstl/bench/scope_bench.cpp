@@ -0,0 +1,190 @@
+﻿//scope_exit、scope_fail、scope_successの構築と破棄のベンチマーク
+//scope_failとscope_successは構築時と破棄時に投げられている例外の数を得る
+//std::uncaught_exceptions()による方法（std_uncaught_exceptions）と、スレッドごとの例外情報へのポインタをキャッシュする方法（cached_uncaught_exceptions、既定）を比較する
+//ロールバック処理のリストとして、std::vector<std::function<void()>>とscope_stackを比較する
+//
+//使い方: scope_bench [名前の一部...]
+
+#include "bench.hpp"
+
+#include "Include/scope.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#if defined(_MSC_VER)
+#define SCOPE_BENCH_NOINLINE __declspec(noinline)
+#else
+#define SCOPE_BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+namespace {
+
+	using namespace lstl::bench;
+
+	/**
+	* @brief カウンタを増やすだけの関数オブジェクト
+	*/
+	struct increment {
+		std::uint64_t* counter;
+
+		void operator()() noexcept {
+			++*counter;
+		}
+	};
+
+	template<typename Policy>
+	using guard = lstl::common_scope_exit<increment, Policy>;
+
+	/**
+	* @brief 1つのガードを構築して破棄する
+	*/
+	template<typename Policy>
+	result bench_single(const std::string& name) {
+		return measure(name, [](std::size_t n) {
+			std::uint64_t counter = 0;
+			for (std::size_t i = 0; i < n; ++i) {
+				guard<Policy> g{ increment{ &counter } };
+				clobber();
+			}
+			do_not_optimize(counter);
+		});
+	}
+
+	/**
+	* @brief インライン展開されない関数の中で、4つのガードを構築して破棄する
+	* @detail 複数の資源を順に確保し、失敗時に巻き戻す処理を想定する
+	*/
+	template<typename Policy>
+	SCOPE_BENCH_NOINLINE void transaction(std::uint64_t* counter) {
+		guard<Policy> g0{ increment{ counter } };
+		clobber();
+		guard<Policy> g1{ increment{ counter } };
+		clobber();
+		guard<Policy> g2{ increment{ counter } };
+		clobber();
+		guard<Policy> g3{ increment{ counter } };
+		clobber();
+	}
+
+	template<typename Policy>
+	result bench_transaction(const std::string& name) {
+		return measure(name, [](std::size_t n) {
+			std::uint64_t counter = 0;
+			for (std::size_t i = 0; i < n; ++i) {
+				transaction<Policy>(&counter);
+			}
+			do_not_optimize(counter);
+		});
+	}
+
+	/**
+	* @brief 1つの段階のロールバック処理、ポインタを3つ持つ（std::functionの内部バッファには収まらない）
+	*/
+	struct rollback {
+		std::uint64_t* counter;
+		const void* object;
+		const void* index;
+
+		void operator()() const noexcept {
+			++*counter;
+		}
+	};
+
+	/**
+	* @brief count個のロールバック処理を登録し、全て成功したとしてコミットする（又は全て実行する）
+	*/
+	template<typename Stack>
+	result bench_stack(const std::string& name, int count, bool commit) {
+		return measure(name, [count, commit](std::size_t n) {
+			std::uint64_t counter = 0;
+			for (std::size_t i = 0; i < n; ++i) {
+				Stack stack{};
+				for (int k = 0; k < count; ++k) {
+					stack.push(rollback{ &counter, &stack, &k });
+				}
+				if (commit) stack.release();
+				clobber();
+			}
+			do_not_optimize(counter);
+		});
+	}
+
+	/**
+	* @brief std::vector<std::function<void()>>によるロールバック処理のリスト
+	*/
+	template<bool Execute>
+	struct function_vector {
+		std::vector<std::function<void()>> actions;
+
+		void push(rollback r) {
+			actions.emplace_back(r);
+		}
+
+		void release() {
+			actions.clear();
+		}
+
+		~function_vector() {
+			if (Execute) {
+				for (auto it = actions.rbegin(); it != actions.rend(); ++it) {
+					(*it)();
+				}
+			}
+		}
+	};
+
+	void run_stack(const filter& f) {
+		for (int count : { 4, 10, 40 }) {
+			const std::string suffix = " x" + std::to_string(count);
+
+			if (f.match("rollback commit" + suffix)) {
+				report("rollback commit" + suffix, {
+					bench_stack<function_vector<false>>("std::vector<std::function>", count, true),
+					bench_stack<lstl::scope_stack<>>("lstl::scope_stack", count, true),
+				});
+			}
+
+			if (f.match("rollback execute" + suffix)) {
+				report("rollback execute" + suffix, {
+					bench_stack<function_vector<true>>("std::vector<std::function>", count, false),
+					bench_stack<lstl::scope_stack<lstl::policy::exit>>("lstl::scope_stack<policy::exit>", count, false),
+				});
+			}
+		}
+	}
+
+	template<template<typename> class Bench>
+	void run(const filter& f, const std::string& title) {
+		if (!f.match(title)) return;
+
+		namespace policy = lstl::policy;
+
+		report(title, {
+			Bench<policy::exit>::run("scope_exit"),
+			Bench<policy::basic_fail<policy::std_uncaught_exceptions>>::run("scope_fail std::uncaught_exceptions"),
+			Bench<policy::fail>::run("scope_fail cached"),
+			Bench<policy::basic_succes<policy::std_uncaught_exceptions>>::run("scope_success std::uncaught_exceptions"),
+			Bench<policy::succes>::run("scope_success cached"),
+		});
+	}
+
+	template<typename Policy>
+	struct single {
+		static result run(const std::string& name) { return bench_single<Policy>(name); }
+	};
+
+	template<typename Policy>
+	struct four_in_function {
+		static result run(const std::string& name) { return bench_transaction<Policy>(name); }
+	};
+}
+
+int main(int argc, char** argv) {
+	const lstl::bench::filter f{ argc, argv };
+
+	run<single>(f, "one guard");
+	run<four_in_function>(f, "four guards in a function");
+	run_stack(f);
+}
\ No newline at end of file
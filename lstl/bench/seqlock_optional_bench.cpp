@@ -0,0 +1,150 @@
+﻿//seqlock_optionalの読み込み側のスケーラビリティのベンチマーク
+//1つの書き込み側が256バイトの値を公開し続け、1からN個の読み込み側がそれを取得する
+//
+//使い方: seqlock_optional_bench [名前の一部...]
+
+#include "bench.hpp"
+
+#include "Include/seqlock_optional.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+	using namespace lstl::bench;
+
+	struct snapshot {
+		std::uint64_t fields[32];
+	};
+
+	snapshot make_snapshot(std::uint64_t n) {
+		snapshot s;
+		for (auto& f : s.fields) f = n;
+		return s;
+	}
+
+	/**
+	* @brief std::shared_mutexで保護したoptional
+	*/
+	struct shared_mutex_cell {
+		static constexpr const char* name = "std::shared_mutex + optional";
+
+		mutable std::shared_mutex m;
+		lstl::optional<snapshot> value;
+
+		void publish(const snapshot& s) {
+			std::unique_lock<std::shared_mutex> lock{ m };
+			value = s;
+		}
+
+		lstl::optional<snapshot> load() const {
+			std::shared_lock<std::shared_mutex> lock{ m };
+			return value;
+		}
+	};
+
+	struct seqlock_cell {
+		static constexpr const char* name = "seqlock_optional";
+
+		lstl::seqlock_optional<snapshot> cell;
+
+		void publish(const snapshot& s) {
+			cell.publish(s);
+		}
+
+		lstl::optional<snapshot> load() const {
+			return cell.load();
+		}
+	};
+
+	/**
+	* @brief 書き込み側が公開し続ける間、readers個の読み込み側がそれぞれn回読む（1回の読み込みあたりの時間）
+	*/
+	template<typename Cell>
+	result bench_read(unsigned readers) {
+		return measure(Cell::name, [readers](std::size_t n) {
+			Cell cell{};
+			std::atomic<bool> stop{ false };
+
+			//公開の合間には他の処理があるものとし、スレッドを譲る
+			std::thread writer{ [&] {
+				for (std::uint64_t i = 1; !stop.load(std::memory_order_relaxed); ++i) {
+					cell.publish(make_snapshot(i));
+					std::this_thread::yield();
+				}
+			} };
+
+			std::vector<std::thread> threads{};
+			for (unsigned r = 0; r < readers; ++r) {
+				threads.emplace_back([&cell, n] {
+					std::uint64_t sum = 0;
+					for (std::size_t i = 0; i < n; ++i) {
+						const auto v = cell.load();
+						sum += v ? v->fields[0] : 0;
+					}
+					do_not_optimize(sum);
+				});
+			}
+
+			for (auto& th : threads) th.join();
+			stop.store(true);
+			writer.join();
+		}, 3);
+	}
+
+	/**
+	* @brief readers個の読み込み側が読み続ける間、書き込み側がn回公開する（1回の公開あたりの時間）
+	*/
+	template<typename Cell>
+	result bench_publish(unsigned readers) {
+		return measure(Cell::name, [readers](std::size_t n) {
+			Cell cell{};
+			std::atomic<bool> stop{ false };
+
+			std::vector<std::thread> threads{};
+			for (unsigned r = 0; r < readers; ++r) {
+				threads.emplace_back([&] {
+					std::uint64_t sum = 0;
+					while (!stop.load(std::memory_order_relaxed)) {
+						const auto v = cell.load();
+						sum += v ? v->fields[0] : 0;
+					}
+					do_not_optimize(sum);
+				});
+			}
+
+			for (std::size_t i = 0; i < n; ++i) {
+				cell.publish(make_snapshot(i));
+			}
+
+			stop.store(true);
+			for (auto& th : threads) th.join();
+		}, 3);
+	}
+}
+
+int main(int argc, char** argv) {
+	const lstl::bench::filter f{ argc, argv };
+
+	//1からハードウェアスレッド数まで、2倍ずつ
+	const unsigned max_readers = (std::max)(1u, std::thread::hardware_concurrency());
+
+	std::vector<unsigned> counts{};
+	for (unsigned r = 1; r < max_readers; r *= 2) counts.push_back(r);
+	counts.push_back(max_readers);
+
+	for (unsigned readers : counts) {
+		const std::string suffix = " readers=" + std::to_string(readers);
+
+		if (f.match("read" + suffix)) {
+			report("read" + suffix, { bench_read<shared_mutex_cell>(readers), bench_read<seqlock_cell>(readers) });
+		}
+		if (f.match("publish" + suffix)) {
+			report("publish" + suffix, { bench_publish<shared_mutex_cell>(readers), bench_publish<seqlock_cell>(readers) });
+		}
+	}
+}
\ No newline at end of file
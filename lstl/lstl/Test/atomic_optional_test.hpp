@@ -0,0 +1,168 @@
+﻿#pragma once
+
+#include "common.h"
+
+#include "Include/atomic_optional.hpp"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace lstl::test::atomic_optional
+{
+	//0を無効値とする識別子
+	enum class ticket : std::uint64_t {};
+}
+
+namespace lstl {
+
+	template<>
+	struct invalid_value_traits<test::atomic_optional::ticket> : invalid_value_constant<test::atomic_optional::ticket, test::atomic_optional::ticket(0)> {};
+}
+
+namespace lstl::test::atomic_optional
+{
+	//8バイト以下のワードはstd::atomicによって常にロックフリー
+	static_assert(lstl::atomic_optional<int>::is_always_lock_free, "");
+	static_assert(lstl::atomic_optional<ticket>::is_always_lock_free, "");
+	static_assert(lstl::atomic_optional<std::uint32_t>::is_always_lock_free, "");
+
+#if LSTL_HAS_ATOMIC_CAS128
+	//16バイトのワードはcmpxchg16bによって常にロックフリー（ロックを用いるstd::atomicにはならない）
+	static_assert(lstl::atomic_optional<std::uint64_t>::is_always_lock_free, "");
+#endif // LSTL_HAS_ATOMIC_CAS128
+
+	/**
+	* @brief producers個のスレッドが値を1つずつスロットへ渡し、consumers個のスレッドがそれを取り出す
+	* @return 全ての値がちょうど1回ずつ取り出されたか
+	*/
+	template<typename T, typename Make>
+	bool handoff_stress(Make make, int producers, int consumers, int per_producer) {
+		lstl::atomic_optional<T> slot{};
+
+		const int total = producers * per_producer;
+		std::vector<std::atomic<int>> seen(static_cast<std::size_t>(total));
+		for (auto& s : seen) s.store(0);
+
+		std::atomic<int> taken{ 0 };
+		std::vector<std::thread> threads{};
+
+		for (int p = 0; p < producers; ++p) {
+			threads.emplace_back([&, p] {
+				for (int i = 0; i < per_producer; ++i) {
+					const lstl::optional<T> value{ make(p * per_producer + i) };
+
+					//空いていれば置く
+					for (;;) {
+						lstl::optional<T> expected{};
+						if (slot.compare_exchange_weak(expected, value, std::memory_order_release, std::memory_order_relaxed)) break;
+						std::this_thread::yield();
+					}
+				}
+			});
+		}
+
+		for (int c = 0; c < consumers; ++c) {
+			threads.emplace_back([&] {
+				while (taken.load() < total) {
+					if (auto v = slot.take(std::memory_order_acquire)) {
+						seen[static_cast<std::size_t>(static_cast<std::uint64_t>(*v) - 1)].fetch_add(1);
+						taken.fetch_add(1);
+					}
+					else {
+						std::this_thread::yield();
+					}
+				}
+			});
+		}
+
+		for (auto& th : threads) th.join();
+
+		for (auto& s : seen) {
+			if (s.load() != 1) return false;
+		}
+		return !slot.load().has_value();
+	}
+
+	TEST_CLASS(atomic_optional_test)
+	{
+	public:
+
+		TEST_METHOD(atomic_optional_operation_test) {
+			lstl::atomic_optional<int> a{};
+
+			Assert::IsTrue(a.is_lock_free());
+			Assert::IsFalse(a.load().has_value());
+
+			a.store(10);
+			Assert::AreEqual(10, *a.load());
+
+			//0も有効値として区別される
+			Assert::AreEqual(10, *a.exchange(0));
+			Assert::AreEqual(0, *a.load());
+
+			Assert::AreEqual(0, *a.take());
+			Assert::IsFalse(a.load().has_value());
+			Assert::IsFalse(a.take().has_value());
+
+			//無効値を期待するCAS
+			lstl::optional<int> expected{};
+			Assert::IsTrue(a.compare_exchange_strong(expected, 5));
+			Assert::AreEqual(5, *a.load());
+
+			//失敗時は現在の値が書き込まれる
+			expected = lstl::nullopt;
+			Assert::IsFalse(a.compare_exchange_strong(expected, 6));
+			Assert::AreEqual(5, *expected);
+
+			Assert::IsTrue(a.compare_exchange_strong(expected, lstl::nullopt));
+			Assert::IsFalse(a.load().has_value());
+		}
+
+		TEST_METHOD(atomic_optional_layout_test) {
+#if LSTL_HAS_ATOMIC_CAS128
+			//値とフラグで16バイトのワードを用いる
+			lstl::atomic_optional<std::uint64_t> wide{ std::uint64_t(0xFFFFFFFFFFFFFFFFull) };
+
+			Assert::IsTrue(wide.is_lock_free());
+			Assert::IsTrue(0xFFFFFFFFFFFFFFFFull == *wide.load());
+			Assert::IsTrue(0xFFFFFFFFFFFFFFFFull == *wide.take());
+			Assert::IsFalse(wide.load().has_value());
+
+			lstl::optional<std::uint64_t> expected{};
+			Assert::IsTrue(wide.compare_exchange_strong(expected, std::uint64_t(1)));
+			Assert::IsTrue(1 == *wide.load());
+#endif // LSTL_HAS_ATOMIC_CAS128
+
+			//無効値を持つ型はsizeof(T)のワードに収まる
+			lstl::atomic_optional<ticket> narrow{};
+
+			Assert::IsTrue(narrow.is_lock_free());
+			Assert::IsFalse(narrow.load().has_value());
+
+			narrow.store(ticket(42));
+			Assert::IsTrue(ticket(42) == *narrow.load());
+
+			//無効値を書き込むと無効状態になる
+			narrow.store(ticket(0));
+			Assert::IsFalse(narrow.load().has_value());
+
+#if LSTL_HAS_ATOMIC_CAS128
+			lstl::atomic_optional<double> d{ 1.5 };
+			Assert::AreEqual(1.5, *d.load());
+#endif // LSTL_HAS_ATOMIC_CAS128
+		}
+
+		TEST_METHOD(atomic_optional_stress_test) {
+			const auto make_ticket = [](int i) { return ticket(static_cast<std::uint64_t>(i + 1)); };
+			const auto make_u32 = [](int i) { return static_cast<std::uint32_t>(i + 1); };
+
+#if LSTL_HAS_ATOMIC_CAS128
+			const auto make_u64 = [](int i) { return static_cast<std::uint64_t>(i + 1); };
+			Assert::IsTrue(handoff_stress<std::uint64_t>(make_u64, 4, 4, 5000));
+#endif // LSTL_HAS_ATOMIC_CAS128
+			Assert::IsTrue(handoff_stress<ticket>(make_ticket, 4, 4, 5000));
+			Assert::IsTrue(handoff_stress<std::uint32_t>(make_u32, 2, 6, 5000));
+		}
+	};
+}
\ No newline at end of file
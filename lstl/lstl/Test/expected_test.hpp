@@ -0,0 +1,209 @@
+﻿#pragma once
+
+#include "common.h"
+
+#include "Include/expected.hpp"
+
+#include <string>
+#include <memory>
+#include <system_error>
+
+namespace lstl::test::expected
+{
+	enum class parse_error {
+		empty,
+		not_digit,
+		overflow
+	};
+
+	//例外を投げずに整数を読む
+	inline lstl::expected<int, parse_error> parse_int(const std::string& str) {
+		if (str.empty()) return lstl::make_unexpected(parse_error::empty);
+
+		int result = 0;
+		for (char c : str) {
+			if (c < '0' || '9' < c) return lstl::make_unexpected(parse_error::not_digit);
+			if (result > 100000000) return lstl::make_unexpected(parse_error::overflow);
+			result = result * 10 + (c - '0');
+		}
+		return result;
+	}
+
+	//T、Eが共にtrivially copyableならばexpected<T, E>もtrivially copyable
+	static_assert(std::is_trivially_copyable<lstl::expected<int, parse_error>>::value, "");
+	static_assert(std::is_trivially_copyable<lstl::expected<double, int>>::value, "");
+	static_assert(std::is_trivially_copyable<lstl::expected<void, parse_error>>::value, "");
+	static_assert(std::is_trivially_destructible<lstl::expected<int, std::errc>>::value, "");
+	static_assert(!std::is_trivially_copyable<lstl::expected<std::string, parse_error>>::value, "");
+	static_assert(!std::is_trivially_copyable<lstl::expected<int, std::string>>::value, "");
+
+	//特殊メンバ関数の有無はT、E双方に従う
+	static_assert(std::is_copy_constructible<lstl::expected<std::string, int>>::value, "");
+	static_assert(!std::is_copy_constructible<lstl::expected<std::unique_ptr<int>, int>>::value, "");
+	static_assert(!std::is_copy_constructible<lstl::expected<int, std::unique_ptr<int>>>::value, "");
+	static_assert(std::is_move_constructible<lstl::expected<std::unique_ptr<int>, std::unique_ptr<int>>>::value, "");
+	static_assert(std::is_nothrow_move_constructible<lstl::expected<std::string, int>>::value, "");
+
+	//constな値を保持するexpectedは代入できない（std::expectedと同じ）
+	static_assert(!std::is_copy_assignable<lstl::expected<const int, int>>::value, "");
+	static_assert(!std::is_move_assignable<lstl::expected<const int, int>>::value, "");
+	static_assert(std::is_copy_constructible<lstl::expected<const int, int>>::value, "");
+	static_assert(!std::is_copy_assignable<lstl::expected<const std::string, int>>::value, "");
+
+	TEST_CLASS(expected_test)
+	{
+	public:
+
+		TEST_METHOD(expected_construct_test) {
+			{
+				lstl::expected<int, parse_error> e{};
+				Assert::IsTrue(e.has_value());
+				Assert::AreEqual(0, *e);
+			}
+			{
+				lstl::expected<std::string, int> e{ "value" };
+				Assert::IsTrue(bool(e));
+				Assert::IsTrue("value" == *e);
+				Assert::AreEqual(std::size_t(5), e->size());
+			}
+			{
+				lstl::expected<std::string, int> e{ lstl::unexpect, 42 };
+				Assert::IsFalse(e.has_value());
+				Assert::AreEqual(42, e.error());
+			}
+			{
+				lstl::expected<std::string, std::string> e{ lstl::make_unexpected(std::string("error")) };
+				Assert::IsFalse(e.has_value());
+				Assert::IsTrue("error" == e.error());
+
+				//コピーとムーブは保持する値の種類を保つ
+				auto copy = e;
+				Assert::IsFalse(copy.has_value());
+				Assert::IsTrue("error" == copy.error());
+
+				auto moved = std::move(copy);
+				Assert::IsTrue("error" == moved.error());
+			}
+			{
+				lstl::expected<std::string, int> e{ lstl::in_place, 3, 'a' };
+				Assert::IsTrue("aaa" == *e);
+
+				lstl::expected<std::string, int> f{ lstl::in_place_invoke, [](int n) { return std::string(n, 'b'); }, 2 };
+				Assert::IsTrue("bb" == *f);
+			}
+		}
+
+		TEST_METHOD(expected_assign_test) {
+			lstl::expected<std::string, std::string> e{ "value" };
+
+			e = lstl::make_unexpected(std::string("error"));
+			Assert::IsFalse(e.has_value());
+			Assert::IsTrue("error" == e.error());
+
+			e = "again";
+			Assert::IsTrue(e.has_value());
+			Assert::IsTrue("again" == *e);
+
+			lstl::expected<std::string, std::string> other{ lstl::unexpect, "other" };
+			e = other;
+			Assert::IsTrue("other" == e.error());
+
+			other = std::string("moved");
+			e = std::move(other);
+			Assert::IsTrue("moved" == *e);
+
+			e.emplace(std::string(2, 'x'));
+			Assert::IsTrue("xx" == *e);
+		}
+
+		TEST_METHOD(expected_value_access_test) {
+			auto ok = parse_int("123");
+			Assert::AreEqual(123, ok.value());
+			Assert::AreEqual(123, ok.value_or(-1));
+
+			auto ng = parse_int("12a");
+			Assert::AreEqual(-1, ng.value_or(-1));
+			Assert::IsTrue(parse_error::not_digit == ng.error());
+
+			bool thrown = false;
+			try {
+				ng.value();
+			}
+			catch (const lstl::bad_expected_access<parse_error>& ex) {
+				thrown = true;
+				Assert::IsTrue(parse_error::not_digit == ex.error());
+			}
+			Assert::IsTrue(thrown);
+		}
+
+		TEST_METHOD(expected_monadic_test) {
+			auto twice = [](int n) { return n * 2; };
+			auto to_string = [](int n) { return std::to_string(n); };
+			auto positive = [](int n) -> lstl::expected<int, parse_error> {
+				if (n <= 0) return lstl::make_unexpected(parse_error::overflow);
+				return n;
+			};
+
+			//transform
+			auto t = parse_int("21").transform(twice).transform(to_string);
+			static_assert(std::is_same<decltype(t), lstl::expected<std::string, parse_error>>::value, "");
+			Assert::IsTrue("42" == *t);
+			Assert::IsTrue(parse_error::empty == parse_int("").transform(twice).error());
+
+			//and_then
+			Assert::AreEqual(7, *parse_int("7").and_then(positive));
+			Assert::IsTrue(parse_error::overflow == parse_int("0").and_then(positive).error());
+			Assert::IsTrue(parse_error::not_digit == parse_int("x").and_then(positive).error());
+
+			//transform_error
+			auto message = parse_int("x").transform_error([](parse_error e) { return e == parse_error::not_digit ? std::string("not digit") : std::string("other"); });
+			static_assert(std::is_same<decltype(message), lstl::expected<int, std::string>>::value, "");
+			Assert::IsTrue("not digit" == message.error());
+			Assert::AreEqual(5, *parse_int("5").transform_error([](parse_error) { return 0; }));
+
+			//or_else
+			auto recover = [](parse_error) -> lstl::expected<int, std::string> { return 0; };
+			Assert::AreEqual(0, *parse_int("").or_else(recover));
+			Assert::AreEqual(9, *parse_int("9").or_else(recover));
+
+			//voidを返す関数はexpected<void, E>となる
+			int called = 0;
+			auto v = parse_int("1").transform([&called](int) { ++called; });
+			static_assert(std::is_same<decltype(v), lstl::expected<void, parse_error>>::value, "");
+			Assert::IsTrue(v.has_value());
+			Assert::AreEqual(1, called);
+		}
+
+		TEST_METHOD(expected_void_test) {
+			lstl::expected<void, std::string> ok{};
+			Assert::IsTrue(ok.has_value());
+			ok.value();
+
+			lstl::expected<void, std::string> ng{ lstl::unexpect, "failed" };
+			Assert::IsFalse(ng.has_value());
+			Assert::IsTrue("failed" == ng.error());
+
+			Assert::AreEqual(3, *ok.transform([] { return 3; }));
+			Assert::IsTrue("failed" == ng.transform([] { return 3; }).error());
+			Assert::AreEqual(std::size_t(6), ng.transform_error([](const std::string& s) { return s.size(); }).error());
+			Assert::IsTrue(ng.or_else([](const std::string&) { return lstl::expected<void, int>{}; }).has_value());
+
+			ng.emplace();
+			Assert::IsTrue(ng.has_value());
+			Assert::IsTrue(ok == ng);
+		}
+
+		TEST_METHOD(expected_compare_test) {
+			lstl::expected<int, int> a{ 1 };
+			lstl::expected<long, int> b{ 1L };
+			lstl::expected<int, int> c{ lstl::unexpect, 1 };
+
+			Assert::IsTrue(a == b);
+			Assert::IsTrue(a != c);
+			Assert::IsTrue(a == 1);
+			Assert::IsTrue(2 != a);
+			Assert::IsTrue(c == lstl::make_unexpected(1));
+			Assert::IsTrue(a != lstl::make_unexpected(1));
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+﻿#pragma once
+
+#include "common.h"
+
+#include "Include/lazy_optional.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+
+namespace lstl::test::lazy_optional
+{
+	inline std::string make_table() {
+		return std::string(64, 't');
+	}
+
+	//constなオブジェクトからは書き換えられない参照が得られる
+	static_assert(std::is_same<decltype(*std::declval<lstl::lazy_optional<std::string>&>()), std::string&>::value, "");
+	static_assert(std::is_same<decltype(*std::declval<const lstl::lazy_optional<std::string>&>()), const std::string&>::value, "");
+	static_assert(std::is_same<decltype(std::declval<const lstl::lazy_optional<std::string>&>().value()), const std::string&>::value, "");
+	static_assert(std::is_same<decltype(std::declval<const lstl::lazy_optional<std::string>&>().operator->()), const std::string*>::value, "");
+	static_assert(std::is_same<decltype(*std::declval<const lstl::concurrent_lazy_optional<std::string>&>()), const std::string&>::value, "");
+	static_assert(std::is_same<decltype(std::declval<lstl::concurrent_lazy_optional<std::string>&>().value()), std::string&>::value, "");
+
+	TEST_CLASS(lazy_optional_test)
+	{
+	public:
+
+		TEST_METHOD(lazy_optional_access_test) {
+			int calls = 0;
+			auto lazy = lstl::make_lazy_optional([&calls] {
+				++calls;
+				return std::string("config");
+			});
+
+			//アクセスされるまで構築されない
+			Assert::IsFalse(lazy.has_value());
+			Assert::AreEqual(0, calls);
+
+			Assert::IsTrue("config" == *lazy);
+			Assert::IsTrue(lazy.has_value());
+			Assert::AreEqual(std::size_t(6), lazy->size());
+			Assert::AreEqual(1, calls);
+
+			//constなオブジェクトからのアクセスでも構築される
+			const auto& cref = lazy;
+			Assert::IsTrue("config" == cref.value());
+			Assert::AreEqual(1, calls);
+
+			//reset後は再び構築される
+			lazy.reset();
+			Assert::IsFalse(lazy.has_value());
+			Assert::IsTrue("config" == lazy.value());
+			Assert::AreEqual(2, calls);
+
+			//ムーブしても再構築されない
+			auto moved = std::move(lazy);
+			Assert::IsTrue(moved.has_value());
+			Assert::IsTrue("config" == *moved);
+			Assert::AreEqual(2, calls);
+
+			//関数ポインタ
+			lstl::lazy_optional<std::string> table{ &make_table };
+			Assert::AreEqual(std::size_t(64), table->size());
+		}
+
+		TEST_METHOD(lazy_optional_exception_test) {
+			int calls = 0;
+			auto lazy = lstl::make_lazy_optional([&calls] {
+				if (++calls == 1) throw std::runtime_error("failed");
+				return 42;
+			});
+
+			try {
+				lazy.value();
+				Assert::Fail();
+			}
+			catch (const std::runtime_error&) {
+			}
+
+			//例外を投げた場合は構築されず、次のアクセスで再試行する
+			Assert::IsFalse(lazy.has_value());
+			Assert::AreEqual(42, *lazy);
+			Assert::AreEqual(2, calls);
+		}
+
+		TEST_METHOD(concurrent_lazy_optional_test) {
+			std::atomic<int> calls{ 0 };
+			auto factory = [&calls] {
+				calls.fetch_add(1);
+				return std::vector<int>(1000, 7);
+			};
+
+			lstl::concurrent_lazy_optional<std::vector<int>, decltype(factory)> lazy{ factory };
+			Assert::IsFalse(lazy.has_value());
+
+			std::atomic<bool> start{ false };
+			std::atomic<int> ok{ 0 };
+			std::vector<std::thread> threads{};
+
+			for (int i = 0; i < 8; ++i) {
+				threads.emplace_back([&] {
+					while (!start.load()) {}
+
+					for (int n = 0; n < 1000; ++n) {
+						if (lazy->size() != 1000 || (*lazy)[999] != 7) return;
+					}
+					ok.fetch_add(1);
+				});
+			}
+
+			start.store(true);
+			for (auto& th : threads) th.join();
+
+			//構築は1度だけ
+			Assert::AreEqual(1, calls.load());
+			Assert::AreEqual(8, ok.load());
+			Assert::IsTrue(lazy.has_value());
+
+			auto moved = std::move(lazy);
+			Assert::IsTrue(moved.has_value());
+			Assert::AreEqual(std::size_t(1000), moved->size());
+			Assert::AreEqual(1, calls.load());
+		}
+	};
+}
\ No newline at end of file
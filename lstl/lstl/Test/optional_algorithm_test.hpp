@@ -0,0 +1,167 @@
+﻿#pragma once
+
+#include "common.h"
+
+#include "Include/optional_algorithm.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lstl::test::optional_algorithm
+{
+	/**
+	* @brief 無効値をpercent%含む、ランダムな値のoptionalの配列
+	*/
+	template<typename T>
+	std::vector<lstl::optional<T>> make_random(std::size_t n, unsigned percent, std::uint32_t seed) {
+		std::vector<lstl::optional<T>> v{};
+		for (std::size_t i = 0; i < n; ++i) {
+			seed = seed * 1664525u + 1013904223u;
+			if ((seed >> 8) % 100 < percent) {
+				v.emplace_back();
+			}
+			else {
+				v.emplace_back(static_cast<T>(static_cast<std::int32_t>(seed) >> 3));
+			}
+		}
+		return v;
+	}
+
+	TEST_CLASS(optional_algorithm_test)
+	{
+	public:
+
+		TEST_METHOD(partition_nullopt_test) {
+			std::vector<lstl::optional<std::string>> v = { "a", lstl::nullopt, "b", "c", lstl::nullopt, "d" };
+
+			//有効値の順序は保たれる
+			auto it = lstl::partition_nullopt(v.begin(), v.end());
+			Assert::IsTrue(it == v.begin() + 2);
+			Assert::IsFalse(v[0].has_value());
+			Assert::IsFalse(v[1].has_value());
+			Assert::IsTrue(v[2] == std::string("a"));
+			Assert::IsTrue(v[3] == std::string("b"));
+			Assert::IsTrue(v[4] == std::string("c"));
+			Assert::IsTrue(v[5] == std::string("d"));
+
+			it = lstl::partition_nullopt(v.begin(), v.end(), lstl::nullopt_position::back);
+			Assert::IsTrue(it == v.begin() + 4);
+			Assert::IsTrue(v[0] == std::string("a"));
+			Assert::IsTrue(v[3] == std::string("d"));
+			Assert::IsFalse(v[4].has_value());
+			Assert::IsFalse(v[5].has_value());
+
+			//全て無効値、全て有効値、空の範囲
+			std::vector<lstl::optional<int>> empty(3);
+			Assert::IsTrue(lstl::partition_nullopt(empty.begin(), empty.end()) == empty.end());
+
+			std::vector<lstl::optional<int>> full = { 3, 1, 2 };
+			Assert::IsTrue(lstl::partition_nullopt(full.begin(), full.end()) == full.begin());
+			Assert::IsTrue(lstl::partition_nullopt(full.begin(), full.end(), lstl::nullopt_position::back) == full.end());
+			Assert::AreEqual(3, *full[0]);
+
+			Assert::IsTrue(lstl::partition_nullopt(full.begin(), full.begin()) == full.begin());
+		}
+
+		TEST_METHOD(sort_optional_integral_test) {
+			//基数ソートを用いる大きさと、比較ソートを用いる大きさ
+			for (std::size_t n : { std::size_t(10), std::size_t(5000) }) {
+				for (unsigned percent : { 0u, 30u, 100u }) {
+					auto expected = make_random<int>(n, percent, 1);
+					auto actual = expected;
+
+					std::sort(expected.begin(), expected.end());
+					lstl::sort_optional(actual.begin(), actual.end());
+					Assert::IsTrue(expected == actual);
+
+					auto stable = make_random<int>(n, percent, 1);
+					lstl::stable_sort_optional(stable.begin(), stable.end());
+					Assert::IsTrue(expected == stable);
+				}
+			}
+
+			auto v = make_random<std::int64_t>(3000, 20, 7);
+			auto expected = v;
+			std::sort(expected.begin(), expected.end());
+			lstl::sort_optional(v.begin(), v.end());
+			Assert::IsTrue(expected == v);
+
+			//無効値を末尾に並べる
+			auto u = make_random<std::uint16_t>(3000, 20, 9);
+			lstl::sort_optional(u.begin(), u.end(), lstl::nullopt_position::back);
+			const auto boundary = std::find(u.begin(), u.end(), lstl::nullopt);
+			Assert::IsTrue(std::all_of(boundary, u.end(), [](const lstl::optional<std::uint16_t>& x) { return !x.has_value(); }));
+			Assert::IsTrue(std::is_sorted(u.begin(), boundary));
+		}
+
+		TEST_METHOD(sort_optional_floating_point_test) {
+			const double nan = std::numeric_limits<double>::quiet_NaN();
+			const double inf = std::numeric_limits<double>::infinity();
+
+			std::vector<lstl::optional<double>> v{};
+			for (int i = 0; i < 1000; ++i) {
+				v.emplace_back((i % 7 == 0) ? lstl::optional<double>{} : lstl::optional<double>{ (i * 37 % 101) - 50.5 });
+			}
+			v.emplace_back(nan);
+			v.emplace_back(inf);
+			v.emplace_back(-inf);
+			v.emplace_back(-0.0);
+			v.emplace_back(0.0);
+
+			lstl::sort_optional(v.begin(), v.end());
+
+			const auto first_value = std::find_if(v.begin(), v.end(), [](const lstl::optional<double>& x) { return x.has_value(); });
+			Assert::IsTrue(std::all_of(v.begin(), first_value, [](const lstl::optional<double>& x) { return !x.has_value(); }));
+
+			//NaNは最後
+			Assert::IsTrue(*v.back() != *v.back());
+			Assert::AreEqual(-inf, **first_value);
+			Assert::AreEqual(inf, *v[v.size() - 2]);
+			Assert::IsTrue(std::is_sorted(first_value, v.end() - 1));
+
+			//-0.0と+0.0は等しいので、安定ソートでは元の順序のまま
+			std::vector<lstl::optional<float>> zeros(300, lstl::optional<float>{ 1.0f });
+			zeros[100] = -0.0f;
+			zeros[200] = 0.0f;
+			lstl::stable_sort_optional(zeros.begin(), zeros.end());
+			Assert::IsTrue(std::signbit(*zeros[0]));
+			Assert::IsFalse(std::signbit(*zeros[1]));
+		}
+
+		TEST_METHOD(sort_optional_compare_test) {
+			using entry = std::pair<int, int>;
+			std::vector<lstl::optional<entry>> v{};
+			for (int i = 0; i < 400; ++i) {
+				if (i % 5 == 0) {
+					v.emplace_back();
+				}
+				else {
+					v.emplace_back(entry{ i % 3, i });
+				}
+			}
+
+			//firstの降順、等しい要素は元の順序（secondの昇順）
+			lstl::stable_sort_optional(v.begin(), v.end(), [](const entry& a, const entry& b) { return a.first > b.first; }, lstl::nullopt_position::back);
+
+			const auto boundary = std::find(v.begin(), v.end(), lstl::nullopt);
+			Assert::AreEqual(std::ptrdiff_t(320), boundary - v.begin());
+			for (auto it = v.begin(); it + 1 != boundary; ++it) {
+				const entry& a = **it;
+				const entry& b = **(it + 1);
+				Assert::IsTrue(a.first > b.first || (a.first == b.first && a.second < b.second));
+			}
+
+			std::vector<lstl::optional<std::string>> s = { "pear", lstl::nullopt, "apple", "fig" };
+			lstl::sort_optional(s.begin(), s.end());
+			Assert::IsFalse(s[0].has_value());
+			Assert::IsTrue(s[1] == std::string("apple"));
+			Assert::IsTrue(s[2] == std::string("fig"));
+			Assert::IsTrue(s[3] == std::string("pear"));
+		}
+	};
+}
\ No newline at end of file
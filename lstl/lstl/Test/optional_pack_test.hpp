@@ -0,0 +1,232 @@
+﻿#pragma once
+
+#include "common.h"
+
+#include "Include/optional_pack.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace lstl::test::optional_pack
+{
+	//optional<T>を並べた構造体
+	struct separate_fields {
+		lstl::optional<char> a;
+		lstl::optional<double> b;
+		lstl::optional<short> c;
+		lstl::optional<std::uint32_t> d;
+		lstl::optional<bool> e;
+		lstl::optional<std::uint64_t> f;
+	};
+
+	using packed_fields = lstl::optional_pack<char, double, short, std::uint32_t, bool, std::uint64_t>;
+
+	//値 8 + 8 + 4 + 2 + 1 + 1、マスク 1
+	static_assert(sizeof(packed_fields) == 32, "");
+	static_assert(sizeof(packed_fields) < sizeof(separate_fields), "");
+	static_assert(alignof(packed_fields) == alignof(double), "");
+
+	//特殊メンバ関数の性質はoptionalと同じ規則に従う
+	static_assert(std::is_trivially_copyable<packed_fields>::value, "");
+	static_assert(std::is_trivially_destructible<packed_fields>::value, "");
+	static_assert(!std::is_trivially_copyable<lstl::optional_pack<int, std::string>>::value, "");
+	static_assert(std::is_nothrow_move_constructible<lstl::optional_pack<int, std::string>>::value, "");
+	static_assert(!std::is_copy_constructible<lstl::optional_pack<int, std::unique_ptr<int>>>::value, "");
+	static_assert(std::is_move_assignable<lstl::optional_pack<int, std::unique_ptr<int>>>::value, "");
+
+	//ビットマスクはフィールドの数に応じた大きさ
+	static_assert(std::is_same<lstl::optional_pack<int>::mask_type, std::uint8_t>::value, "");
+	static_assert(std::is_same<lstl::optional_pack<int, int, int, int, int, int, int, int, int>::mask_type, std::uint16_t>::value, "");
+
+	//同じ型のフィールドをN個持つoptional_pack
+	template<std::size_t, typename T>
+	struct repeat {
+		using type = T;
+	};
+
+	template<typename T, std::size_t... I>
+	auto make_repeated_pack(std::index_sequence<I...>) -> lstl::optional_pack<typename repeat<I, T>::type...>;
+
+	template<typename T, std::size_t N>
+	using repeated_pack = decltype(make_repeated_pack<T>(std::make_index_sequence<N>{}));
+
+	//フィールド数の上限まで配置を定数式で求められる
+	static_assert(sizeof(repeated_pack<int, 40>) == sizeof(int) * 40 + sizeof(std::uint64_t), "");
+	static_assert(sizeof(repeated_pack<int, 64>) == sizeof(int) * 64 + sizeof(std::uint64_t), "");
+	static_assert(std::is_same<repeated_pack<int, 64>::mask_type, std::uint64_t>::value, "");
+
+	//コピー構築が例外を投げうる型
+	struct throw_on_copy {
+		int value;
+
+		explicit throw_on_copy(int v) : value{ v } {}
+		throw_on_copy(const throw_on_copy& other) : value{ other.value } {
+			if (value < 0) throw value;
+		}
+		throw_on_copy& operator=(const throw_on_copy&) = default;
+	};
+
+	TEST_CLASS(optional_pack_test)
+	{
+	public:
+
+		TEST_METHOD(optional_pack_access_test) {
+			packed_fields p{};
+
+			Assert::IsTrue(p.none());
+			Assert::IsFalse(p.any());
+			Assert::AreEqual(std::size_t(6), p.size());
+
+			p.emplace<1>(2.5);
+			p.emplace<3>(7u);
+
+			Assert::IsTrue(p.any());
+			Assert::IsFalse(p.all());
+			Assert::IsTrue(p.has_value<1>());
+			Assert::IsFalse(p.has_value<0>());
+			Assert::IsTrue((p.all_of<1, 3>()));
+			Assert::IsFalse((p.all_of<0, 1>()));
+			Assert::IsTrue((p.any_of<0, 3>()));
+			Assert::IsFalse((p.any_of<0, 2, 4>()));
+			Assert::IsTrue(std::uint8_t(0b1010) == p.mask());
+
+			Assert::AreEqual(2.5, *p.get<1>());
+			Assert::AreEqual(7u, p.value<3>());
+			Assert::IsFalse(lstl::get<0>(p).has_value());
+
+			//参照を通して書き換える
+			*lstl::get<1>(p) = 5.0;
+			Assert::AreEqual(5.0, p.value<1>());
+
+			const auto& cp = p;
+			Assert::AreEqual(5.0, *cp.get<1>());
+			Assert::IsFalse(cp.get<5>().has_value());
+
+			p.emplace<0>('a');
+			p.emplace<2>(short(3));
+			p.emplace<4>(true);
+			p.emplace<5>(std::uint64_t(9));
+			Assert::IsTrue(p.all());
+
+			//値が正しく配置されていること
+			Assert::AreEqual('a', p.value<0>());
+			Assert::AreEqual(5.0, p.value<1>());
+			Assert::AreEqual(short(3), p.value<2>());
+			Assert::AreEqual(7u, p.value<3>());
+			Assert::IsTrue(p.value<4>());
+			Assert::IsTrue(std::uint64_t(9) == p.value<5>());
+
+			p.reset<1>();
+			Assert::IsFalse(p.has_value<1>());
+			Assert::IsFalse(p.all());
+
+			try {
+				(void)p.value<1>();
+				Assert::Fail();
+			}
+			catch (const lstl::bad_optional_access&) {
+			}
+
+			p = lstl::nullopt;
+			Assert::IsTrue(p.none());
+		}
+
+		TEST_METHOD(optional_pack_many_fields_test) {
+			repeated_pack<int, 64> p{};
+			Assert::AreEqual(std::size_t(64), p.size());
+
+			p.emplace<0>(1);
+			p.emplace<40>(2);
+			p.emplace<63>(3);
+
+			Assert::IsTrue(((std::uint64_t(1) << 63) | (std::uint64_t(1) << 40) | std::uint64_t(1)) == p.mask());
+			Assert::IsTrue((p.all_of<0, 40, 63>()));
+			Assert::IsFalse(p.has_value<39>());
+
+			auto copy = p;
+			Assert::AreEqual(1, copy.value<0>());
+			Assert::AreEqual(2, copy.value<40>());
+			Assert::AreEqual(3, copy.value<63>());
+
+			copy.reset<40>();
+			Assert::IsFalse(copy.has_value<40>());
+			Assert::IsTrue(p.has_value<40>());
+		}
+
+		TEST_METHOD(optional_pack_copy_move_test) {
+			using pack = lstl::optional_pack<std::string, int, std::string>;
+
+			pack p{};
+			p.emplace<0>(40, 'x');
+			p.emplace<1>(3);
+
+			pack copy{ p };
+			Assert::IsTrue(std::string(40, 'x') == copy.value<0>());
+			Assert::AreEqual(3, copy.value<1>());
+			Assert::IsFalse(copy.has_value<2>());
+
+			pack moved{ std::move(copy) };
+			Assert::IsTrue(std::string(40, 'x') == moved.value<0>());
+			//ムーブ後も有無は変わらない
+			Assert::IsTrue(copy.has_value<0>());
+
+			moved.emplace<2>("abc");
+			p = moved;
+			Assert::IsTrue(p.all());
+			Assert::IsTrue("abc" == p.value<2>());
+
+			moved.reset<0>();
+			p = std::move(moved);
+			Assert::IsFalse(p.has_value<0>());
+			Assert::IsTrue("abc" == p.value<2>());
+
+			//swap
+			pack other{};
+			other.emplace<0>("other");
+
+			swap(p, other);
+			Assert::IsTrue((p.all_of<0>()));
+			Assert::IsFalse((p.any_of<1, 2>()));
+			Assert::IsTrue("other" == p.value<0>());
+			Assert::IsTrue((other.all_of<1, 2>()));
+			Assert::IsFalse(other.has_value<0>());
+		}
+
+		TEST_METHOD(optional_pack_exception_test) {
+			using pack = lstl::optional_pack<std::string, throw_on_copy>;
+
+			pack p{};
+			p.emplace<0>(40, 'x');
+			p.emplace<1>(-1);
+
+			//構築済みのフィールドはデストラクタで破棄される
+			try {
+				pack copy{ p };
+				Assert::Fail();
+			}
+			catch (int) {
+			}
+
+			//代入先は例外が投げられたフィールドのみ無効となる
+			pack q{};
+			try {
+				q = p;
+				Assert::Fail();
+			}
+			catch (int) {
+			}
+			Assert::IsTrue(q.has_value<0>());
+			Assert::IsFalse(q.has_value<1>());
+
+			//emplaceで例外が投げられた場合は無効となる
+			q.emplace<1>(2);
+			try {
+				q.emplace<1>(p.value<1>());
+				Assert::Fail();
+			}
+			catch (int) {
+			}
+			Assert::IsFalse(q.has_value<1>());
+		}
+	};
+}
\ No newline at end of file
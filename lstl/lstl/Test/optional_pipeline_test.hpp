@@ -0,0 +1,86 @@
+﻿#pragma once
+
+#include "common.h"
+
+#include "Include/optional_pipeline.hpp"
+
+#include <string>
+
+namespace lstl::test::optional_pipeline
+{
+	//ムーブとコピーの回数を数える
+	struct tracked {
+		std::string value;
+		int* moves;
+
+		tracked(std::string v, int* m) : value{ std::move(v) }, moves{ m } {}
+		tracked(const tracked& other) : value{ other.value }, moves{ other.moves } { ++*moves; }
+		tracked(tracked&& other) noexcept : value{ std::move(other.value) }, moves{ other.moves } { ++*moves; }
+	};
+
+	TEST_CLASS(optional_pipeline_test)
+	{
+	public:
+
+		TEST_METHOD(optional_pipeline_evaluate_test) {
+			const lstl::optional<int> n{ 20 };
+			const lstl::optional<int> empty{};
+
+			const auto half = [](int v) { return (v % 2 == 0) ? lstl::optional<int>{ v / 2 } : lstl::nullopt; };
+			const auto to_string = [](int v) { return std::to_string(v); };
+
+			lstl::optional<std::string> r = n | lstl::then(half) | lstl::then(half) | lstl::map(to_string);
+			Assert::IsTrue("5" == r.value());
+
+			//途中のthenが無効値を返す
+			lstl::optional<std::string> failed = n | lstl::then(half) | lstl::then(half) | lstl::then(half) | lstl::map(to_string);
+			Assert::IsFalse(failed.has_value());
+
+			//元が無効値であれば関数は呼ばれない
+			int calls = 0;
+			lstl::optional<int> none = empty | lstl::map([&calls](int v) { ++calls; return v; });
+			Assert::IsFalse(none.has_value());
+			Assert::AreEqual(0, calls);
+
+			//value_or終端
+			Assert::AreEqual(11, n | lstl::map([](int v) { return v / 2; }) | lstl::map([](int v) { return v + 1; }) | lstl::value_or(0));
+			Assert::AreEqual(-1, empty | lstl::map([](int v) { return v + 1; }) | lstl::value_or(-1));
+			Assert::AreEqual(-1, n | lstl::then([](int) { return lstl::optional<int>{}; }) | lstl::value_or(-1));
+			Assert::AreEqual(20, n | lstl::value_or(0));
+
+			//or_else終端
+			Assert::AreEqual(7, *(empty | lstl::map([](int v) { return v; }) | lstl::or_else([] { return lstl::optional<int>{ 7 }; })));
+			Assert::AreEqual(21, *(n | lstl::map([](int v) { return v + 1; }) | lstl::or_else([] { return lstl::optional<int>{ 7 }; })));
+			//最後の段がthenで無効値を返した場合もor_elseの関数が呼ばれる
+			Assert::AreEqual(42, *(n | lstl::then([](int) { return lstl::optional<int>{}; }) | lstl::or_else([] { return lstl::optional<int>{ 42 }; })));
+			Assert::AreEqual(5, *(n | lstl::then([](int) { return lstl::optional<int>{ 5 }; }) | lstl::or_else([] { return lstl::optional<int>{ 42 }; })));
+
+			//評価関数
+			Assert::AreEqual(40, *(n | lstl::map([](int v) { return v * 2; })).evaluate());
+		}
+
+		TEST_METHOD(optional_pipeline_no_move_test) {
+			int moves = 0;
+			const lstl::optional<int> n{ 1 };
+
+			//mapの戻り値は次の段へ一時オブジェクトのまま渡され、最後の戻り値は結果の領域に直接構築される
+			lstl::optional<tracked> r = n
+				| lstl::map([&moves](int v) { return tracked{ std::to_string(v), &moves }; })
+				| lstl::map([](tracked&& t) { return tracked{ t.value + "2", t.moves }; })
+				| lstl::then([](tracked&& t) { return lstl::optional<tracked>{ lstl::in_place, t.value + "3", t.moves }; })
+				| lstl::map([](tracked&& t) { return tracked{ t.value + "4", t.moves }; });
+
+			Assert::IsTrue("1234" == r->value);
+			Assert::AreEqual(0, moves);
+
+			//右辺値のoptionalからは値がムーブで渡される
+			lstl::optional<std::string> s = lstl::optional<std::string>{ "abc" } | lstl::map([](std::string&& str) { return std::move(str) + "d"; });
+			Assert::IsTrue("abcd" == *s);
+
+			//transformも結果を直接構築する
+			auto t = n.transform([&moves](int v) { return tracked{ std::to_string(v), &moves }; });
+			Assert::IsTrue("1" == t->value);
+			Assert::AreEqual(0, moves);
+		}
+	};
+}
\ No newline at end of file
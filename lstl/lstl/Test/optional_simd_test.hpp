@@ -0,0 +1,108 @@
+﻿#pragma once
+
+#include "common.h"
+
+#include "Include/optional_simd.hpp"
+
+namespace lstl::test::optional_simd
+{
+	TEST_CLASS(optional_simd_test)
+	{
+	public:
+
+		TEST_METHOD(bitmap_kernel_test) {
+			//SIMDの幅で割り切れない要素数
+			lstl::optional_vector<double> v{};
+			for (int i = 0; i < 131; ++i) {
+				if (i % 3 == 0) {
+					v.push_back(lstl::nullopt);
+				}
+				else {
+					v.push_back(double(i));
+				}
+			}
+
+			double expected_sum = 0.0;
+			for (int i = 0; i < 131; ++i) {
+				if (i % 3 != 0) expected_sum += i;
+			}
+
+			Assert::AreEqual(std::size_t(87), lstl::simd::count_present(v));
+			Assert::AreEqual(expected_sum, lstl::simd::sum_present(v));
+			Assert::AreEqual(1.0, *lstl::simd::min_present(v));
+			Assert::AreEqual(130.0, *lstl::simd::max_present(v));
+
+			//有効値を詰める
+			std::vector<double> dense(v.size());
+			const std::size_t count = lstl::simd::compress(v, dense.data());
+
+			Assert::AreEqual(std::size_t(87), count);
+			Assert::AreEqual(1.0, dense[0]);
+			Assert::AreEqual(2.0, dense[1]);
+			Assert::AreEqual(4.0, dense[2]);
+			Assert::AreEqual(130.0, dense[86]);
+
+			//展開して元に戻す
+			std::vector<double> expanded(v.size());
+			Assert::AreEqual(count, lstl::simd::expand(dense.data(), v.bitmap(), v.size(), expanded.data(), -1.0));
+
+			for (std::size_t i = 0; i < v.size(); ++i) {
+				Assert::AreEqual(v.get(i).value_or(-1.0), expanded[i]);
+			}
+
+			//無効値を埋める
+			lstl::simd::fill_empty(v.data(), v.bitmap(), v.size(), -1.0);
+
+			for (std::size_t i = 0; i < v.size(); ++i) {
+				Assert::AreEqual(expanded[i], v.data()[i]);
+			}
+		}
+
+		TEST_METHOD(bitmap_kernel_integer_test) {
+			lstl::optional_vector<std::int32_t> i32{ -5, lstl::nullopt, 7, 3, lstl::nullopt, 100, -20, 1, 2 };
+			lstl::optional_vector<std::int64_t> i64{ -5, lstl::nullopt, 7, 3, lstl::nullopt, 100, -20, 1, 2 };
+			lstl::optional_vector<std::uint8_t> u8{ 5, lstl::nullopt, 7 };
+			lstl::optional_vector<float> empty(10, lstl::nullopt);
+
+			Assert::AreEqual(88, lstl::simd::sum_present(i32));
+			Assert::AreEqual(-20, *lstl::simd::min_present(i32));
+			Assert::AreEqual(100, *lstl::simd::max_present(i32));
+
+			Assert::IsTrue(std::int64_t(88) == lstl::simd::sum_present(i64));
+			Assert::IsTrue(std::int64_t(-20) == *lstl::simd::min_present(i64));
+			Assert::IsTrue(std::int64_t(100) == *lstl::simd::max_present(i64));
+
+			//SIMD実装の無い型はスカラ処理
+			Assert::IsTrue(std::uint8_t(12) == lstl::simd::sum_present(u8));
+			Assert::IsTrue(std::uint8_t(5) == *lstl::simd::min_present(u8));
+
+			//有効値が無い
+			Assert::AreEqual(0.0f, lstl::simd::sum_present(empty));
+			Assert::IsFalse(lstl::simd::min_present(empty).has_value());
+			Assert::IsFalse(lstl::simd::max_present(empty).has_value());
+		}
+
+		TEST_METHOD(optional_span_kernel_test) {
+			const lstl::optional<int> src[] = { 3, lstl::nullopt, -1, 8, lstl::nullopt };
+			const std::size_t n = 5;
+
+			Assert::AreEqual(std::size_t(3), lstl::simd::count_present(src, n));
+			Assert::AreEqual(10, lstl::simd::sum_present(src, n));
+			Assert::AreEqual(-1, *lstl::simd::min_present(src, n));
+			Assert::AreEqual(8, *lstl::simd::max_present(src, n));
+			Assert::IsFalse(lstl::simd::min_present(src + 4, 1).has_value());
+
+			int out[5] = {};
+
+			lstl::simd::value_or(src, n, 0, out);
+			Assert::AreEqual(3, out[0]);
+			Assert::AreEqual(0, out[1]);
+			Assert::AreEqual(0, out[4]);
+
+			Assert::AreEqual(std::size_t(3), lstl::simd::compress(src, n, out));
+			Assert::AreEqual(3, out[0]);
+			Assert::AreEqual(-1, out[1]);
+			Assert::AreEqual(8, out[2]);
+		}
+	};
+}
\ No newline at end of file
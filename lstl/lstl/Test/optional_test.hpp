@@ -4,6 +4,193 @@
 
 #include "Include/optional.hpp"
 
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace lstl::test::optional
+{
+	//無効値を宣言するテスト用の型
+	enum class slot_index : std::uint32_t {};
+
+	struct node {};
+
+	//trivially copyableであることを検査するための型
+	struct pod {
+		int i;
+		double d;
+	};
+
+	struct user_constructor {
+		user_constructor(int x) : v{ x } {}
+		int v;
+	};
+
+	struct deleted_copy_assign {
+		deleted_copy_assign(const deleted_copy_assign&) = default;
+		deleted_copy_assign(deleted_copy_assign&&) = default;
+		deleted_copy_assign& operator=(const deleted_copy_assign&) = delete;
+		deleted_copy_assign& operator=(deleted_copy_assign&&) = default;
+		int v;
+	};
+
+	struct user_destructor {
+		~user_destructor() {}
+	};
+
+	struct user_copy {
+		user_copy() = default;
+		user_copy(const user_copy&) {}
+	};
+
+	//コピーとムーブの回数を数える
+	template<bool NothrowMove>
+	struct copy_counter {
+		int* copies;
+
+		explicit copy_counter(int* c) : copies{ c } {}
+		copy_counter(const copy_counter& other) : copies{ other.copies } { ++*copies; }
+		copy_counter(copy_counter&& other) noexcept(NothrowMove) : copies{ other.copies } {}
+		copy_counter& operator=(const copy_counter& other) { copies = other.copies; ++*copies; return *this; }
+		copy_counter& operator=(copy_counter&& other) noexcept(NothrowMove) { copies = other.copies; return *this; }
+	};
+
+	//コピーとムーブの合計回数を数える
+	struct move_counter {
+		int value;
+		int* moves;
+
+		move_counter(int v, int* m) : value{ v }, moves{ m } {}
+		move_counter(const move_counter& other) : value{ other.value }, moves{ other.moves } { ++*moves; }
+		move_counter(move_counter&& other) noexcept : value{ other.value }, moves{ other.moves } { ++*moves; }
+	};
+}
+
+namespace lstl {
+
+	template<>
+	struct invalid_value_traits<test::optional::slot_index> : invalid_value_constant<test::optional::slot_index, test::optional::slot_index(0xFFFFFFFF)> {};
+
+	template<>
+	struct invalid_value_traits<test::optional::node*> : invalid_value_nullptr<test::optional::node*> {};
+}
+
+namespace lstl::test::optional
+{
+	/**
+	* @brief Tとoptional<T>のtrivially copyable性が一致するかを調べる
+	* @detail trivially copyableなTではコピー/ムーブ/デストラクタがすべてtrivialであること（SysV ABIでレジスタ渡しとなる条件）も調べる
+	*/
+	template<typename T, typename O = lstl::optional<T>>
+	constexpr bool same_triviality = std::is_trivially_copyable<T>::value
+		? std::conjunction<
+			std::is_trivially_copyable<O>,
+			std::is_trivially_copy_constructible<O>,
+			std::is_trivially_move_constructible<O>,
+			std::is_trivially_destructible<O>
+		>::value
+		: !std::is_trivially_copyable<O>::value;
+
+	static_assert(same_triviality<bool>, "");
+	static_assert(same_triviality<char>, "");
+	static_assert(same_triviality<int>, "");
+	static_assert(same_triviality<unsigned long long>, "");
+	static_assert(same_triviality<float>, "");
+	static_assert(same_triviality<double>, "");
+	static_assert(same_triviality<long double>, "");
+	static_assert(same_triviality<const int>, "");
+	static_assert(same_triviality<int*>, "");
+	static_assert(same_triviality<const char*>, "");
+	static_assert(same_triviality<int pod::*>, "");
+	static_assert(same_triviality<void(*)()>, "");
+	static_assert(same_triviality<std::nullptr_t>, "");
+	static_assert(same_triviality<slot_index>, "");
+	static_assert(same_triviality<node>, "");
+	static_assert(same_triviality<node*>, "");
+	static_assert(same_triviality<pod>, "");
+	static_assert(same_triviality<user_constructor>, "");
+	static_assert(same_triviality<deleted_copy_assign>, "");
+	static_assert(same_triviality<lstl::optional<int>>, "");
+	static_assert(same_triviality<lstl::optional<double>>, "");
+	static_assert(same_triviality<user_destructor>, "");
+	static_assert(same_triviality<user_copy>, "");
+	static_assert(same_triviality<std::pair<int, int>>, "");
+	static_assert(same_triviality<std::string>, "");
+	static_assert(same_triviality<std::vector<int>>, "");
+	static_assert(same_triviality<lstl::optional<std::string>>, "");
+	//参照のoptionalは参照先の型によらずtrivially copyable
+	static_assert(same_triviality<int*, lstl::optional<int&>>, "");
+	static_assert(same_triviality<std::string*, lstl::optional<std::string&>>, "");
+
+	//constな型を保持するoptionalは、trivially copyableであっても代入できない（std::optionalと同じ）
+	static_assert(!std::is_copy_assignable<lstl::optional<const int>>::value, "");
+	static_assert(!std::is_move_assignable<lstl::optional<const int>>::value, "");
+	static_assert(std::is_trivially_copy_constructible<lstl::optional<const int>>::value, "");
+	static_assert(!std::is_copy_assignable<lstl::optional<const pod>>::value, "");
+
+	//レジスタ1つ、あるいは2つに収まる大きさであること
+	static_assert(sizeof(lstl::optional<int>) <= 8, "");
+	static_assert(sizeof(lstl::optional<double>) <= 16, "");
+	static_assert(sizeof(lstl::optional<slot_index>) == sizeof(slot_index), "");
+}
+
+#if LSTL_HAS_CONSTEXPR20
+
+namespace lstl::test::optional
+{
+	//C++20以降では、非トリビアルなデストラクタを持つ型のoptionalも定数式中で利用できる
+
+	struct constexpr_resource {
+		int value;
+		int* destroyed;
+
+		constexpr constexpr_resource(int v, int* d) : value{ v }, destroyed{ d } {}
+		constexpr constexpr_resource(const constexpr_resource& other) : value{ other.value }, destroyed{ other.destroyed } {}
+		constexpr constexpr_resource& operator=(const constexpr_resource& other) { value = other.value; return *this; }
+		constexpr ~constexpr_resource() { ++*destroyed; }
+	};
+
+	static_assert(!std::is_trivially_destructible<lstl::optional<constexpr_resource>>::value, "");
+
+	constexpr int constexpr_lifetime() {
+		int destroyed = 0;
+		{
+			lstl::optional<constexpr_resource> a{};
+			a.emplace(1, &destroyed);
+			a.emplace(2, &destroyed);
+			lstl::optional<constexpr_resource> b{ a };
+			b = lstl::optional<constexpr_resource>{ lstl::in_place, 3, &destroyed };
+			a.reset();
+			a.emplace_with([&] { return constexpr_resource{ 4, &destroyed }; });
+			swap(a, b);
+			if (a->value != 3 || b->value != 4) return -1;
+		}
+		//emplace2回、一時オブジェクト2つ、reset、スコープ終了時の2つ
+		return destroyed;
+	}
+
+	static_assert(constexpr_lifetime() == 7, "");
+
+#if defined(__cpp_lib_constexpr_string)
+
+	constexpr std::size_t constexpr_string() {
+		lstl::optional<std::string> s{ "a string that does not fit in SSO" };
+		s.emplace(std::string(40, 'x'));
+		auto t = s;
+		return std::move(t).transform([](std::string&& str) { return str.size(); }).value_or(0) + s->size();
+	}
+
+	static_assert(constexpr_string() == 80, "");
+
+#endif // defined(__cpp_lib_constexpr_string)
+}
+
+#endif // LSTL_HAS_CONSTEXPR20
+
 namespace lstl::test::optional
 {
 	TEST_CLASS(optional_test)
@@ -275,6 +462,46 @@ namespace lstl::test::optional
 			}
 		}
 
+		TEST_METHOD(optional_emplace_with_test) {
+			int moves = 0;
+			auto make = [&moves](int v) { return move_counter{ v, &moves }; };
+
+			//関数の戻り値から直接構築する
+			{
+				lstl::optional<move_counter> p{ lstl::in_place_invoke, make, 1 };
+
+				Assert::IsTrue(p.has_value());
+				Assert::AreEqual(1, p->value);
+
+				Assert::AreEqual(2, p.emplace_with(make, 2).value);
+				Assert::AreEqual(2, p->value);
+
+				Assert::AreEqual(0, moves);
+			}
+
+			//transformとor_elseも戻り値から直接構築する
+			{
+				const lstl::optional<int> n{ 3 };
+				const lstl::optional<int> empty{};
+
+				auto t = n.transform(make);
+				Assert::AreEqual(3, t->value);
+
+				lstl::optional<move_counter> e{};
+				auto o = std::move(e).or_else([&make] { return make(4); });
+				Assert::AreEqual(4, o->value);
+
+				Assert::AreEqual(0, moves);
+
+				//voidを返す関数、optionalを返す関数
+				bool called = false;
+				Assert::IsFalse(empty.or_else([&called] { called = true; }).has_value());
+				Assert::IsTrue(called);
+				Assert::AreEqual(5, *empty.or_else([] { return lstl::optional<int>{ 5 }; }));
+				Assert::AreEqual(3, *n.or_else([] { return 5; }));
+			}
+		}
+
 		TEST_METHOD(optional_swap_test) {
 			//1. 両方とも有効値を持つ場合
 			{
@@ -395,6 +622,266 @@ namespace lstl::test::optional
 				Assert::AreEqual("Bad optional access", exception.what());
 			}
 
+			//検査しないアクセス
+			Assert::AreEqual(10, hasvalue.value_unchecked());
+
+			lstl::optional<std::string> str{ "unchecked" };
+			std::string moved = std::move(str).value_unchecked();
+			Assert::IsTrue("unchecked" == moved);
+
+			int n = 5;
+			lstl::optional<int&> ref{ n };
+			ref.value_unchecked() = 6;
+			Assert::AreEqual(6, n);
+		}
+
+		TEST_METHOD(optional_invalid_value_test) {
+			//有効値フラグを持たない
+			Assert::IsTrue(sizeof(lstl::optional<slot_index>) == sizeof(slot_index));
+			Assert::IsTrue(sizeof(lstl::optional<node*>) == sizeof(node*));
+			Assert::IsTrue(std::is_trivially_copyable<lstl::optional<slot_index>>::value);
+
+			{
+				constexpr lstl::optional<slot_index> empty{};
+				Assert::IsFalse(empty.has_value());
+
+				lstl::optional<slot_index> n{ slot_index(10) };
+				Assert::IsTrue(n.has_value());
+				Assert::IsTrue(slot_index(10) == *n);
+
+				n.reset();
+				Assert::IsFalse(n.has_value());
+
+				n.emplace(slot_index(3));
+				Assert::IsTrue(n.has_value());
+				Assert::IsTrue(slot_index(3) == *n);
+
+				lstl::optional<slot_index> m{};
+				lstl::swap(n, m);
+				Assert::IsFalse(n.has_value());
+				Assert::IsTrue(slot_index(3) == *m);
+
+				m = lstl::nullopt;
+				Assert::IsFalse(m.has_value());
+			}
+
+			{
+				node nd{};
+				lstl::optional<node*> p{ &nd };
+				lstl::optional<node*> q{ p };
+
+				Assert::IsTrue(q.has_value());
+				Assert::IsTrue(&nd == *q);
+
+				q = lstl::nullopt;
+				Assert::IsFalse(q.has_value());
+				Assert::IsTrue(nullptr == q.value_or(nullptr));
+			}
+
+			//NaNを無効値とする実装
+			Assert::IsTrue(lstl::invalid_value_nan<double>::is_invalid(lstl::invalid_value_nan<double>::invalid_value()));
+			Assert::IsFalse(lstl::invalid_value_nan<double>::is_invalid(0.0));
+		}
+
+		TEST_METHOD(optional_reference_test) {
+			//ポインタ1つ分のサイズで、trivially copyable
+			Assert::IsTrue(sizeof(lstl::optional<int&>) == sizeof(int*));
+			Assert::IsTrue(std::is_trivially_copyable<lstl::optional<int&>>::value);
+			Assert::IsFalse(std::is_constructible<lstl::optional<const int&>, int&&>::value);
+
+			int a = 10;
+			int b = 20;
+
+			{
+				lstl::optional<int&> r{};
+				Assert::IsFalse(r.has_value());
+
+				r = a;
+				Assert::IsTrue(r.has_value());
+				Assert::IsTrue(&a == &*r);
+
+				//参照先への書き込み
+				*r = 11;
+				Assert::AreEqual(11, a);
+
+				//再束縛、参照先の値は変わらない
+				r = b;
+				Assert::IsTrue(&b == &r.value());
+				Assert::AreEqual(11, a);
+				Assert::AreEqual(20, b);
+
+				r.reset();
+				Assert::IsFalse(bool(r));
+
+				try {
+					r.value();
+					Assert::Fail();
+				}
+				catch (const lstl::bad_optional_access&) {
+				}
+			}
+
+			{
+				lstl::optional<int&> r{ a };
+				lstl::optional<const int&> cr = r;
+				Assert::IsTrue(&a == &*cr);
+
+				lstl::optional<int&> empty{};
+
+				Assert::AreEqual(11, r.value_or(0));
+				Assert::AreEqual(0, empty.value_or(0));
+
+				//モナド的操作
+				auto twice = r.transform([](int& v) { return v * 2; });
+				Assert::AreEqual(22, *twice);
+				Assert::IsFalse(empty.transform([](int& v) { return v * 2; }).has_value());
+
+				auto chained = r.and_then([](int& v) { return lstl::optional<int>{ v + 1 }; });
+				Assert::AreEqual(12, *chained);
+
+				auto fallback = empty.or_else([&b]() { return lstl::optional<int&>{ b }; });
+				Assert::IsTrue(&b == &*fallback);
+
+				lstl::swap(r, empty);
+				Assert::IsFalse(r.has_value());
+				Assert::IsTrue(&a == &*empty);
+
+				//比較は参照先の値で行われる
+				lstl::optional<int&> rb{ b };
+				Assert::IsTrue(empty < rb);
+				Assert::IsTrue(empty == 11);
+			}
+		}
+
+		TEST_METHOD(optional_hash_test) {
+			std::hash<lstl::optional<int>> hasher{};
+
+			const lstl::optional<int> empty{};
+
+			//有効値のハッシュはstd::hash<T>と同じ（無効値と衝突する場合を除く）
+			Assert::IsTrue(std::hash<int>{}(10) == hasher(lstl::optional<int>{ 10 }));
+			Assert::IsTrue(hasher(empty) == hasher(lstl::optional<int>{}));
+
+			//無効値のハッシュは有効値のハッシュと異なる
+			const int colliding = static_cast<int>(hasher(empty));
+			if (std::hash<int>{}(colliding) == hasher(empty)) {
+				Assert::IsTrue(hasher(empty) != hasher(lstl::optional<int>{ colliding }));
+			}
+
+			//ハッシュ不可能な型のoptionalはハッシュ不可能
+			Assert::IsFalse(std::is_default_constructible<std::hash<lstl::optional<node>>>::value);
+
+			//非順序連想コンテナのキーにできる
+			std::unordered_map<lstl::optional<std::string>, int> map{};
+			map[lstl::nullopt] = 1;
+			map[std::string("key")] = 2;
+
+			Assert::AreEqual(1, map[lstl::nullopt]);
+			Assert::AreEqual(2, map[std::string("key")]);
+
+			//範囲の一括ハッシュ
+			lstl::optional<int> src[] = { 1, lstl::nullopt, 3 };
+			std::size_t out[3] = {};
+
+			lstl::hash_range(std::begin(src), std::end(src), out);
+
+			for (int i = 0; i < 3; ++i) {
+				Assert::IsTrue(hasher(src[i]) == out[i]);
+			}
+
+			//連続した範囲は分岐しない経路、結果は同じ
+			static_assert(lstl::detail::is_trivial_optional_array<const lstl::optional<int>*>::value, "");
+			static_assert(!lstl::detail::is_trivial_optional_array<lstl::optional<std::string>*>::value, "");
+
+			const std::vector<lstl::optional<int>> vec = { lstl::nullopt, 0, -1, lstl::nullopt, 42 };
+			std::size_t vec_out[5] = {};
+
+			lstl::hash_range(vec.data(), vec.data() + vec.size(), vec_out);
+
+			for (std::size_t i = 0; i < vec.size(); ++i) {
+				Assert::IsTrue(hasher(vec[i]) == vec_out[i]);
+			}
+
+			const lstl::optional<std::string> strs[] = { std::string("a"), lstl::nullopt };
+			std::size_t str_out[2] = {};
+
+			lstl::hash_range(std::begin(strs), std::end(strs), str_out);
+
+			Assert::IsTrue(std::hash<lstl::optional<std::string>>{}(strs[0]) == str_out[0]);
+			Assert::IsTrue(std::hash<lstl::optional<std::string>>{}(strs[1]) == str_out[1]);
+		}
+
+		TEST_METHOD(optional_trivially_copyable_test) {
+			//trivially copyableなのでmemcpyでコピーできる
+			const lstl::optional<int> src[] = { 1, lstl::nullopt, 3 };
+			lstl::optional<int> dst[3] = {};
+
+			std::memcpy(dst, src, sizeof(src));
+
+			Assert::AreEqual(1, *dst[0]);
+			Assert::IsFalse(dst[1].has_value());
+			Assert::AreEqual(3, *dst[2]);
+
+			const lstl::optional<double> d{ 2.5 };
+			lstl::optional<double> e{};
+
+			std::memcpy(&e, &d, sizeof(d));
+
+			Assert::AreEqual(2.5, e.value());
+		}
+
+		TEST_METHOD(optional_noexcept_test) {
+			//特殊メンバ関数のnoexceptはTに従う
+			static_assert(std::is_nothrow_move_constructible<lstl::optional<std::string>>::value, "");
+			static_assert(std::is_nothrow_move_assignable<lstl::optional<std::string>>::value, "");
+			static_assert(!std::is_nothrow_copy_constructible<lstl::optional<std::string>>::value, "");
+			static_assert(std::is_nothrow_move_constructible<lstl::optional<std::vector<int>>>::value, "");
+			static_assert(std::is_nothrow_copy_constructible<lstl::optional<int>>::value, "");
+			static_assert(std::is_nothrow_move_constructible<lstl::optional<copy_counter<true>>>::value, "");
+			static_assert(!std::is_nothrow_move_constructible<lstl::optional<copy_counter<false>>>::value, "");
+			static_assert(!std::is_nothrow_move_assignable<lstl::optional<copy_counter<false>>>::value, "");
+
+			//std::vectorの再確保時、ムーブがnoexceptならばムーブされる
+			{
+				int copies = 0;
+				std::vector<lstl::optional<copy_counter<true>>> v{};
+
+				for (int i = 0; i < 1000; ++i) {
+					v.emplace_back(lstl::in_place, &copies);
+				}
+				v.emplace_back();
+
+				Assert::AreEqual(0, copies);
+				Assert::IsFalse(v.back().has_value());
+			}
+
+			//そうでなければコピーされる
+			{
+				int copies = 0;
+				std::vector<lstl::optional<copy_counter<false>>> v{};
+
+				for (int i = 0; i < 1000; ++i) {
+					v.emplace_back(lstl::in_place, &copies);
+				}
+
+				Assert::IsTrue(0 < copies);
+			}
+		}
+
+		TEST_METHOD(optional_transform_test) {
+			lstl::optional<std::string> str{ "transform" };
+			const lstl::optional<std::string> empty{};
+
+			//戻り値はoptionalで包まれる
+			auto len = str.transform([](const std::string& s) { return s.size(); });
+			static_assert(std::is_same<decltype(len), lstl::optional<std::size_t>>::value, "");
+			Assert::IsTrue(9 == *len);
+
+			Assert::IsFalse(empty.transform([](const std::string& s) { return s.size(); }).has_value());
+
+			//右辺値からは値がムーブで渡される
+			auto moved = std::move(str).transform([](std::string&& s) { return std::move(s) + "ed"; });
+			Assert::IsTrue("transformed" == *moved);
 		}
 
 		TEST_METHOD(optional_relational_operators_test) {
@@ -605,5 +1092,89 @@ namespace lstl::test::optional
 			Assert::IsTrue(z >= -1);
 			Assert::IsFalse(-1 >= z);
 		}
+
+		TEST_METHOD(optional_order_key_test) {
+			//無効値はどの値よりも小さい
+			constexpr lstl::optional<int> imin = (std::numeric_limits<int>::min)();
+			constexpr lstl::optional<int> imax = (std::numeric_limits<int>::max)();
+			constexpr lstl::optional<int> inull{};
+
+			static_assert(lstl::order_key(inull) == 0, "");
+			static_assert(lstl::order_key(inull) < lstl::order_key(imin), "");
+			static_assert(lstl::order_key(imin) < lstl::order_key(imax), "");
+			static_assert(lstl::order_key_less{}(inull, imin), "");
+			static_assert(!lstl::order_key_less{}(inull, inull), "");
+
+			constexpr lstl::optional<unsigned int> umax = (std::numeric_limits<unsigned int>::max)();
+			constexpr lstl::optional<unsigned int> uzero = 0u;
+			constexpr lstl::optional<unsigned int> unull{};
+
+			static_assert(lstl::order_key(unull) < lstl::order_key(uzero), "");
+			static_assert(lstl::order_key(uzero) < lstl::order_key(umax), "");
+
+			//有効値を保持していたoptionalをリセットしても、キーは無効値のもの
+			lstl::optional<int> reset = 42;
+			reset.reset();
+			Assert::IsTrue(lstl::order_key(reset) == lstl::order_key(inull));
+			reset = -7;
+			reset = lstl::nullopt;
+			Assert::IsTrue(lstl::order_key(reset) == 0);
+
+			//順序キーによる比較は通常の比較と一致する
+			const std::vector<lstl::optional<short>> values = {
+				lstl::nullopt, short(-32768), short(-1), short(0), short(1), short(32767)
+			};
+			for (const auto& a : values) {
+				for (const auto& b : values) {
+					Assert::AreEqual(a < b, lstl::order_key_less{}(a, b));
+					Assert::AreEqual(a == b, lstl::order_key(a) == lstl::order_key(b));
+				}
+			}
+
+			static_assert(lstl::order_key(lstl::optional<bool>{ false }) < lstl::order_key(lstl::optional<bool>{ true }), "");
+			static_assert(lstl::order_key(lstl::optional<char>{}) < lstl::order_key(lstl::optional<char>{ char(-128) }), "");
+		}
+
+#if LSTL_HAS_THREE_WAY_COMPARISON
+
+		TEST_METHOD(optional_three_way_comparison_test) {
+			constexpr lstl::optional<int> n = -1;
+			constexpr lstl::optional<int> p = 1;
+			constexpr lstl::optional<int> inull{};
+
+			static_assert((n <=> p) == std::strong_ordering::less, "");
+			static_assert((p <=> n) == std::strong_ordering::greater, "");
+			static_assert((inull <=> n) == std::strong_ordering::less, "");
+			static_assert((inull <=> inull) == std::strong_ordering::equal, "");
+			static_assert((inull <=> lstl::nullopt) == std::strong_ordering::equal, "");
+			static_assert((p <=> lstl::nullopt) == std::strong_ordering::greater, "");
+			static_assert((inull <=> 0) == std::strong_ordering::less, "");
+			static_assert((p <=> 1) == std::strong_ordering::equal, "");
+			static_assert((0 <=> p) == std::strong_ordering::less, "");
+
+			constexpr lstl::optional<long long> ll = 5;
+			constexpr lstl::optional<long long> llnull{};
+
+			static_assert((llnull <=> ll) == std::strong_ordering::less, "");
+			static_assert((llnull <=> llnull) == std::strong_ordering::equal, "");
+			static_assert((ll <=> 5LL) == std::strong_ordering::equal, "");
+
+			const lstl::optional<double> nan = std::numeric_limits<double>::quiet_NaN();
+			const lstl::optional<double> dnull{};
+
+			Assert::IsTrue((nan <=> nan) == std::partial_ordering::unordered);
+			Assert::IsTrue((dnull <=> nan) == std::partial_ordering::less);
+			Assert::IsTrue((dnull <=> 0.0) == std::partial_ordering::less);
+
+			const lstl::optional<std::string> a = std::string("a");
+			const lstl::optional<std::string> b = std::string("b");
+			const lstl::optional<std::string> snull{};
+
+			Assert::IsTrue((a <=> b) == std::strong_ordering::less);
+			Assert::IsTrue((snull <=> a) == std::strong_ordering::less);
+			Assert::IsTrue((b <=> std::string("b")) == std::strong_ordering::equal);
+		}
+
+#endif // LSTL_HAS_THREE_WAY_COMPARISON
 	};
 }
\ No newline at end of file
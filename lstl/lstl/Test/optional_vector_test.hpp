@@ -0,0 +1,283 @@
+﻿#pragma once
+
+#include "common.h"
+
+#include "Include/optional_vector.hpp"
+
+#include <string>
+
+namespace lstl::test::optional_vector
+{
+	TEST_CLASS(optional_vector_test)
+	{
+	public:
+
+		TEST_METHOD(optional_vector_push_test) {
+			lstl::optional_vector<double> v{};
+
+			Assert::IsTrue(v.empty());
+
+			v.push_back(1.0);
+			v.push_back(lstl::nullopt);
+			v.push_back(lstl::optional<double>{ 3.0 });
+			v.push_back(lstl::optional<double>{});
+			v.emplace_back(5.0);
+
+			Assert::AreEqual(std::size_t(5), v.size());
+			Assert::AreEqual(std::size_t(3), v.count());
+
+			Assert::IsTrue(v.has_value(0));
+			Assert::IsFalse(v.has_value(1));
+			Assert::IsTrue(v.has_value(2));
+			Assert::IsFalse(v.has_value(3));
+			Assert::IsTrue(v.has_value(4));
+
+			Assert::AreEqual(1.0, *v[0]);
+			Assert::IsFalse(v[1].has_value());
+			Assert::AreEqual(3.0, v.get(2).value());
+			Assert::IsFalse(v.get(3).has_value());
+
+			//trivialな型の無効値の領域はT{}で埋められる
+			Assert::AreEqual(0.0, v.data()[1]);
+
+			//参照を通しての書き換え
+			*v[4] = 6.0;
+			Assert::AreEqual(6.0, *v[4]);
+
+			try {
+				v.at(5);
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&) {
+			}
+		}
+
+		TEST_METHOD(optional_vector_bulk_test) {
+			lstl::optional_vector<int> v{};
+
+			//ワード境界をまたぐ
+			v.append(100, lstl::nullopt);
+			Assert::AreEqual(std::size_t(100), v.size());
+			Assert::AreEqual(std::size_t(0), v.count());
+
+			lstl::optional<int> src[] = { 1, lstl::nullopt, 3 };
+			v.append(std::begin(src), std::end(src));
+
+			Assert::AreEqual(std::size_t(103), v.size());
+			Assert::AreEqual(std::size_t(2), v.count());
+			Assert::AreEqual(1, *v[100]);
+			Assert::IsFalse(v[101].has_value());
+			Assert::AreEqual(3, *v[102]);
+
+			v.emplace(64, 64);
+			v.emplace(10, 10);
+			Assert::AreEqual(std::size_t(4), v.count());
+
+			//有効値のみを昇順に走査
+			std::vector<std::size_t> indices{};
+			int sum = 0;
+			v.for_each_value([&](std::size_t i, int& value) {
+				indices.push_back(i);
+				sum += value;
+			});
+
+			Assert::IsTrue((std::vector<std::size_t>{ 10, 64, 100, 102 }) == indices);
+			Assert::AreEqual(78, sum);
+
+			v.reset(64);
+			Assert::AreEqual(std::size_t(3), v.count());
+			Assert::IsFalse(v.has_value(64));
+		}
+
+		TEST_METHOD(optional_vector_erase_test) {
+			lstl::optional_vector<std::string> v{ std::string("a"), lstl::nullopt, std::string("c"), std::string("d"), lstl::nullopt };
+
+			Assert::AreEqual(std::size_t(5), v.size());
+
+			v.erase(1);
+
+			Assert::AreEqual(std::size_t(4), v.size());
+			Assert::IsTrue("a" == *v[0]);
+			Assert::IsTrue("c" == *v[1]);
+			Assert::IsTrue("d" == *v[2]);
+			Assert::IsFalse(v.has_value(3));
+
+			v.erase(0, 2);
+
+			Assert::AreEqual(std::size_t(2), v.size());
+			Assert::IsTrue("d" == *v[0]);
+			Assert::IsFalse(v.has_value(1));
+			Assert::AreEqual(std::size_t(1), v.count());
+
+			v.pop_back();
+			Assert::AreEqual(std::size_t(1), v.size());
+		}
+
+		TEST_METHOD(optional_vector_hash_test) {
+			lstl::optional_vector<int> v{ 1, lstl::nullopt, 3, lstl::nullopt };
+			lstl::optional_vector<std::string> str{ std::string("a"), lstl::nullopt };
+
+			std::size_t out[4] = {};
+
+			//std::hash<optional<T>>と同じ値
+			lstl::hash_range(v, out);
+			for (std::size_t i = 0; i < v.size(); ++i) {
+				Assert::IsTrue(std::hash<lstl::optional<int>>{}(v.get(i)) == out[i]);
+			}
+
+			lstl::hash_range(str, out);
+			for (std::size_t i = 0; i < str.size(); ++i) {
+				Assert::IsTrue(std::hash<lstl::optional<std::string>>{}(str.get(i)) == out[i]);
+			}
+		}
+
+		TEST_METHOD(optional_vector_copy_move_test) {
+			lstl::optional_vector<std::string> v{};
+
+			for (int i = 0; i < 200; ++i) {
+				if (i % 3 == 0) {
+					v.push_back(lstl::nullopt);
+				}
+				else {
+					v.push_back(std::to_string(i));
+				}
+			}
+
+			lstl::optional_vector<std::string> copy{ v };
+
+			Assert::AreEqual(v.size(), copy.size());
+			Assert::AreEqual(v.count(), copy.count());
+			Assert::IsTrue("199" == *copy[199]);
+			Assert::IsFalse(copy.has_value(198));
+
+			lstl::optional_vector<std::string> moved{ std::move(copy) };
+
+			Assert::AreEqual(std::size_t(200), moved.size());
+			Assert::AreEqual(std::size_t(0), copy.size());
+
+			copy = moved;
+			Assert::AreEqual(std::size_t(200), copy.size());
+
+			moved.clear();
+			Assert::IsTrue(moved.empty());
+			Assert::AreEqual(std::size_t(0), moved.count());
+		}
+
+		TEST_METHOD(optional_vector_self_insertion_test) {
+			lstl::optional_vector<std::string> v{};
+			v.push_back(std::string(100, 'a'));
+
+			while (v.size() < v.capacity()) {
+				v.push_back(lstl::nullopt);
+			}
+
+			//領域の拡張を伴う自身の要素の追加
+			const std::size_t capacity = v.capacity();
+			v.push_back(*v[0]);
+
+			Assert::IsTrue(capacity < v.capacity());
+			Assert::IsTrue(std::string(100, 'a') == *v[0]);
+			Assert::IsTrue(std::string(100, 'a') == *v[v.size() - 1]);
+		}
+
+		/**
+		* @brief 生存数を数え、指定回数目のコピーで例外を投げる型（ムーブはnoexceptでないので、再配置はコピーで行われる）
+		*/
+		struct throwing_copy {
+			static int& live() {
+				static int n = 0;
+				return n;
+			}
+
+			static int& copies_until_throw() {
+				static int n = -1;
+				return n;
+			}
+
+			int value;
+
+			explicit throwing_copy(int v) : value{ v } { ++live(); }
+
+			throwing_copy(const throwing_copy& other) : value{ other.value } {
+				if (copies_until_throw() == 0) throw std::exception{};
+				--copies_until_throw();
+				++live();
+			}
+
+			throwing_copy& operator=(const throwing_copy&) = default;
+
+			~throwing_copy() { --live(); }
+		};
+
+		TEST_METHOD(optional_vector_reallocate_exception_test) {
+			{
+				lstl::optional_vector<throwing_copy> v{};
+
+				for (int i = 0; i < 64; ++i) {
+					if (i % 2 == 0) {
+						v.emplace_back(i);
+					}
+					else {
+						v.push_back(lstl::nullopt);
+					}
+				}
+				Assert::AreEqual(std::size_t(64), v.capacity());
+				Assert::AreEqual(32, throwing_copy::live());
+
+				//既存の要素の再配置の途中で失敗しても、列は変更されない
+				throwing_copy::copies_until_throw() = 10;
+				try {
+					v.emplace_back(64);
+					Assert::Fail();
+				}
+				catch (const std::exception&) {
+				}
+
+				Assert::AreEqual(std::size_t(64), v.size());
+				Assert::AreEqual(std::size_t(64), v.capacity());
+				Assert::AreEqual(32, throwing_copy::live());
+				Assert::AreEqual(62, (*v[62]).value);
+
+				try {
+					v.reserve(1000);
+					Assert::Fail();
+				}
+				catch (const std::exception&) {
+				}
+
+				Assert::AreEqual(std::size_t(64), v.capacity());
+				Assert::AreEqual(32, throwing_copy::live());
+
+				throwing_copy::copies_until_throw() = -1;
+				v.emplace_back(64);
+				Assert::AreEqual(33, throwing_copy::live());
+				Assert::AreEqual(0, (*v[0]).value);
+			}
+
+			Assert::AreEqual(0, throwing_copy::live());
+		}
+
+		/**
+		* @brief デフォルト構築できない型
+		*/
+		struct no_default {
+			int value;
+
+			explicit no_default(int v) : value{ v } {}
+		};
+
+		TEST_METHOD(optional_vector_no_default_constructor_test) {
+			lstl::optional_vector<no_default> v{};
+
+			for (int i = 0; i < 100; ++i) {
+				v.emplace_back(i);
+			}
+			v.push_back(lstl::nullopt);
+			v.erase(0);
+
+			Assert::AreEqual(std::size_t(100), v.size());
+			Assert::AreEqual(1, (*v[0]).value);
+			Assert::IsFalse(v.has_value(99));
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,169 @@
+﻿#pragma once
+
+#include "common.h"
+
+#include "Include/optional.hpp"
+#include "Include/optional_vector.hpp"
+#include "Include/relocate.hpp"
+
+#include <string>
+
+namespace lstl::test::relocate
+{
+	//ヒープ上の値を所有する、ムーブと破棄を数える型
+	struct handle {
+		int* value;
+		int* moves;
+
+		handle(int v, int* m) : value{ new int(v) }, moves{ m } {}
+		handle(handle&& other) noexcept : value{ other.value }, moves{ other.moves } {
+			other.value = nullptr;
+			++*moves;
+		}
+		handle& operator=(handle&& other) noexcept {
+			std::swap(value, other.value);
+			moves = other.moves;
+			++*moves;
+			return *this;
+		}
+		~handle() {
+			delete value;
+		}
+	};
+}
+
+namespace lstl {
+
+	template<>
+	struct is_trivially_relocatable<test::relocate::handle> : std::true_type {};
+}
+
+namespace lstl::test::relocate
+{
+	static_assert(lstl::is_trivially_relocatable<int>::value, "");
+	static_assert(lstl::is_trivially_relocatable<handle>::value, "");
+	static_assert(lstl::is_trivially_relocatable<const handle>::value, "");
+	static_assert(!lstl::is_trivially_relocatable<std::string>::value, "");
+	static_assert(lstl::is_trivially_relocatable<lstl::optional<int>>::value, "");
+	static_assert(lstl::is_trivially_relocatable<lstl::optional<handle>>::value, "");
+	static_assert(lstl::is_trivially_relocatable<lstl::optional<std::string&>>::value, "");
+	static_assert(!lstl::is_trivially_relocatable<lstl::optional<std::string>>::value, "");
+
+	TEST_CLASS(relocate_test)
+	{
+	public:
+
+		TEST_METHOD(relocate_at_test) {
+			int moves = 0;
+
+			alignas(handle) unsigned char src_buf[sizeof(handle)];
+			alignas(handle) unsigned char dst_buf[sizeof(handle)];
+
+			handle* src = ::new(static_cast<void*>(src_buf)) handle{ 10, &moves };
+			handle* dst = lstl::relocate_at(src, reinterpret_cast<handle*>(dst_buf));
+
+			//ムーブコンストラクタは呼ばれない
+			Assert::AreEqual(0, moves);
+			Assert::AreEqual(10, *dst->value);
+
+			dst->~handle();
+
+			//trivially relocatableでない型はムーブ構築と破棄
+			alignas(std::string) unsigned char str_src[sizeof(std::string)];
+			alignas(std::string) unsigned char str_dst[sizeof(std::string)];
+
+			std::string* s = ::new(static_cast<void*>(str_src)) std::string(32, 'a');
+			std::string* d = lstl::relocate_at(s, reinterpret_cast<std::string*>(str_dst));
+
+			Assert::IsTrue(std::string(32, 'a') == *d);
+
+			d->~basic_string();
+		}
+
+		TEST_METHOD(uninitialized_relocate_test) {
+			using opt = lstl::optional<handle>;
+			int moves = 0;
+
+			alignas(opt) unsigned char src_buf[sizeof(opt) * 3];
+			alignas(opt) unsigned char dst_buf[sizeof(opt) * 3];
+
+			opt* src = reinterpret_cast<opt*>(src_buf);
+			::new(static_cast<void*>(src + 0)) opt{ lstl::in_place, 1, &moves };
+			::new(static_cast<void*>(src + 1)) opt{};
+			::new(static_cast<void*>(src + 2)) opt{ lstl::in_place, 3, &moves };
+
+			opt* dst = reinterpret_cast<opt*>(dst_buf);
+			opt* end = lstl::uninitialized_relocate(src, src + 3, dst);
+
+			Assert::IsTrue(dst + 3 == end);
+			Assert::AreEqual(0, moves);
+			Assert::AreEqual(1, *dst[0]->value);
+			Assert::IsFalse(dst[1].has_value());
+			Assert::AreEqual(3, *dst[2]->value);
+
+			//先頭を破棄し、重なった領域で前方へ詰める
+			dst[0].~opt();
+			opt* shifted = lstl::uninitialized_relocate(dst + 1, dst + 3, dst + 0);
+
+			Assert::IsTrue(dst + 2 == shifted);
+			Assert::IsFalse(dst[0].has_value());
+			Assert::AreEqual(3, *dst[1]->value);
+
+			for (opt* p = dst; p != shifted; ++p) {
+				p->~opt();
+			}
+		}
+
+		TEST_METHOD(relocate_swap_test) {
+			int moves = 0;
+
+			lstl::optional<handle> a{ lstl::in_place, 1, &moves };
+			lstl::optional<handle> b{};
+
+			//片方のみが有効値を持つ場合、バイト列の入れ替えになる
+			a.swap(b);
+
+			Assert::AreEqual(0, moves);
+			Assert::IsFalse(a.has_value());
+			Assert::AreEqual(1, *b->value);
+
+			lstl::swap(a, b);
+
+			Assert::AreEqual(0, moves);
+			Assert::AreEqual(1, *a->value);
+			Assert::IsFalse(b.has_value());
+
+			//両方が有効値を持つ場合はTのswap
+			b.emplace(2, &moves);
+			a.swap(b);
+
+			Assert::AreEqual(2, *a->value);
+			Assert::AreEqual(1, *b->value);
+		}
+
+		TEST_METHOD(relocate_optional_vector_test) {
+			int moves = 0;
+			lstl::optional_vector<handle> v{};
+
+			for (int i = 0; i < 200; ++i) {
+				if (i % 3 == 0) {
+					v.push_back(lstl::nullopt);
+				}
+				else {
+					v.emplace_back(i, &moves);
+				}
+			}
+
+			//再確保と削除による詰め直しでムーブが起こらない
+			moves = 0;
+			v.reserve(1000);
+			v.erase(0, 10);
+
+			Assert::AreEqual(0, moves);
+			Assert::AreEqual(std::size_t(190), v.size());
+			Assert::AreEqual(10, *v[0]->value);
+			Assert::IsFalse(v.has_value(2));
+			Assert::AreEqual(199, *v[189]->value);
+		}
+	};
+}
\ No newline at end of file
@@ -4,6 +4,11 @@
 
 #include "Include/scope.hpp"
 
+#include <string>
+#include <thread>
+#include <memory>
+#include <vector>
+
 namespace lstl::test::scope
 {
 	TEST_CLASS(scope_test)
@@ -173,5 +178,386 @@ namespace lstl::test::scope
 			catch (...) {
 			}
 		}
+
+		/**
+		* @brief 例外による巻き戻し中に構築されたガード
+		* @detail 巻き戻し中のデストラクタの中で完結するスコープでは、新たな例外が投げられなければ成功とみなす
+		*/
+		struct guard_in_destructor {
+			int* n;
+
+			~guard_in_destructor() {
+				auto&& f = [this]() { *n += 1; };
+				auto&& s = [this]() { *n += 10; };
+
+				lstl::scope_fail<std::remove_reference_t<decltype(f)>> fail{ f };
+				lstl::scope_success<std::remove_reference_t<decltype(s)>> success{ s };
+			}
+		};
+
+		TEST_METHOD(uncaught_exceptions_test)
+		{
+			int n = 0;
+
+			try {
+				guard_in_destructor g{ &n };
+
+				throw std::exception{};
+			}
+			catch (...) {
+			}
+
+			//scope_successのみ実行済
+			Assert::AreEqual(10, n);
+
+			//例外の数は（キャッシュされる情報も）スレッドごと
+			std::thread th{ [&n]() {
+				auto&& f = [&n]() { n += 100; };
+				auto&& s = [&n]() { n += 1000; };
+
+				try {
+					lstl::scope_fail<std::remove_reference_t<decltype(f)>> fail{ f };
+					lstl::scope_success<std::remove_reference_t<decltype(s)>> success{ s };
+
+					throw std::exception{};
+				}
+				catch (...) {
+				}
+			} };
+			th.join();
+
+			//scope_failのみ実行済
+			Assert::AreEqual(110, n);
+
+			auto&& f = [&n]() { n += 1; };
+			auto&& s = [&n]() { n += 10; };
+
+			{
+				lstl::scope_fail<std::remove_reference_t<decltype(f)>> fail{ f };
+				lstl::scope_success<std::remove_reference_t<decltype(s)>> success{ s };
+			}
+
+			//scope_successのみ実行済
+			Assert::AreEqual(120, n);
+		}
+
+		static void add(int& n, int v) {
+			n += v;
+		}
+
+		static void append(std::string s, const std::string& r, int* size) {
+			*size += static_cast<int>(s.size() + r.size());
+		}
+
+		struct empty {};
+
+		//ムーブが例外を投げうる型
+		struct throwing_move {
+			throwing_move() = default;
+			throwing_move(const throwing_move&) = default;
+			throwing_move(throwing_move&&) noexcept(false) {}
+		};
+
+		TEST_METHOD(bind_test)
+		{
+			int n = 0;
+
+			//非constな左辺値参照の引数は参照として束縛
+			{
+				lstl::scope_exit<void(*)(int&, int)> test_scope_exit{ &add, n, 10 };
+
+				//未実行
+				Assert::AreEqual(0, n);
+			}
+
+			//実行済
+			Assert::AreEqual(10, n);
+
+			//ムーブ先でのみ実行
+			{
+				lstl::scope_success<void(*)(std::string, const std::string&, int*)> test_scope_exit{ &append, std::string(32, 'a'), std::string("bc"), &n };
+				auto moved = std::move(test_scope_exit);
+			}
+
+			Assert::AreEqual(44, n);
+
+			try {
+				lstl::scope_fail<void(*)(int&, int)> test_scope_exit{ add, n, 100 };
+
+				throw std::exception{};
+			}
+			catch (...) {
+			}
+
+			Assert::AreEqual(144, n);
+
+			//関数ポインタと引数を保持するラムダ式より大きくならない
+			using funcptr = void(*)(int&, int);
+			auto&& f = [p = funcptr{ &add }, &n, v = 1]() { p(n, v); };
+			static_assert(sizeof(lstl::scope_exit<funcptr>) <= sizeof(lstl::scope_exit<std::remove_reference_t<decltype(f)>>), "");
+
+			//空の引数は領域を取らない
+			static_assert(sizeof(lstl::scope_exit<void(*)(empty, int*)>) == sizeof(lstl::scope_exit<void(*)(int*)>), "");
+
+			//ムーブコンストラクタのnoexceptは束縛した引数のムーブにも従う
+			static_assert(std::is_nothrow_move_constructible<lstl::scope_exit<void(*)(int*)>>::value, "");
+			static_assert(!std::is_nothrow_move_constructible<lstl::scope_exit<void(*)(throwing_move)>>::value, "");
+		}
+	};
+
+	/**
+	* @brief 閉じた記述子を記録する削除子
+	*/
+	struct close_fd {
+		static std::vector<int>& closed() {
+			static std::vector<int> v{};
+			return v;
+		}
+
+		void operator()(int fd) const noexcept {
+			closed().push_back(fd);
+		}
+	};
+
+	/**
+	* @brief コピーに失敗する削除子
+	*/
+	struct throwing_deleter {
+		int* count;
+
+		throwing_deleter(int* c) noexcept : count{ c } {}
+		throwing_deleter(const throwing_deleter&) { throw std::exception{}; }
+
+		void operator()(int) const noexcept {
+			++*count;
+		}
+	};
+
+	using fd = lstl::unique_resource<int, close_fd, lstl::invalid_value_constant<int, -1>>;
+
+	TEST_CLASS(unique_resource_test)
+	{
+	public:
+		TEST_METHOD(size_test)
+		{
+			//無効値を宣言し、削除子が空ならば資源のみ
+			static_assert(sizeof(fd) == sizeof(int), "");
+
+			//無効値の宣言が無ければ所有状態を持つ
+			static_assert(sizeof(lstl::unique_resource<int, close_fd>) == 2 * sizeof(int), "");
+			static_assert(sizeof(lstl::unique_resource<int*, void(*)(int*), lstl::invalid_value_nullptr<int*>>) == 2 * sizeof(void*), "");
+		}
+
+		TEST_METHOD(ownership_test)
+		{
+			close_fd::closed().clear();
+
+			{
+				fd a{ 3, close_fd{} };
+				Assert::AreEqual(3, a.get());
+
+				//ムーブ元は所有しない
+				fd b{ std::move(a) };
+				Assert::AreEqual(-1, a.get());
+				Assert::AreEqual(3, b.get());
+
+				//ムーブ代入先の資源は削除される
+				fd c{ 4, close_fd{} };
+				c = std::move(b);
+				Assert::AreEqual(3, c.get());
+				Assert::AreEqual(std::size_t(1), close_fd::closed().size());
+				Assert::AreEqual(4, close_fd::closed()[0]);
+
+				c.reset(5);
+				Assert::AreEqual(3, close_fd::closed()[1]);
+
+				//所有を放棄すると削除されず、無効値となる
+				fd d{ 6, close_fd{} };
+				d.release();
+				Assert::AreEqual(-1, d.get());
+
+				//無効値は所有しない
+				fd e{ -1, close_fd{} };
+				fd f{};
+			}
+
+			Assert::AreEqual(std::size_t(3), close_fd::closed().size());
+			Assert::AreEqual(5, close_fd::closed()[2]);
+
+			//無効値の宣言が無ければ、release()の後も資源を保持する
+			lstl::unique_resource<int, close_fd> g{ 7, close_fd{} };
+			g.release();
+			Assert::AreEqual(7, g.get());
+		}
+
+		TEST_METHOD(pointer_and_reference_test)
+		{
+			int n = 0;
+
+			{
+				lstl::unique_resource<int*, void(*)(int*)> p{ &n, [](int* ptr) { *ptr += 10; } };
+				*p = 1;
+				Assert::AreEqual(&n, p.operator->());
+			}
+
+			Assert::AreEqual(11, n);
+
+			{
+				auto&& f = [](int& r) { r += 100; };
+				lstl::unique_resource<int&, std::remove_reference_t<decltype(f)>> r{ n, f };
+				Assert::AreEqual(&n, &r.get());
+			}
+
+			Assert::AreEqual(111, n);
+		}
+
+		TEST_METHOD(make_unique_resource_checked_test)
+		{
+			close_fd::closed().clear();
+
+			{
+				auto a = lstl::make_unique_resource_checked(-1, -1, close_fd{});
+				auto b = lstl::make_unique_resource_checked(8, -1, close_fd{});
+
+				auto c = lstl::make_unique_resource_checked<lstl::invalid_value_constant<int, -1>>(-1, -1, close_fd{});
+				static_assert(std::is_same<decltype(c), fd>::value, "");
+			}
+
+			Assert::AreEqual(std::size_t(1), close_fd::closed().size());
+			Assert::AreEqual(8, close_fd::closed()[0]);
+		}
+
+		TEST_METHOD(exception_safety_test)
+		{
+			int count = 0;
+			throwing_deleter d{ &count };
+
+			//削除子のコピーに失敗した場合は、資源を削除してから再送出
+			try {
+				lstl::unique_resource<int, throwing_deleter> r{ 1, d };
+				Assert::Fail();
+			}
+			catch (const std::exception&) {
+			}
+
+			Assert::AreEqual(1, count);
+		}
+	};
+	TEST_CLASS(scope_stack_test)
+	{
+	public:
+		static void record(std::vector<int>* log, int v) {
+			log->push_back(v);
+		}
+
+		TEST_METHOD(order_test)
+		{
+			std::vector<int> log{};
+
+			{
+				lstl::scope_stack<lstl::policy::exit> stack{};
+
+				for (int i = 0; i < 3; ++i) {
+					stack.push([&log, i]() { log.push_back(i); });
+				}
+				//関数ポインタと束縛する引数
+				stack.push(&record, &log, 10);
+
+				Assert::AreEqual(std::size_t(4), stack.size());
+				Assert::IsTrue(log.empty());
+			}
+
+			//登録と逆順に実行
+			Assert::IsTrue((std::vector<int>{ 10, 2, 1, 0 }) == log);
+		}
+
+		TEST_METHOD(policy_test)
+		{
+			std::vector<int> log{};
+
+			//例外が投げられなければ実行されない
+			{
+				lstl::scope_stack<> stack{};
+				stack.push(&record, &log, 1);
+			}
+
+			Assert::IsTrue(log.empty());
+
+			//例外によってスコープを抜けると実行、例外を投げる関数は無視して残りを実行
+			try {
+				lstl::scope_stack<> stack{};
+				stack.push(&record, &log, 1);
+				stack.push([]() { throw std::exception{}; });
+				stack.push(&record, &log, 2);
+
+				throw std::exception{};
+			}
+			catch (...) {
+			}
+
+			Assert::IsTrue((std::vector<int>{ 2, 1 }) == log);
+		}
+
+		TEST_METHOD(release_test)
+		{
+			std::vector<int> log{};
+			auto shared = std::make_shared<int>(0);
+
+			{
+				lstl::scope_stack<lstl::policy::exit> stack{};
+				stack.push([shared]() { Assert::Fail(); });
+				stack.push(&record, &log, 1);
+
+				//全て取り除き、関数オブジェクトは破棄する
+				stack.release();
+				Assert::IsTrue(stack.empty());
+				Assert::AreEqual(1L, shared.use_count());
+
+				//以降に登録したものは実行される
+				stack.push(&record, &log, 2);
+			}
+
+			Assert::IsTrue((std::vector<int>{ 2 }) == log);
+		}
+
+		TEST_METHOD(spill_test)
+		{
+			std::vector<int> log{};
+			auto shared = std::make_shared<int>(0);
+
+			//内部のバッファに収まらない分は動的に確保する
+			{
+				lstl::scope_stack<lstl::policy::exit, 64> stack{};
+
+				for (int i = 0; i < 100; ++i) {
+					stack.push([&log, shared, i, s = std::string(40, 'a')]() { log.push_back(i); });
+				}
+
+				Assert::AreEqual(101L, shared.use_count());
+			}
+
+			Assert::AreEqual(std::size_t(100), log.size());
+			Assert::AreEqual(99, log.front());
+			Assert::AreEqual(0, log.back());
+			Assert::AreEqual(1L, shared.use_count());
+
+			//BufferSizeが0ならば内部のバッファの領域を取らない
+			static_assert(sizeof(lstl::scope_stack<lstl::policy::succes, 0>) + 16 <= sizeof(lstl::scope_stack<lstl::policy::succes, 16>), "");
+
+			//与えられた領域を用いる
+			log.clear();
+			alignas(std::max_align_t) unsigned char arena[256];
+
+			{
+				lstl::scope_stack<lstl::policy::succes, 0> stack{ arena, sizeof(arena) };
+
+				for (int i = 0; i < 20; ++i) {
+					stack.push(&record, &log, i);
+				}
+			}
+
+			Assert::AreEqual(std::size_t(20), log.size());
+			Assert::AreEqual(19, log.front());
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+﻿#pragma once
+
+#include "common.h"
+
+#include "Include/seqlock_optional.hpp"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace lstl::test::seqlock_optional
+{
+	//大きなtrivially copyableな値
+	struct snapshot {
+		std::uint64_t fields[32];
+	};
+
+	inline snapshot make_snapshot(std::uint64_t n) {
+		snapshot s;
+		for (auto& f : s.fields) f = n;
+		return s;
+	}
+
+	TEST_CLASS(seqlock_optional_test)
+	{
+	public:
+
+		TEST_METHOD(seqlock_optional_operation_test) {
+			lstl::seqlock_optional<snapshot> cell{};
+
+			//未公開
+			std::uint64_t version = 99;
+			Assert::IsFalse(cell.load(version).has_value());
+			Assert::IsTrue(0 == version);
+
+			cell.publish(make_snapshot(1));
+			Assert::IsTrue(1 == cell.version());
+
+			auto v = cell.load(version);
+			Assert::IsTrue(v.has_value());
+			Assert::IsTrue(1 == v->fields[0]);
+			Assert::IsTrue(1 == v->fields[31]);
+			Assert::IsTrue(1 == version);
+
+			cell.publish(make_snapshot(2));
+			Assert::IsTrue(2 == cell.load()->fields[17]);
+
+			cell.reset();
+			Assert::IsFalse(cell.load(version).has_value());
+			Assert::IsTrue(3 == version);
+
+			lstl::seqlock_optional<int> small{};
+			small.publish(7);
+			Assert::AreEqual(7, *small.load());
+		}
+
+		TEST_METHOD(seqlock_optional_concurrent_test) {
+			lstl::seqlock_optional<snapshot> cell{};
+			std::atomic<bool> done{ false };
+			std::atomic<int> torn{ 0 };
+			std::atomic<int> backwards{ 0 };
+
+			std::vector<std::thread> readers{};
+			for (int r = 0; r < 4; ++r) {
+				readers.emplace_back([&] {
+					std::uint64_t last_version = 0;
+					std::uint64_t last_value = 0;
+
+					while (!done.load()) {
+						std::uint64_t version;
+						const auto v = cell.load(version);
+						if (!v) continue;
+
+						//全てのフィールドが同じ書き込みによるものであること
+						for (auto f : v->fields) {
+							if (f != v->fields[0]) torn.fetch_add(1);
+						}
+
+						//版と値は単調に増加する
+						if (version < last_version || v->fields[0] < last_value) backwards.fetch_add(1);
+						last_version = version;
+						last_value = v->fields[0];
+					}
+				});
+			}
+
+			for (std::uint64_t n = 1; n <= 20000; ++n) {
+				cell.publish(make_snapshot(n));
+			}
+			done.store(true);
+
+			for (auto& th : readers) th.join();
+
+			Assert::AreEqual(0, torn.load());
+			Assert::AreEqual(0, backwards.load());
+			Assert::IsTrue(20000 == cell.load()->fields[5]);
+		}
+	};
+}
\ No newline at end of file
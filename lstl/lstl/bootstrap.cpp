@@ -1,4 +1,14 @@
 ﻿#include "stdafx.h"
 
 #include "Test/scope_test.hpp"
-#include "Test/optional_test.hpp"
\ No newline at end of file
+#include "Test/optional_test.hpp"
+#include "Test/optional_vector_test.hpp"
+#include "Test/optional_simd_test.hpp"
+#include "Test/relocate_test.hpp"
+#include "Test/lazy_optional_test.hpp"
+#include "Test/atomic_optional_test.hpp"
+#include "Test/seqlock_optional_test.hpp"
+#include "Test/optional_pipeline_test.hpp"
+#include "Test/expected_test.hpp"
+#include "Test/optional_pack_test.hpp"
+#include "Test/optional_algorithm_test.hpp"
\ No newline at end of file